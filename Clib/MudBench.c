@@ -0,0 +1,148 @@
+#include "include/mud.h"
+#include <stdio.h>
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <time.h>
+#endif
+
+//
+// Microbenchmarks of the clib's call paths, run with the path to the commons-math3 jar as the first argument
+//
+
+static uint64_t bench_now_ns(void) {
+#ifdef _WIN32
+  LARGE_INTEGER freq, now;
+  QueryPerformanceFrequency(&freq);
+  QueryPerformanceCounter(&now);
+  return (uint64_t) ((double) now.QuadPart * 1e9 / (double) freq.QuadPart);
+#else
+  struct timespec now;
+  clock_gettime(CLOCK_MONOTONIC, &now);
+  return (uint64_t) now.tv_sec * 1000000000ull + (uint64_t) now.tv_nsec;
+#endif
+}
+
+static void bench_report(const char* name, long iters, uint64_t elapsed) {
+  printf("%-40s %12ld ops %12.1f ns/op\n", name, iters, (double) elapsed / (double) iters);
+}
+
+// runs the body a tenth of the iterations to warm up the JIT before timing it
+#define BENCH(name, iters, body) do { \
+  for (long bench_i = 0; bench_i < (iters) / 10 + 1; bench_i++) { body; } \
+  uint64_t bench_start = bench_now_ns(); \
+  for (long bench_i = 0; bench_i < (iters); bench_i++) { body; } \
+  bench_report(name, iters, bench_now_ns() - bench_start); \
+} while (0)
+
+static void bench_calls(JNIEnv* env) {
+  const long iters = 1000000;
+  jclass threadCls = mud_get_class(env, "java/lang/Thread");
+  jmethodID interrupted = mud_get_static_method(env, threadCls, "interrupted", "()Z");
+  BENCH("static call, no args", iters, mud_call_static_method(env, threadCls, interrupted, Java_Bool, null));
+
+  jclass intCls = mud_get_class(env, "java/lang/Integer");
+  jvalue intArg = {.i = 7};
+  jobject integer = mud_new_object(env, intCls, "(I)V", &intArg);
+  jmethodID intValue = mud_get_method(env, intCls, "intValue", "()I");
+  BENCH("instance call, 0 args", iters, mud_call_method(env, integer, intValue, Java_Int, null));
+
+  jstring str = mud_string_new(env, "hello");
+  jclass strCls = mud_get_class(env, "java/lang/String");
+  jmethodID charAt = mud_get_method(env, strCls, "charAt", "(I)C");
+  jvalue charAtArg = {.i = 1};
+  BENCH("instance call, 1 arg", iters, mud_call_method(env, str, charAt, Java_Char, &charAtArg));
+
+  jclass rectCls = mud_get_class(env, "java/awt/Rectangle");
+  jobject rect = mud_new_object(env, rectCls, "()V", null);
+  jmethodID setBounds = mud_get_method(env, rectCls, "setBounds", "(IIII)V");
+  jvalue boundsArgs[4] = {{.i = 1}, {.i = 2}, {.i = 3}, {.i = 4}};
+  BENCH("instance call, 4 args", iters, mud_call_method(env, rect, setBounds, Java_Void, boundsArgs));
+
+  struct Mud_Batch_Call_S batch[100];
+  struct JavaCallResp_S results[100];
+  for (int i = 0; i < 100; i++) {
+    batch[i] = (struct Mud_Batch_Call_S) {.obj_or_cls = rect, .method = setBounds, .type = Java_Void, .is_static = false, .arg_offset = 0};
+  }
+  BENCH("instance call, 4 args, batches of 100", iters / 100, mud_call_batch(env, batch, 100, boundsArgs, results));
+
+  jclass pointCls = mud_get_class(env, "java/awt/Point");
+  jobject point = mud_new_object(env, pointCls, "()V", null);
+  jfieldID x = mud_get_field_id(env, pointCls, "x", "I");
+  jvalue xVal = {.i = 5};
+  BENCH("field get", iters, mud_get_field_value(env, point, x, Java_Int));
+  BENCH("field set", iters, mud_set_field_value(env, point, x, Java_Int, xVal));
+
+  jclass objCls = mud_get_class(env, "java/lang/Object");
+  BENCH("new object", iters, mud_release_object(env, mud_new_object(env, objCls, "()V", null)));
+
+  jmethodID parseInt = mud_get_static_method(env, intCls, "parseInt", "(Ljava/lang/String;)I");
+  jvalue badNumber = {.l = mud_string_new(env, "nope")};
+  BENCH("exception throw/catch", iters / 100,
+        mud_release_object(env, mud_call_static_method(env, intCls, parseInt, Java_Int, &badNumber).value.l));
+
+  jclass statsCls = mud_get_class(env, "org/apache/commons/math3/stat/descriptive/DescriptiveStatistics");
+  if (statsCls) {
+    jobject stats = mud_new_object(env, statsCls, "()V", null);
+    jmethodID addValue = mud_get_method(env, statsCls, "addValue", "(D)V");
+    jvalue value = {.d = 42};
+    BENCH("commons-math addValue", iters, mud_call_method(env, stats, addValue, Java_Void, &value));
+  } else {
+    mud_release_object(env, mud_jvm_check_exception(env));
+    printf("commons-math3 not on the class path, skipping\n");
+  }
+}
+
+static void bench_strings(JNIEnv* env) {
+  const jsize sizes[] = {16, 256, 4096, 65536};
+  for (size_t s = 0; s < sizeof(sizes) / sizeof(sizes[0]); s++) {
+    jsize size = sizes[s];
+    jchar* chars = malloc(sizeof(jchar) * size);
+    for (jsize i = 0; i < size; i++) {
+      chars[i] = (jchar) ('a' + i % 26);
+    }
+    char name[64];
+    snprintf(name, sizeof(name), "string round trip, %d chars", size);
+    BENCH(name, 100000, {
+      jstring str = mud_string_new_utf16(env, chars, size);
+      mud_string_copy_utf16(env, str, chars, size);
+      mud_release_object(env, str);
+    });
+    free(chars);
+  }
+}
+
+static void bench_arrays(JNIEnv* env) {
+  const size_t sizes[] = {100, 10000, 1000000};
+  for (size_t s = 0; s < sizeof(sizes) / sizeof(sizes[0]); s++) {
+    size_t size = sizes[s];
+    jdouble* values = calloc(size, sizeof(jdouble));
+    char name[64];
+    snprintf(name, sizeof(name), "double array round trip, %zu elements", size);
+    BENCH(name, (long) (10000000 / size), {
+      jarray arr = mud_array_new_primitive(env, size, values, Java_Double);
+      mud_array_get_region(env, arr, 0, size, values, Java_Double);
+      mud_release_object(env, arr);
+    });
+    free(values);
+  }
+}
+
+int main(int argc, char **argv) {
+  char classPath[4096];
+  snprintf(classPath, sizeof(classPath), "-Djava.class.path=%s", argc > 1 ? argv[1] : "commons-math3.jar");
+  JavaVMOption* options = mud_jvm_options_va(1, classPath);
+  Java_JVM_Instance jvm = mud_jvm_create_instance(options, 1);
+
+  bench_calls(jvm.env);
+  bench_strings(jvm.env);
+  bench_arrays(jvm.env);
+
+  struct Mud_Stats_S stats;
+  mud_stats_snapshot(&stats);
+  printf("transitions: %llu, method lookups: %llu, exceptions: %llu\n", (unsigned long long) stats.transitions,
+         (unsigned long long) stats.method_lookups, (unsigned long long) stats.exceptions);
+
+  mud_jvm_destroy_instance(jvm.jvm);
+  return 0;
+}
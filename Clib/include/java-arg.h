@@ -17,5 +17,12 @@ typedef enum Java_Type_E {
   Java_Void,
 } Java_Type;
 
+// how pinned array elements are handed back to the JVM, matches the JNI release modes
+typedef enum Java_Release_Mode_E {
+  Java_Release_Copy_Back = 0,
+  Java_Release_Commit = 1,
+  Java_Release_Abort = 2,
+} Java_Release_Mode;
+
 #endif //MUD_INCLUDE_JAVA_ARG_H_
 
@@ -3,6 +3,7 @@
 
 #include <jni.h>
 #include <stdbool.h>
+#include <stdint.h>
 #include <stdlib.h>
 #include <string.h>
 
@@ -44,8 +45,162 @@ EXPORT JavaVMOption* mud_jvm_options(size_t amnt);
 EXPORT void mud_jvm_options_set(JavaVMOption* options, size_t index, const char* val);
 EXPORT JavaVMOption* mud_jvm_options_va(size_t amnt, ...);
 EXPORT JavaVMOption* mud_jvm_options_str_arr(size_t amnt, const char** options);
+// jvm and env are null when the JVM could not be created with the options
 EXPORT Java_JVM_Instance mud_jvm_create_instance(JavaVMOption* options, int amnt);
 EXPORT void mud_jvm_destroy_instance(JavaVM* jvm);
+// per thread env resolution, threads attached through mud are detached automatically when they exit
+EXPORT JNIEnv* mud_jvm_get_env(JavaVM* jvm);
+EXPORT JNIEnv* mud_jvm_attach_thread(JavaVM* jvm, bool daemon);
+EXPORT bool mud_jvm_detach_thread(JavaVM* jvm);
+EXPORT jobject mud_new_global_ref(JNIEnv* env, jobject obj);
+EXPORT void mud_release_global_ref(JNIEnv* env, jobject obj);
+
+// handle table of global refs held by .NET, see handle-table.c
+struct Mud_Handle_S {
+  uint64_t id;
+  jobject obj;
+};
+
+EXPORT struct Mud_Handle_S mud_handle_promote(JNIEnv* env, jobject local);
+EXPORT jobject mud_handle_get(uint64_t id);
+EXPORT bool mud_handle_release(JNIEnv* env, uint64_t id);
+EXPORT size_t mud_handle_count(void);
+
+// interop counters summed across every thread, see stats.c
+#define MUD_STATS_LATENCY_BUCKETS 32
+struct Mud_Stats_S {
+  // calls from .NET into mud
+  uint64_t transitions;
+  // GetMethodID/GetFieldID lookups, .NET caches these so each one is a ClassInfo cache miss
+  uint64_t method_lookups;
+  uint64_t field_lookups;
+  // java method calls indexed by the Java_Type they return
+  uint64_t calls_by_type[Java_Void + 1];
+  uint64_t exceptions;
+  uint64_t local_refs_created;
+  uint64_t local_refs_released;
+  uint64_t global_refs_created;
+  uint64_t global_refs_released;
+  uint64_t string_bytes;
+  uint64_t array_bytes;
+  // only recorded while timing is enabled, bucket i counts calls taking [2^i, 2^(i+1)) nanoseconds
+  uint64_t call_latency[MUD_STATS_LATENCY_BUCKETS];
+};
+
+EXPORT void mud_stats_snapshot(struct Mud_Stats_S* out);
+EXPORT void mud_stats_set_timing(bool enabled);
+
+// class identity cache mapping a java class to a .NET token, see class-cache.c
+// cls is set to a local ref of the object's class when it is not registered yet, the token is then 0
+EXPORT uint64_t mud_class_cache_get(JNIEnv* env, jobject obj, jclass* cls);
+EXPORT void mud_class_cache_put(JNIEnv* env, jclass cls, uint64_t token);
+EXPORT size_t mud_class_cache_count(void);
+
+// boxed primitives, see box.c. Numeric types unbox any java.lang.Number as its xxxValue converts it
+// box of value made by the type's valueOf, null with a pending exception if it threw
+EXPORT jobject mud_box(JNIEnv* env, jvalue value, Java_Type type);
+EXPORT struct JavaCallResp_S mud_unbox(JNIEnv* env, jobject boxed, Java_Type type);
+/**
+ * Number of primitives of the type obj holds, for a j<type>[] boxes is left null and the elements are read as a
+ * primitive array. For an array of boxes or a java.util.Collection of them boxes is set to an Object[] of the boxes
+ * @return The number of elements, -1 with a pending exception when obj is neither
+ */
+EXPORT int64_t mud_boxed_length(JNIEnv* env, jobject obj, Java_Type type, jobjectArray* boxes);
+// unboxes the first len boxes into the packed j<type> buffer values, null elements throw a NullPointerException
+EXPORT jthrowable mud_unbox_array(JNIEnv* env, jobjectArray boxes, size_t len, void* values, Java_Type type);
+// java.util.ArrayList of the boxed values of the packed j<type> buffer, null with a pending exception if it threw
+EXPORT jobject mud_box_list(JNIEnv* env, size_t len, const void* values, Java_Type type);
+
+// identity map from a java object to the token .NET registered its wrapper under, see identity-map.c
+// objects are held through weak global refs, hash is set to the object's identity hash for the put after a miss
+EXPORT uint64_t mud_identity_get(JNIEnv* env, jobject obj, jint* hash);
+EXPORT void mud_identity_put(JNIEnv* env, jobject obj, jint hash, uint64_t token);
+// removes the entry registered under the token, if the object has not been registered under another one since
+EXPORT void mud_identity_remove(JNIEnv* env, jint hash, uint64_t token);
+EXPORT size_t mud_identity_count(void);
+
+// chunked iteration, see iterate.c
+struct Mud_Chunk_S {
+  size_t count;
+  // the iterator has no more elements
+  bool done;
+  jthrowable exception;
+};
+/**
+ * Pulls up to max elements from the java.util.Iterator. Primitive types unbox each element into out as a packed j<type>
+ * buffer, Java_Object stores each element's local ref into out as a jobject buffer
+ */
+EXPORT struct Mud_Chunk_S mud_iterator_next_chunk(JNIEnv* env, jobject iter, Java_Type type, size_t max, void* out);
+/**
+ * Copies the strings' UTF-16 chars back to back into buf while they fit, each length is stored at its index
+ * with -1 marking a null string. The length of the first string that did not fit is stored as well. Copying stops with a
+ * pending ClassCastException at an element that is not a string
+ * @return The number of strings copied
+ */
+EXPORT size_t mud_strings_copy_utf16(JNIEnv* env, const jstring* strs, size_t count, jchar* buf, size_t capacity, jsize* lengths);
+
+// local frames, every local ref made after the push is released by the pop except keep which moves to the outer frame
+EXPORT bool mud_push_local_frame(JNIEnv* env, jint capacity);
+EXPORT jobject mud_pop_local_frame(JNIEnv* env, jobject keep);
+
+// upcalls from java into .NET, see upcall.c
+// the dispatcher is handed each call made on a proxy created by mud_upcall_proxy, it fills result and returns its type,
+// primitive results are boxed before being handed back to java
+// method is the reflected java.lang.reflect.Method and methodId its id, which stays the same across calls
+typedef Java_Type (*mud_upcall_dispatcher)(JNIEnv* env, uint64_t handle, jobject proxy, jmethodID methodId, jobject method,
+                                           jobjectArray args, jvalue* result);
+EXPORT bool mud_upcall_init(JNIEnv* env, mud_upcall_dispatcher dispatcher);
+// proxy implementing the interface whose calls are dispatched with the provided handle, null if it threw
+EXPORT jobject mud_upcall_proxy(JNIEnv* env, jclass iface, uint64_t handle);
+// raises ex from within a dispatched call, or a java.lang.RuntimeException with msg when ex is null
+EXPORT void mud_upcall_throw(JNIEnv* env, jthrowable ex, const char* msg);
+// binds a native method declared by the class to the provided function
+EXPORT bool mud_register_native(JNIEnv* env, jclass cls, const char* method, const char* signature, void* fn);
+
+// single producer single consumer ring buffer shared with java through a direct ByteBuffer, see ring.c
+// the buffer starts with a header of native order 64 bit words each on its own cache line, followed by the data
+#define MUD_RING_HEAD_OFFSET 0        // bytes ever published by the producer
+#define MUD_RING_TAIL_OFFSET 64       // bytes ever released by the consumer
+#define MUD_RING_WAITERS_OFFSET 128   // threads blocked in mud_ring_await_*, signal the ring after moving head or tail when set
+#define MUD_RING_CAPACITY_OFFSET 192  // size of the data, a power of two
+#define MUD_RING_HEADER_SIZE 256
+struct Mud_Ring_S;
+// null when capacity is not a power of two or the memory could not be allocated
+EXPORT struct Mud_Ring_S* mud_ring_create(uint64_t capacity);
+EXPORT void mud_ring_destroy(struct Mud_Ring_S* ring);
+// the header followed by the data
+EXPORT uint8_t* mud_ring_memory(struct Mud_Ring_S* ring);
+// direct ByteBuffer over the ring's memory, java has to set its order to ByteOrder.nativeOrder()
+EXPORT jobject mud_ring_buffer(JNIEnv* env, struct Mud_Ring_S* ring);
+// blocks until there are bytes to read or at least bytes of free space, for at most timeout_ns or forever when negative
+// returns the bytes readable/writable, which are less than asked for when the timeout passed
+EXPORT uint64_t mud_ring_await_readable(struct Mud_Ring_S* ring, int64_t timeout_ns);
+EXPORT uint64_t mud_ring_await_writable(struct Mud_Ring_S* ring, uint64_t bytes, int64_t timeout_ns);
+// wakes the threads blocked on the ring
+EXPORT void mud_ring_signal(struct Mud_Ring_S* ring);
+// defines mud/NativeRing exposing the await and signal functions to java, taking the ring's address as a long
+EXPORT bool mud_ring_init(JNIEnv* env);
+
+// class loaders defining the classes of jars held in native memory, see class-loader.c. The central directory of each
+// jar is indexed once and its classes are defined on demand, a loader only sees its own jars and those of its parents
+struct Mud_Class_Loader_S;
+// loader without jars whose parent is the provided java.lang.ClassLoader, or the system class loader when null
+// null with a pending exception when the java loader could not be created
+EXPORT struct Mud_Class_Loader_S* mud_loader_create(JNIEnv* env, jobject parent);
+// memory maps the jar and indexes its classes, a class in a jar added earlier wins
+// false when the file can not be mapped or is not a jar
+EXPORT bool mud_loader_add_jar(struct Mud_Class_Loader_S* loader, const char* path);
+// same as mud_loader_add_jar over a copy of the jar's bytes
+EXPORT bool mud_loader_add_jar_bytes(struct Mud_Class_Loader_S* loader, const uint8_t* bytes, size_t len);
+// the loader's java.lang.ClassLoader, null once it is closed
+EXPORT jobject mud_loader_object(JNIEnv* env, struct Mud_Class_Loader_S* loader);
+// amount of classes indexed across the loader's jars
+EXPORT size_t mud_loader_class_count(struct Mud_Class_Loader_S* loader);
+// loads the class through the loader's parent first and then its jars, null when it is not found. Other errors raised
+// while loading it, e.g. a ClassFormatError, are left pending
+EXPORT jclass mud_loader_load_class(JNIEnv* env, struct Mud_Class_Loader_S* loader, const char* className);
+// unmaps the jars once no class is being defined from them, classes already defined stay usable
+EXPORT void mud_loader_close(JNIEnv* env, struct Mud_Class_Loader_S* loader);
 
 
 
@@ -55,7 +210,32 @@ struct Java_String_Resp {
 };
 
 EXPORT jstring mud_string_new(JNIEnv *env, const char* msg);
+EXPORT jstring mud_string_new_utf16(JNIEnv *env, const jchar* chars, jsize len);
+/**
+ * Copies the string's UTF-16 chars into the caller's buffer when it fits
+ * @param capacity Size of the buffer in chars
+ * @return The length of the string, nothing is copied when it is larger than capacity
+ */
+EXPORT jsize mud_string_copy_utf16(JNIEnv *env, jstring str, jchar* buf, jsize capacity);
 EXPORT jarray mud_array_new(JNIEnv *env, size_t size, jvalue* values, Java_Type type, jclass objCls);
+// bulk primitive array marshaling, `values` is a packed buffer of the matching j<type> (e.g. jdouble* for Java_Double)
+EXPORT jarray mud_array_new_primitive(JNIEnv *env, size_t size, const void* values, Java_Type type);
+EXPORT jthrowable mud_array_set_region(JNIEnv *env, jarray arr, size_t start, size_t len, const void* values, Java_Type type);
+EXPORT jthrowable mud_array_get_region(JNIEnv *env, jarray arr, size_t start, size_t len, void* values, Java_Type type);
+// nested primitive arrays built from and read into one packed buffer of elements. A rectangular array of `rank`
+// dimensions (e.g. [[D for rank 2) is described by `dims` with its elements in row major order. A jagged array of
+// arrays is described by the length of each row, -1 standing for a null row, with the rows packed back to back
+#define MUD_ARRAY_MAX_RANK 32
+EXPORT jarray mud_array_new_shaped(JNIEnv* env, size_t rank, const size_t* dims, const void* values, Java_Type type);
+// reads the dimensions off the first element of each level
+EXPORT jthrowable mud_array_shape(JNIEnv* env, jobjectArray arr, size_t rank, size_t* dims);
+EXPORT jthrowable mud_array_get_shaped(JNIEnv* env, jobjectArray arr, size_t rank, const size_t* dims, void* values, Java_Type type);
+EXPORT jobjectArray mud_array_new_jagged(JNIEnv* env, size_t rows, const int64_t* lengths, const void* values, Java_Type type);
+EXPORT jthrowable mud_array_jagged_lengths(JNIEnv* env, jobjectArray arr, size_t rows, int64_t* lengths);
+EXPORT jthrowable mud_array_get_jagged(JNIEnv* env, jobjectArray arr, size_t rows, const int64_t* lengths, void* values, Java_Type type);
+// in place access to primitive array elements, critical pins must be released before any other JNI call on the thread
+EXPORT ptr mud_array_pin(JNIEnv *env, jarray arr, Java_Type type, bool critical, bool* isCopy);
+EXPORT void mud_array_unpin(JNIEnv *env, jarray arr, ptr elems, Java_Type type, bool critical, Java_Release_Mode mode);
 
 //Java_Typed_Val _java_call_method_manual(JNIEnv* env,
 //                                 jobject obj,
@@ -69,11 +249,9 @@ struct Java_Exception_S {
     char* stack_trace;
 };
 
-EXPORT char* mud_get_exception_msg(JNIEnv* env, jthrowable ex, jmethodID getCauseMethod,
-                            jmethodID  getStackMethod, jmethodID exToStringMethod,
-                            jmethodID frameToStringMethod, bool isTop);
 
-EXPORT void mud_add_class_path(JNIEnv* env, const char* path);
+// adds the url to the system class loader, false when it is not a URLClassLoader as it is since Java 9
+EXPORT bool mud_add_class_path(JNIEnv* env, const char* path);
 EXPORT jclass mud_get_class(JNIEnv* env, const char* className);
 EXPORT jclass mud_get_class_of_obj(JNIEnv* env, jobject obj);
 
@@ -160,6 +338,23 @@ EXPORT struct JavaCallResp_S mud_call_static_method(JNIEnv* env, jobject obj, jm
 
 EXPORT struct JavaCallResp_S mud_call_method(JNIEnv* env, jobject obj, jmethodID method, Java_Type type, const jvalue* args);
 
+/**
+ * A single call within a batch, the arguments start at arg_offset within the batch's shared argument buffer
+ */
+struct Mud_Batch_Call_S {
+  jobject obj_or_cls;
+  jmethodID method;
+  Java_Type type;
+  bool is_static;
+  uint32_t arg_offset;
+};
+
+/**
+ * Runs each of the calls in order filling its matching result, stops after the first call that throws
+ * @return The number of calls that were run, including the one that threw
+ */
+EXPORT size_t mud_call_batch(JNIEnv* env, const struct Mud_Batch_Call_S* calls, size_t count, const jvalue* args, struct JavaCallResp_S* results);
+
 static struct JavaCallResp_S mud_call_method_by_name(JNIEnv* env, jclass cls, const char* methodName, const char* signature, Java_Type type, const jvalue* args) {
 
   return mud_call_method(env, cls, mud_get_method(env, cls, methodName, signature), type, args);
@@ -265,7 +460,33 @@ EXPORT jvalue mud_get_field_value(JNIEnv* env, jobject cls, jfieldID field, Java
 EXPORT void mud_set_field_value(JNIEnv* env, jobject cls, jfieldID field, Java_Type type, jvalue value);
 EXPORT jvalue mud_get_static_field_value(JNIEnv* env, jclass cls, jfieldID field, Java_Type type);
 EXPORT void mud_set_static_field_value(JNIEnv* env, jobject cls, jfieldID field, Java_Type type, jvalue value);
+/**
+ * One field of a layout descriptor, the field's value is stored at offset bytes into each record
+ * using the width of its type, object fields are stored as local references
+ */
+struct Mud_Field_Layout_S {
+  jfieldID field;
+  Java_Type type;
+  uint32_t offset;
+};
+
+/**
+ * Reads every field of the layout from each of the objects into the record at the object's index,
+ * records are stride bytes apart. Fields are primitives only, a null object stops the read with a NullPointerException
+ */
+EXPORT jthrowable mud_get_fields_bulk(JNIEnv* env, const jobject* objs, size_t count, const struct Mud_Field_Layout_S* fields,
+                                      size_t fieldCount, void* records, size_t stride);
+/**
+ * Writes every field of the layout into each of the objects from the record at the object's index,
+ * records are stride bytes apart. Fields are primitives only, a null object stops the write with a NullPointerException
+ */
+EXPORT jthrowable mud_set_fields_bulk(JNIEnv* env, const jobject* objs, size_t count, const struct Mud_Field_Layout_S* fields,
+                                      size_t fieldCount, const void* records, size_t stride);
+
 EXPORT bool mud_instance_of(JNIEnv* env, jobject obj, jclass cls);
+// whether a value of class sub can be passed where sup is expected, primitive classes are only assignable to themselves
+EXPORT bool mud_is_assignable_from(JNIEnv* env, jclass sub, jclass sup);
+EXPORT bool mud_is_same_object(JNIEnv* env, jobject a, jobject b);
 
 EXPORT size_t mud_array_length(JNIEnv* env, jarray arr);
 EXPORT jvalue mud_array_get_at(JNIEnv* env, jarray arr, int index, Java_Type type);
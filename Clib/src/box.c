@@ -0,0 +1,228 @@
+#include "../include/mud.h"
+#include "box.h"
+#include "stats.h"
+#include "sync-util.h"
+
+// Boxed primitives handled natively rather than through .NET's by-name calls. The boxing classes, their valueOf and the
+// unboxing methods are looked up once. Numeric types unbox any java.lang.Number the way its xxxValue converts it, so a
+// java.lang.Long read as a double behaves as Long.doubleValue does.
+
+// boxing class, its valueOf and the primitive array class indexed by the primitive's Java_Type
+static jclass box_cls[Java_Void + 1];
+static jmethodID box_value_of[Java_Void + 1];
+static jclass box_array_cls[Java_Void + 1];
+// unboxing method of the primitive indexed by its Java_Type, declared by java.lang.Number for the numeric types
+static jmethodID box_unbox[Java_Void + 1];
+static jclass box_number_cls = null;
+static jclass box_object_array_cls = null;
+static jclass box_collection_cls = null;
+static jmethodID box_to_array = null;
+static jclass box_list_cls = null;
+static jmethodID box_list_new = null;
+static jmethodID box_list_add = null;
+static mud_mutex box_lock = MUD_MUTEX_INIT;
+
+static jclass box_global_class(JNIEnv* env, const char* name) {
+  jclass local = (*env)->FindClass(env, name);
+  if (!local) {
+    return null;
+  }
+  jclass global = (*env)->NewGlobalRef(env, local);
+  (*env)->DeleteLocalRef(env, local);
+  return global;
+}
+
+static bool box_init_type(JNIEnv* env, Java_Type type, const char* name, const char* valueOfSig, const char* arrayName) {
+  box_cls[type] = box_global_class(env, name);
+  box_array_cls[type] = box_cls[type] ? box_global_class(env, arrayName) : null;
+  if (!box_array_cls[type]) {
+    return false;
+  }
+  box_value_of[type] = (*env)->GetStaticMethodID(env, box_cls[type], "valueOf", valueOfSig);
+  return box_value_of[type] != null;
+}
+
+static bool box_init_unbox(JNIEnv* env, Java_Type type, jclass cls, const char* name, const char* signature) {
+  box_unbox[type] = (*env)->GetMethodID(env, cls, name, signature);
+  return box_unbox[type] != null;
+}
+
+bool mud_box_init(JNIEnv* env) {
+  if (box_list_add) {
+    return true;
+  }
+  mud_mutex_lock(&box_lock);
+  if (!box_list_add) {
+    bool ok = box_init_type(env, Java_Int, "java/lang/Integer", "(I)Ljava/lang/Integer;", "[I")
+        && box_init_type(env, Java_Bool, "java/lang/Boolean", "(Z)Ljava/lang/Boolean;", "[Z")
+        && box_init_type(env, Java_Byte, "java/lang/Byte", "(B)Ljava/lang/Byte;", "[B")
+        && box_init_type(env, Java_Char, "java/lang/Character", "(C)Ljava/lang/Character;", "[C")
+        && box_init_type(env, Java_Short, "java/lang/Short", "(S)Ljava/lang/Short;", "[S")
+        && box_init_type(env, Java_Long, "java/lang/Long", "(J)Ljava/lang/Long;", "[J")
+        && box_init_type(env, Java_Float, "java/lang/Float", "(F)Ljava/lang/Float;", "[F")
+        && box_init_type(env, Java_Double, "java/lang/Double", "(D)Ljava/lang/Double;", "[D")
+        && (box_number_cls = box_global_class(env, "java/lang/Number"))
+        && box_init_unbox(env, Java_Int, box_number_cls, "intValue", "()I")
+        && box_init_unbox(env, Java_Long, box_number_cls, "longValue", "()J")
+        && box_init_unbox(env, Java_Byte, box_number_cls, "byteValue", "()B")
+        && box_init_unbox(env, Java_Short, box_number_cls, "shortValue", "()S")
+        && box_init_unbox(env, Java_Float, box_number_cls, "floatValue", "()F")
+        && box_init_unbox(env, Java_Double, box_number_cls, "doubleValue", "()D")
+        && box_init_unbox(env, Java_Bool, box_cls[Java_Bool], "booleanValue", "()Z")
+        && box_init_unbox(env, Java_Char, box_cls[Java_Char], "charValue", "()C")
+        && (box_object_array_cls = box_global_class(env, "[Ljava/lang/Object;"))
+        && (box_collection_cls = box_global_class(env, "java/util/Collection"))
+        && (box_to_array = (*env)->GetMethodID(env, box_collection_cls, "toArray", "()[Ljava/lang/Object;"))
+        && (box_list_cls = box_global_class(env, "java/util/ArrayList"))
+        && (box_list_new = (*env)->GetMethodID(env, box_list_cls, "<init>", "(I)V"));
+    if (ok) {
+      // set last, it marks the cache as ready
+      box_list_add = (*env)->GetMethodID(env, box_list_cls, "add", "(Ljava/lang/Object;)Z");
+    }
+  }
+  mud_mutex_unlock(&box_lock);
+  return box_list_add != null;
+}
+
+jobject mud_box_value(JNIEnv* env, jvalue value, Java_Type type) {
+  return (*env)->CallStaticObjectMethodA(env, box_cls[type], box_value_of[type], &value);
+}
+
+static jclass box_unbox_class(Java_Type type) {
+  return type == Java_Bool || type == Java_Char ? box_cls[type] : box_number_cls;
+}
+
+bool mud_unbox_into(JNIEnv* env, jobject boxed, Java_Type type, void* out, size_t i) {
+  if (!boxed || !(*env)->IsInstanceOf(env, boxed, box_unbox_class(type))) {
+    jclass castEx = (*env)->FindClass(env, boxed ? "java/lang/ClassCastException" : "java/lang/NullPointerException");
+    (*env)->ThrowNew(env, castEx, "value cannot be unboxed to the requested primitive");
+    (*env)->DeleteLocalRef(env, castEx);
+    return false;
+  }
+#define unbox_into(name, jtype) ((jtype*) out)[i] = (*env)->Call##name##Method(env, boxed, box_unbox[type]);
+  if (type == Java_Bool) {
+    unbox_into(Boolean, jboolean)
+  } else if (type == Java_Int) {
+    unbox_into(Int, jint)
+  } else if (type == Java_Long) {
+    unbox_into(Long, jlong)
+  } else if (type == Java_Byte) {
+    unbox_into(Byte, jbyte)
+  } else if (type == Java_Char) {
+    unbox_into(Char, jchar)
+  } else if (type == Java_Short) {
+    unbox_into(Short, jshort)
+  } else if (type == Java_Float) {
+    unbox_into(Float, jfloat)
+  } else if (type == Java_Double) {
+    unbox_into(Double, jdouble)
+  }
+#undef unbox_into
+  return true;
+}
+
+// element i of a packed j<type> buffer
+static jvalue box_element(const void* values, size_t i, Java_Type type) {
+  jvalue value;
+  memset(&value, 0, sizeof(jvalue));
+  switch (type) {
+    case Java_Bool: value.z = ((const jboolean*) values)[i]; break;
+    case Java_Int: value.i = ((const jint*) values)[i]; break;
+    case Java_Long: value.j = ((const jlong*) values)[i]; break;
+    case Java_Byte: value.b = ((const jbyte*) values)[i]; break;
+    case Java_Char: value.c = ((const jchar*) values)[i]; break;
+    case Java_Short: value.s = ((const jshort*) values)[i]; break;
+    case Java_Float: value.f = ((const jfloat*) values)[i]; break;
+    case Java_Double: value.d = ((const jdouble*) values)[i]; break;
+    default: break;
+  }
+  return value;
+}
+
+jobject mud_box(JNIEnv* env, jvalue value, Java_Type type) {
+  mud_stat_transition();
+  if (!mud_box_init(env)) {
+    return null;
+  }
+  jobject boxed = mud_box_value(env, value, type);
+  if (boxed) {
+    mud_stat_add(local_refs_created, 1);
+  }
+  return boxed;
+}
+
+struct JavaCallResp_S mud_unbox(JNIEnv* env, jobject boxed, Java_Type type) {
+  mud_stat_transition();
+  struct JavaCallResp_S resp = {.is_void = false, .is_exception = false};
+  memset(&resp.value, 0, sizeof(jvalue));
+  if (!mud_box_init(env) || !mud_unbox_into(env, boxed, type, &resp.value, 0)) {
+    resp.is_exception = true;
+    resp.value.l = mud_jvm_check_exception(env);
+  }
+  return resp;
+}
+
+int64_t mud_boxed_length(JNIEnv* env, jobject obj, Java_Type type, jobjectArray* boxes) {
+  mud_stat_transition();
+  *boxes = null;
+  if (!mud_box_init(env)) {
+    return -1;
+  }
+  if ((*env)->IsInstanceOf(env, obj, box_array_cls[type])) {
+    return (*env)->GetArrayLength(env, obj);
+  }
+  if ((*env)->IsInstanceOf(env, obj, box_object_array_cls)) {
+    *boxes = (*env)->NewLocalRef(env, obj);
+  } else if ((*env)->IsInstanceOf(env, obj, box_collection_cls)) {
+    // a single call into the collection, which also keeps a concurrent collection's elements consistent
+    *boxes = (*env)->CallObjectMethod(env, obj, box_to_array);
+  } else {
+    jclass argEx = (*env)->FindClass(env, "java/lang/IllegalArgumentException");
+    (*env)->ThrowNew(env, argEx, "only arrays and java.util.Collection can be read as primitives");
+    (*env)->DeleteLocalRef(env, argEx);
+  }
+  if (!*boxes) {
+    return -1;
+  }
+  mud_stat_add(local_refs_created, 1);
+  return (*env)->GetArrayLength(env, *boxes);
+}
+
+jthrowable mud_unbox_array(JNIEnv* env, jobjectArray boxes, size_t len, void* values, Java_Type type) {
+  mud_stat_transition();
+  if (!mud_box_init(env)) {
+    return mud_jvm_check_exception(env);
+  }
+  for (size_t i = 0; i < len; i++) {
+    jobject boxed = (*env)->GetObjectArrayElement(env, boxes, (jsize) i);
+    bool unboxed = !(*env)->ExceptionCheck(env) && mud_unbox_into(env, boxed, type, values, i);
+    (*env)->DeleteLocalRef(env, boxed);
+    if (!unboxed) {
+      break;
+    }
+  }
+  return mud_jvm_check_exception(env);
+}
+
+jobject mud_box_list(JNIEnv* env, size_t len, const void* values, Java_Type type) {
+  mud_stat_transition();
+  if (!mud_box_init(env)) {
+    return null;
+  }
+  jobject list = (*env)->NewObject(env, box_list_cls, box_list_new, (jint) len);
+  for (size_t i = 0; list && i < len; i++) {
+    jobject boxed = mud_box_value(env, box_element(values, i, type), type);
+    if (boxed) {
+      (*env)->CallBooleanMethod(env, list, box_list_add, boxed);
+      (*env)->DeleteLocalRef(env, boxed);
+    }
+    if ((*env)->ExceptionCheck(env)) {
+      (*env)->DeleteLocalRef(env, list);
+      return null;
+    }
+  }
+  if (list) {
+    mud_stat_add(local_refs_created, 1);
+  }
+  return list;
+}
@@ -0,0 +1,18 @@
+//
+// Boxing and unboxing of java primitives shared by the call, iteration and upcall paths, see box.c
+//
+
+#ifndef MUD_BOX_H_
+#define MUD_BOX_H_
+
+#include "../include/mud.h"
+
+// looks up the boxing classes and methods once, false with a pending exception if any is missing
+bool mud_box_init(JNIEnv* env);
+// boxes value with the type's valueOf, mud_box_init must have succeeded
+jobject mud_box_value(JNIEnv* env, jvalue value, Java_Type type);
+// unboxes into slot i of the packed j<type> buffer out, false with a pending NullPointerException or
+// ClassCastException when boxed is null or not a box of the type, mud_box_init must have succeeded
+bool mud_unbox_into(JNIEnv* env, jobject boxed, Java_Type type, void* out, size_t i);
+
+#endif //MUD_BOX_H_
@@ -0,0 +1,135 @@
+#include <stdint.h>
+#include "../include/mud.h"
+#include "stats.h"
+#include "sync-util.h"
+
+// Process wide map from a java class to the token .NET registered for it. Classes are keyed by their identity hash
+// with IsSameObject resolving collisions, so an object's class can be resolved without calling Class.getName.
+
+typedef struct Mud_Class_Entry_S {
+  jclass cls;
+  jint hash;
+  uint64_t token;
+} Mud_Class_Entry;
+
+static Mud_Class_Entry* class_entries = null;
+static size_t class_entries_cap = 0;
+static size_t class_entries_used = 0;
+static jclass class_system_cls = null;
+static jmethodID class_identity_hash = null;
+static mud_mutex class_lock = MUD_MUTEX_INIT;
+
+static bool class_cache_init(JNIEnv* env) {
+  if (class_identity_hash) {
+    return true;
+  }
+  mud_mutex_lock(&class_lock);
+  if (!class_identity_hash) {
+    jclass local = (*env)->FindClass(env, "java/lang/System");
+    if (local) {
+      class_system_cls = (*env)->NewGlobalRef(env, local);
+      (*env)->DeleteLocalRef(env, local);
+      class_identity_hash = (*env)->GetStaticMethodID(env, class_system_cls, "identityHashCode", "(Ljava/lang/Object;)I");
+    }
+  }
+  mud_mutex_unlock(&class_lock);
+  return class_identity_hash != null;
+}
+
+static Mud_Class_Entry* class_entry_find(JNIEnv* env, jclass cls, jint hash) {
+  if (!class_entries_cap) {
+    return null;
+  }
+  size_t mask = class_entries_cap - 1;
+  for (size_t i = (uint32_t) hash & mask;; i = (i + 1) & mask) {
+    Mud_Class_Entry* entry = &class_entries[i];
+    if (!entry->cls) {
+      return null;
+    }
+    if (entry->hash == hash && (*env)->IsSameObject(env, entry->cls, cls)) {
+      return entry;
+    }
+  }
+}
+
+static void class_entry_insert(Mud_Class_Entry* entries, size_t cap, Mud_Class_Entry entry) {
+  size_t mask = cap - 1;
+  size_t i = (uint32_t) entry.hash & mask;
+  while (entries[i].cls) {
+    i = (i + 1) & mask;
+  }
+  entries[i] = entry;
+}
+
+static bool class_entries_grow(void) {
+  size_t cap = class_entries_cap ? class_entries_cap * 2 : 64;
+  Mud_Class_Entry* entries = calloc(cap, sizeof(Mud_Class_Entry));
+  if (!entries) {
+    return false;
+  }
+  for (size_t i = 0; i < class_entries_cap; i++) {
+    if (class_entries[i].cls) {
+      class_entry_insert(entries, cap, class_entries[i]);
+    }
+  }
+  free(class_entries);
+  class_entries = entries;
+  class_entries_cap = cap;
+  return true;
+}
+
+uint64_t mud_class_cache_get(JNIEnv* env, jobject obj, jclass* cls) {
+  mud_stat_transition();
+  *cls = null;
+  if (!obj || !class_cache_init(env)) {
+    return 0;
+  }
+  jclass local = (*env)->GetObjectClass(env, obj);
+  jint hash = (*env)->CallStaticIntMethod(env, class_system_cls, class_identity_hash, local);
+
+  mud_mutex_lock(&class_lock);
+  Mud_Class_Entry* entry = class_entry_find(env, local, hash);
+  uint64_t token = entry ? entry->token : 0;
+  mud_mutex_unlock(&class_lock);
+
+  if (token) {
+    (*env)->DeleteLocalRef(env, local);
+  } else {
+    mud_stat_add(local_refs_created, 1);
+    *cls = local;
+  }
+  return token;
+}
+
+void mud_class_cache_put(JNIEnv* env, jclass cls, uint64_t token) {
+  mud_stat_transition();
+  if (!cls || !token || !class_cache_init(env)) {
+    return;
+  }
+  jint hash = (*env)->CallStaticIntMethod(env, class_system_cls, class_identity_hash, cls);
+
+  mud_mutex_lock(&class_lock);
+  Mud_Class_Entry* existing = class_entry_find(env, cls, hash);
+  if (existing) {
+    existing->token = token;
+    mud_mutex_unlock(&class_lock);
+    return;
+  }
+  // kept at most half full so probes stay short
+  if ((class_entries_used + 1) * 2 > class_entries_cap && !class_entries_grow()) {
+    mud_mutex_unlock(&class_lock);
+    return;
+  }
+  Mud_Class_Entry entry = {.cls = (*env)->NewGlobalRef(env, cls), .hash = hash, .token = token};
+  mud_stat_add(global_refs_created, 1);
+  class_entry_insert(class_entries, class_entries_cap, entry);
+  class_entries_used++;
+  mud_mutex_unlock(&class_lock);
+}
+
+size_t mud_class_cache_count(void) {
+  mud_mutex_lock(&class_lock);
+  size_t used = class_entries_used;
+  mud_mutex_unlock(&class_lock);
+  return used;
+}
@@ -0,0 +1,642 @@
+#include <stdint.h>
+#include "../include/mud.h"
+#include "stats.h"
+#include "sync-util.h"
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+// Class loaders over jars held in native memory. Each jar is memory mapped (or copied from the caller's buffer) and its
+// central directory is indexed once, classes are then defined with DefineClass straight from the mapping when the JVM
+// asks for them rather than read from disk through a URLClassLoader. mud/NativeClassLoader is the java side of a
+// loader, its findClass is bound to loader_find_class so classes defined by it resolve their dependencies through it.
+// Only class entries are indexed, resources are not served. Deflated entries are inflated through
+// java.util.zip.Inflater, whose ByteBuffer methods need Java 11.
+
+// class file of
+//   public final class mud.NativeClassLoader extends java.lang.ClassLoader {
+//     private long handle;
+//     public NativeClassLoader(ClassLoader parent, long handle) { super(parent); this.handle = handle; }
+//     protected native Class findClass(String name);
+//   }
+static const unsigned char loader_class_bytes[] = {
+  0xca, 0xfe, 0xba, 0xbe, 0x00, 0x00, 0x00, 0x34, 0x00, 0x11, 0x01, 0x00, 0x15, 0x6d, 0x75, 0x64,
+  0x2f, 0x4e, 0x61, 0x74, 0x69, 0x76, 0x65, 0x43, 0x6c, 0x61, 0x73, 0x73, 0x4c, 0x6f, 0x61, 0x64,
+  0x65, 0x72, 0x07, 0x00, 0x01, 0x01, 0x00, 0x15, 0x6a, 0x61, 0x76, 0x61, 0x2f, 0x6c, 0x61, 0x6e,
+  0x67, 0x2f, 0x43, 0x6c, 0x61, 0x73, 0x73, 0x4c, 0x6f, 0x61, 0x64, 0x65, 0x72, 0x07, 0x00, 0x03,
+  0x01, 0x00, 0x06, 0x68, 0x61, 0x6e, 0x64, 0x6c, 0x65, 0x01, 0x00, 0x01, 0x4a, 0x01, 0x00, 0x06,
+  0x3c, 0x69, 0x6e, 0x69, 0x74, 0x3e, 0x01, 0x00, 0x1b, 0x28, 0x4c, 0x6a, 0x61, 0x76, 0x61, 0x2f,
+  0x6c, 0x61, 0x6e, 0x67, 0x2f, 0x43, 0x6c, 0x61, 0x73, 0x73, 0x4c, 0x6f, 0x61, 0x64, 0x65, 0x72,
+  0x3b, 0x4a, 0x29, 0x56, 0x01, 0x00, 0x1a, 0x28, 0x4c, 0x6a, 0x61, 0x76, 0x61, 0x2f, 0x6c, 0x61,
+  0x6e, 0x67, 0x2f, 0x43, 0x6c, 0x61, 0x73, 0x73, 0x4c, 0x6f, 0x61, 0x64, 0x65, 0x72, 0x3b, 0x29,
+  0x56, 0x0c, 0x00, 0x07, 0x00, 0x09, 0x0a, 0x00, 0x04, 0x00, 0x0a, 0x0c, 0x00, 0x05, 0x00, 0x06,
+  0x09, 0x00, 0x02, 0x00, 0x0c, 0x01, 0x00, 0x04, 0x43, 0x6f, 0x64, 0x65, 0x01, 0x00, 0x09, 0x66,
+  0x69, 0x6e, 0x64, 0x43, 0x6c, 0x61, 0x73, 0x73, 0x01, 0x00, 0x25, 0x28, 0x4c, 0x6a, 0x61, 0x76,
+  0x61, 0x2f, 0x6c, 0x61, 0x6e, 0x67, 0x2f, 0x53, 0x74, 0x72, 0x69, 0x6e, 0x67, 0x3b, 0x29, 0x4c,
+  0x6a, 0x61, 0x76, 0x61, 0x2f, 0x6c, 0x61, 0x6e, 0x67, 0x2f, 0x43, 0x6c, 0x61, 0x73, 0x73, 0x3b,
+  0x00, 0x31, 0x00, 0x02, 0x00, 0x04, 0x00, 0x00, 0x00, 0x01, 0x00, 0x02, 0x00, 0x05, 0x00, 0x06,
+  0x00, 0x00, 0x00, 0x02, 0x00, 0x01, 0x00, 0x07, 0x00, 0x08, 0x00, 0x01, 0x00, 0x0e, 0x00, 0x00,
+  0x00, 0x17, 0x00, 0x03, 0x00, 0x04, 0x00, 0x00, 0x00, 0x0b, 0x2a, 0x2b, 0xb7, 0x00, 0x0b, 0x2a,
+  0x20, 0xb5, 0x00, 0x0d, 0xb1, 0x00, 0x00, 0x00, 0x00, 0x01, 0x04, 0x00, 0x0f, 0x00, 0x10, 0x00,
+  0x00, 0x00, 0x00,
+};
+
+#define JAR_EOCD_SIG 0x06054b50
+#define JAR_EOCD_SIZE 22
+#define JAR_CENTRAL_SIG 0x02014b50
+#define JAR_CENTRAL_SIZE 46
+#define JAR_LOCAL_SIG 0x04034b50
+#define JAR_LOCAL_SIZE 30
+#define JAR_STORED 0
+#define JAR_DEFLATED 8
+#define JAR_CLASS_SUFFIX ".class"
+#define JAR_CLASS_SUFFIX_LEN 6
+// longest class name findClass looks up, longer names are never found
+#define JAR_MAX_NAME 1024
+
+typedef struct Mud_Jar_S {
+  const uint8_t* data;
+  size_t size;
+  bool mapped;
+} Mud_Jar;
+
+typedef struct Mud_Jar_Entry_S {
+  // internal name of the class, pointing into the jar's central directory and not terminated
+  const uint8_t* name;
+  uint32_t name_len;
+  uint32_t hash;
+  uint32_t jar;
+  uint16_t method;
+  uint32_t compressed_size;
+  uint32_t size;
+  uint32_t header_offset;
+} Mud_Jar_Entry;
+
+struct Mud_Class_Loader_S {
+  Mud_Jar* jars;
+  size_t jar_count;
+  // classes of every jar by name, the jar added first wins
+  Mud_Jar_Entry* entries;
+  size_t cap;
+  size_t classes;
+  // guards the jars and the index, which grow while classes are being found
+  mud_mutex lock;
+  // global ref to the mud/NativeClassLoader
+  jobject loader;
+  // finds running on the loader, the last one out frees a closed loader
+  uint64_t users;
+  bool closed;
+};
+
+static jclass loader_cls = null;
+static jmethodID loader_ctor = null;
+static jfieldID loader_handle_field = null;
+static jmethodID loader_load_class = null;
+static jclass loader_not_found_cls = null;
+static jclass loader_inflater_cls = null;
+static jmethodID loader_inflater_ctor = null;
+static jmethodID loader_inflater_set_input = null;
+static jmethodID loader_inflater_inflate = null;
+static jmethodID loader_inflater_end = null;
+static mud_mutex loader_init_lock = MUD_MUTEX_INIT;
+// guards the users, closed and java loader of every loader, and the handle fields of their java objects
+static mud_mutex loader_lock = MUD_MUTEX_INIT;
+
+static inline uint16_t jar_u16(const uint8_t* p) {
+  return (uint16_t) (p[0] | p[1] << 8);
+}
+
+static inline uint32_t jar_u32(const uint8_t* p) {
+  return (uint32_t) p[0] | (uint32_t) p[1] << 8 | (uint32_t) p[2] << 16 | (uint32_t) p[3] << 24;
+}
+
+// FNV-1a
+static uint32_t jar_hash(const uint8_t* name, size_t len) {
+  uint32_t hash = 2166136261u;
+  for (size_t i = 0; i < len; i++) {
+    hash = (hash ^ name[i]) * 16777619u;
+  }
+  return hash;
+}
+
+static Mud_Jar_Entry* jar_find(struct Mud_Class_Loader_S* loader, const char* name, size_t len) {
+  if (!loader->cap) {
+    return null;
+  }
+  uint32_t hash = jar_hash((const uint8_t*) name, len);
+  size_t mask = loader->cap - 1;
+  for (size_t i = hash & mask; loader->entries[i].name; i = (i + 1) & mask) {
+    Mud_Jar_Entry* entry = &loader->entries[i];
+    if (entry->hash == hash && entry->name_len == len && memcmp(entry->name, name, len) == 0) {
+      return entry;
+    }
+  }
+  return null;
+}
+
+// grows the index to hold at least `classes` entries while staying at most half full
+static bool jar_reserve(struct Mud_Class_Loader_S* loader, size_t classes) {
+  if (classes * 2 <= loader->cap) {
+    return true;
+  }
+  size_t cap = loader->cap ? loader->cap : 64;
+  while (classes * 2 > cap) {
+    cap *= 2;
+  }
+  Mud_Jar_Entry* entries = calloc(cap, sizeof(Mud_Jar_Entry));
+  if (!entries) {
+    return false;
+  }
+  for (size_t i = 0; i < loader->cap; i++) {
+    if (loader->entries[i].name) {
+      size_t j = loader->entries[i].hash & (cap - 1);
+      while (entries[j].name) {
+        j = (j + 1) & (cap - 1);
+      }
+      entries[j] = loader->entries[i];
+    }
+  }
+  free(loader->entries);
+  loader->entries = entries;
+  loader->cap = cap;
+  return true;
+}
+
+// the jar's end of central directory record, which is followed by a comment of at most 64KiB
+static const uint8_t* jar_end_record(const uint8_t* data, size_t size) {
+  if (size < JAR_EOCD_SIZE) {
+    return null;
+  }
+  size_t lowest = size > JAR_EOCD_SIZE + 0xffff ? size - JAR_EOCD_SIZE - 0xffff : 0;
+  for (size_t i = size - JAR_EOCD_SIZE + 1; i-- > lowest;) {
+    if (jar_u32(data + i) == JAR_EOCD_SIG) {
+      return data + i;
+    }
+  }
+  return null;
+}
+
+// adds the class entries of the jar's central directory to the index, false when the data is not a jar this loader
+// can read. Entries indexed before a failure stay, they point into a jar that is kept until the loader is freed
+static bool jar_index(struct Mud_Class_Loader_S* loader, uint32_t jar_id) {
+  const Mud_Jar* jar = &loader->jars[jar_id];
+  const uint8_t* eocd = jar_end_record(jar->data, jar->size);
+  if (!eocd) {
+    return false;
+  }
+  size_t dir_size = jar_u32(eocd + 12);
+  size_t dir_offset = jar_u32(eocd + 16);
+  // zip64 jars keep the real values in another record
+  if (dir_offset == 0xffffffff || dir_offset > jar->size || dir_size > jar->size - dir_offset) {
+    return false;
+  }
+  if (!jar_reserve(loader, loader->classes + jar_u16(eocd + 10))) {
+    return false;
+  }
+
+  // walked by its size rather than the entry count, which zip64 jars with more than 65535 entries overflow
+  const uint8_t* p = jar->data + dir_offset;
+  const uint8_t* end = p + dir_size;
+  while (end - p >= JAR_CENTRAL_SIZE && jar_u32(p) == JAR_CENTRAL_SIG) {
+    uint16_t flags = jar_u16(p + 8);
+    uint16_t method = jar_u16(p + 10);
+    uint32_t compressed_size = jar_u32(p + 20);
+    uint32_t size = jar_u32(p + 24);
+    size_t name_len = jar_u16(p + 28);
+    size_t record_len = JAR_CENTRAL_SIZE + name_len + jar_u16(p + 30) + jar_u16(p + 32);
+    uint32_t header_offset = jar_u32(p + 42);
+    const uint8_t* name = p + JAR_CENTRAL_SIZE;
+    if ((size_t) (end - p) < record_len) {
+      return false;
+    }
+    p += record_len;
+
+    // encrypted entries and zip64 sizes are skipped, no class file comes near 4GiB
+    bool readable = !(flags & 1) && (method == JAR_STORED || method == JAR_DEFLATED) &&
+                    compressed_size != 0xffffffff && size != 0xffffffff && header_offset != 0xffffffff;
+    if (!readable || name_len <= JAR_CLASS_SUFFIX_LEN ||
+        memcmp(name + name_len - JAR_CLASS_SUFFIX_LEN, JAR_CLASS_SUFFIX, JAR_CLASS_SUFFIX_LEN) != 0) {
+      continue;
+    }
+    name_len -= JAR_CLASS_SUFFIX_LEN;
+    // the first entry of a name wins, as it does for java's class path
+    if (jar_find(loader, (const char*) name, name_len)) {
+      continue;
+    }
+    // the entry count is 0xffff in zip64 jars
+    if (!jar_reserve(loader, loader->classes + 1)) {
+      return false;
+    }
+    uint32_t hash = jar_hash(name, name_len);
+    size_t i = hash & (loader->cap - 1);
+    while (loader->entries[i].name) {
+      i = (i + 1) & (loader->cap - 1);
+    }
+    loader->entries[i] = (Mud_Jar_Entry) {
+        .name = name,
+        .name_len = (uint32_t) name_len,
+        .hash = hash,
+        .jar = jar_id,
+        .method = method,
+        .compressed_size = compressed_size,
+        .size = size,
+        .header_offset = header_offset,
+    };
+    loader->classes++;
+  }
+  return true;
+}
+
+// the entry's data as stored in its jar, null when its local header does not fit the jar
+static const uint8_t* jar_entry_data(struct Mud_Class_Loader_S* loader, const Mud_Jar_Entry* entry) {
+  const Mud_Jar* jar = &loader->jars[entry->jar];
+  size_t offset = entry->header_offset;
+  if (offset > jar->size || jar->size - offset < JAR_LOCAL_SIZE) {
+    return null;
+  }
+  const uint8_t* header = jar->data + offset;
+  // the local header carries its own name and extra lengths, which can differ from the central directory's
+  size_t data_offset = offset + JAR_LOCAL_SIZE + jar_u16(header + 26) + jar_u16(header + 28);
+  if (jar_u32(header) != JAR_LOCAL_SIG || data_offset > jar->size || jar->size - data_offset < entry->compressed_size) {
+    return null;
+  }
+  return jar->data + data_offset;
+}
+
+// inflates the raw deflate stream into out, false with a pending exception when it is short or corrupt
+static bool jar_inflate(JNIEnv* env, const uint8_t* in, uint32_t in_len, uint8_t* out, uint32_t out_len) {
+  if (!loader_inflater_set_input) {
+    (*env)->ThrowNew(env, loader_not_found_cls, "inflating classes needs java.util.zip.Inflater's ByteBuffer methods");
+    return false;
+  }
+  jobject inflater = (*env)->NewObject(env, loader_inflater_cls, loader_inflater_ctor, JNI_TRUE);
+  if (!inflater) {
+    return false;
+  }
+  // the inflater only reads the input buffer, so it may point into the read only mapping
+  jobject input = (*env)->NewDirectByteBuffer(env, (void*) in, in_len);
+  jobject output = (*env)->NewDirectByteBuffer(env, out, out_len);
+  uint32_t total = 0;
+  if (input && output) {
+    (*env)->CallVoidMethod(env, inflater, loader_inflater_set_input, input);
+    while (total < out_len && !(*env)->ExceptionCheck(env)) {
+      jint n = (*env)->CallIntMethod(env, inflater, loader_inflater_inflate, output);
+      if ((*env)->ExceptionCheck(env) || n <= 0) {
+        break;
+      }
+      total += (uint32_t) n;
+    }
+  }
+  // end frees the native stream now rather than when the inflater is collected, keeping any exception raised before
+  jthrowable pending = (*env)->ExceptionOccurred(env);
+  (*env)->ExceptionClear(env);
+  (*env)->CallVoidMethod(env, inflater, loader_inflater_end);
+  if (pending) {
+    (*env)->ExceptionClear(env);
+    (*env)->Throw(env, pending);
+    (*env)->DeleteLocalRef(env, pending);
+  }
+  (*env)->DeleteLocalRef(env, input);
+  (*env)->DeleteLocalRef(env, output);
+  (*env)->DeleteLocalRef(env, inflater);
+  if ((*env)->ExceptionCheck(env)) {
+    return false;
+  }
+  if (total != out_len) {
+    (*env)->ThrowNew(env, loader_not_found_cls, "class entry is shorter than its recorded size");
+    return false;
+  }
+  return true;
+}
+
+static void jar_unmap(Mud_Jar* jar) {
+  if (jar->mapped) {
+#ifdef _WIN32
+    UnmapViewOfFile(jar->data);
+#else
+    munmap((void*) jar->data, jar->size);
+#endif
+  } else {
+    free((void*) jar->data);
+  }
+}
+
+static void loader_free(struct Mud_Class_Loader_S* loader) {
+  for (size_t i = 0; i < loader->jar_count; i++) {
+    jar_unmap(&loader->jars[i]);
+  }
+  free(loader->jars);
+  free(loader->entries);
+  free(loader);
+}
+
+static void loader_release(struct Mud_Class_Loader_S* loader) {
+  mud_mutex_lock(&loader_lock);
+  bool last = --loader->users == 0 && loader->closed;
+  mud_mutex_unlock(&loader_lock);
+  if (last) {
+    loader_free(loader);
+  }
+}
+
+static jclass JNICALL loader_find_class(JNIEnv* env, jobject self, jstring name) {
+  mud_mutex_lock(&loader_lock);
+  struct Mud_Class_Loader_S* loader = (struct Mud_Class_Loader_S*) (intptr_t) (*env)->GetLongField(env, self, loader_handle_field);
+  if (loader) {
+    loader->users++;
+  }
+  mud_mutex_unlock(&loader_lock);
+
+  // binary names use dots where the jar's entries use slashes
+  char internal[JAR_MAX_NAME + 1];
+  jsize len = name ? (*env)->GetStringUTFLength(env, name) : 0;
+  Mud_Jar_Entry entry;
+  const uint8_t* data = null;
+  if (loader && name && len <= JAR_MAX_NAME) {
+    (*env)->GetStringUTFRegion(env, name, 0, (*env)->GetStringLength(env, name), internal);
+    internal[len] = '\0';
+    for (jsize i = 0; i < len; i++) {
+      if (internal[i] == '.') {
+        internal[i] = '/';
+      }
+    }
+    // copied out since the index may be rebuilt once the lock is released, the jar itself stays mapped
+    mud_mutex_lock(&loader->lock);
+    Mud_Jar_Entry* found = jar_find(loader, internal, (size_t) len);
+    if (found) {
+      entry = *found;
+      data = jar_entry_data(loader, &entry);
+    }
+    mud_mutex_unlock(&loader->lock);
+  }
+  if (!data) {
+    if (loader) {
+      loader_release(loader);
+    }
+    const char* msg = name ? (*env)->GetStringUTFChars(env, name, null) : null;
+    (*env)->ThrowNew(env, loader_not_found_cls, msg);
+    if (msg) {
+      (*env)->ReleaseStringUTFChars(env, name, msg);
+    }
+    return null;
+  }
+
+  jclass cls = null;
+  if (entry.method == JAR_STORED) {
+    // straight from the mapping, DefineClass copies what it keeps
+    cls = (*env)->DefineClass(env, internal, self, (const jbyte*) data, (jsize) entry.compressed_size);
+  } else {
+    uint8_t* bytes = malloc(entry.size ? entry.size : 1);
+    if (!bytes) {
+      (*env)->ThrowNew(env, loader_not_found_cls, "out of memory inflating the class");
+    } else if (jar_inflate(env, data, entry.compressed_size, bytes, entry.size)) {
+      cls = (*env)->DefineClass(env, internal, self, (const jbyte*) bytes, (jsize) entry.size);
+    }
+    free(bytes);
+  }
+  loader_release(loader);
+  return cls;
+}
+
+static jclass loader_global_class(JNIEnv* env, const char* name) {
+  jclass local = (*env)->FindClass(env, name);
+  if (!local) {
+    return null;
+  }
+  jclass global = (*env)->NewGlobalRef(env, local);
+  (*env)->DeleteLocalRef(env, local);
+  return global;
+}
+
+static bool loader_define_class(JNIEnv* env) {
+  // defined into the system class loader like the other mud classes, a loader's parent is chosen per instance
+  jclass classLoaderCls = (*env)->FindClass(env, "java/lang/ClassLoader");
+  if (!classLoaderCls) {
+    return false;
+  }
+  jmethodID getSystemLoader = (*env)->GetStaticMethodID(env, classLoaderCls, "getSystemClassLoader", "()Ljava/lang/ClassLoader;");
+  jobject system = getSystemLoader ? (*env)->CallStaticObjectMethod(env, classLoaderCls, getSystemLoader) : null;
+  loader_load_class = (*env)->GetMethodID(env, classLoaderCls, "loadClass", "(Ljava/lang/String;)Ljava/lang/Class;");
+  (*env)->DeleteLocalRef(env, classLoaderCls);
+  if (!system || !loader_load_class) {
+    return false;
+  }
+  jclass local = (*env)->DefineClass(env, "mud/NativeClassLoader", system, (const jbyte*) loader_class_bytes,
+                                     (jsize) sizeof(loader_class_bytes));
+  (*env)->DeleteLocalRef(env, system);
+  if (!local) {
+    return false;
+  }
+  JNINativeMethod findClass = {
+      .name = "findClass",
+      .signature = "(Ljava/lang/String;)Ljava/lang/Class;",
+      .fnPtr = (void*) loader_find_class
+  };
+  if ((*env)->RegisterNatives(env, local, &findClass, 1) != JNI_OK) {
+    (*env)->DeleteLocalRef(env, local);
+    return false;
+  }
+  loader_ctor = (*env)->GetMethodID(env, local, "<init>", "(Ljava/lang/ClassLoader;J)V");
+  loader_handle_field = (*env)->GetFieldID(env, local, "handle", "J");
+  loader_not_found_cls = loader_global_class(env, "java/lang/ClassNotFoundException");
+  loader_inflater_cls = loader_global_class(env, "java/util/zip/Inflater");
+  if (!loader_ctor || !loader_handle_field || !loader_not_found_cls || !loader_inflater_cls) {
+    (*env)->DeleteLocalRef(env, local);
+    return false;
+  }
+  loader_inflater_ctor = (*env)->GetMethodID(env, loader_inflater_cls, "<init>", "(Z)V");
+  loader_inflater_end = (*env)->GetMethodID(env, loader_inflater_cls, "end", "()V");
+  // the ByteBuffer overloads came with Java 11, stored entries load without them
+  loader_inflater_set_input = (*env)->GetMethodID(env, loader_inflater_cls, "setInput", "(Ljava/nio/ByteBuffer;)V");
+  loader_inflater_inflate = loader_inflater_set_input
+                            ? (*env)->GetMethodID(env, loader_inflater_cls, "inflate", "(Ljava/nio/ByteBuffer;)I")
+                            : null;
+  if (!loader_inflater_inflate) {
+    (*env)->ExceptionClear(env);
+    loader_inflater_set_input = null;
+  }
+  loader_cls = (*env)->NewGlobalRef(env, local);
+  (*env)->DeleteLocalRef(env, local);
+  return loader_inflater_ctor && loader_inflater_end;
+}
+
+static bool loader_init(JNIEnv* env) {
+  if (loader_cls) {
+    return true;
+  }
+  mud_mutex_lock(&loader_init_lock);
+  bool ok = loader_cls != null || loader_define_class(env);
+  mud_mutex_unlock(&loader_init_lock);
+  return ok;
+}
+
+struct Mud_Class_Loader_S* mud_loader_create(JNIEnv* env, jobject parent) {
+  mud_stat_transition();
+  if (!loader_init(env)) {
+    return null;
+  }
+  struct Mud_Class_Loader_S* loader = calloc(1, sizeof(struct Mud_Class_Loader_S));
+  if (!loader) {
+    return null;
+  }
+  loader->lock = (mud_mutex) MUD_MUTEX_INIT;
+  jobject system = null;
+  if (!parent) {
+    jclass classLoaderCls = (*env)->FindClass(env, "java/lang/ClassLoader");
+    jmethodID getSystemLoader = (*env)->GetStaticMethodID(env, classLoaderCls, "getSystemClassLoader", "()Ljava/lang/ClassLoader;");
+    parent = system = (*env)->CallStaticObjectMethod(env, classLoaderCls, getSystemLoader);
+    (*env)->DeleteLocalRef(env, classLoaderCls);
+  }
+  jobject local = (*env)->NewObject(env, loader_cls, loader_ctor, parent, (jlong) (intptr_t) loader);
+  loader->loader = local ? (*env)->NewGlobalRef(env, local) : null;
+  (*env)->DeleteLocalRef(env, local);
+  (*env)->DeleteLocalRef(env, system);
+  if (!loader->loader) {
+    free(loader);
+    return null;
+  }
+  mud_stat_add(global_refs_created, 1);
+  return loader;
+}
+
+// takes ownership of the jar's memory, which is released along with the loader even when it is not a readable jar
+static bool loader_add(struct Mud_Class_Loader_S* loader, Mud_Jar jar) {
+  mud_mutex_lock(&loader->lock);
+  Mud_Jar* jars = realloc(loader->jars, (loader->jar_count + 1) * sizeof(Mud_Jar));
+  if (!jars) {
+    mud_mutex_unlock(&loader->lock);
+    jar_unmap(&jar);
+    return false;
+  }
+  loader->jars = jars;
+  loader->jars[loader->jar_count] = jar;
+  bool ok = jar_index(loader, (uint32_t) loader->jar_count++);
+  mud_mutex_unlock(&loader->lock);
+  return ok;
+}
+
+bool mud_loader_add_jar(struct Mud_Class_Loader_S* loader, const char* path) {
+  mud_stat_transition();
+  Mud_Jar jar = {.data = null, .size = 0, .mapped = true};
+#ifdef _WIN32
+  HANDLE file = CreateFileA(path, GENERIC_READ, FILE_SHARE_READ, null, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, null);
+  LARGE_INTEGER size;
+  HANDLE mapping = null;
+  if (file != INVALID_HANDLE_VALUE && GetFileSizeEx(file, &size) && size.QuadPart > 0) {
+    mapping = CreateFileMappingA(file, null, PAGE_READONLY, 0, 0, null);
+    jar.size = (size_t) size.QuadPart;
+  }
+  // the view keeps the file mapped after both handles are closed
+  jar.data = mapping ? MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0) : null;
+  if (mapping) {
+    CloseHandle(mapping);
+  }
+  if (file != INVALID_HANDLE_VALUE) {
+    CloseHandle(file);
+  }
+#else
+  int fd = open(path, O_RDONLY);
+  struct stat st;
+  if (fd >= 0 && fstat(fd, &st) == 0 && st.st_size > 0) {
+    void* data = mmap(null, (size_t) st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    jar.data = data == MAP_FAILED ? null : data;
+    jar.size = (size_t) st.st_size;
+  }
+  if (fd >= 0) {
+    close(fd);
+  }
+#endif
+  return jar.data && loader_add(loader, jar);
+}
+
+bool mud_loader_add_jar_bytes(struct Mud_Class_Loader_S* loader, const uint8_t* bytes, size_t len) {
+  mud_stat_transition();
+  // copied since the caller's buffer may move or be freed while the loader lives
+  uint8_t* data = len ? malloc(len) : null;
+  if (!data) {
+    return false;
+  }
+  memcpy(data, bytes, len);
+  return loader_add(loader, (Mud_Jar) {.data = data, .size = len, .mapped = false});
+}
+
+// local ref to the java loader, null once the loader is closed
+static jobject loader_object(JNIEnv* env, struct Mud_Class_Loader_S* loader) {
+  mud_mutex_lock(&loader_lock);
+  jobject local = loader->loader ? (*env)->NewLocalRef(env, loader->loader) : null;
+  mud_mutex_unlock(&loader_lock);
+  if (local) {
+    mud_stat_add(local_refs_created, 1);
+  }
+  return local;
+}
+
+jobject mud_loader_object(JNIEnv* env, struct Mud_Class_Loader_S* loader) {
+  mud_stat_transition();
+  return loader_object(env, loader);
+}
+
+size_t mud_loader_class_count(struct Mud_Class_Loader_S* loader) {
+  mud_mutex_lock(&loader->lock);
+  size_t classes = loader->classes;
+  mud_mutex_unlock(&loader->lock);
+  return classes;
+}
+
+jclass mud_loader_load_class(JNIEnv* env, struct Mud_Class_Loader_S* loader, const char* className) {
+  mud_stat_transition();
+  // loadClass takes binary names
+  size_t len = strlen(className);
+  char* binary = malloc(len + 1);
+  if (!binary) {
+    return null;
+  }
+  for (size_t i = 0; i <= len; i++) {
+    binary[i] = className[i] == '/' ? '.' : className[i];
+  }
+  jstring name = (*env)->NewStringUTF(env, binary);
+  free(binary);
+  if (!name) {
+    return null;
+  }
+  mud_stat_add(local_refs_created, 1);
+  // a local ref, so the call holds the java loader even when the loader is closed meanwhile
+  jobject self = loader_object(env, loader);
+  jclass cls = self ? (*env)->CallObjectMethod(env, self, loader_load_class, name) : null;
+  (*env)->DeleteLocalRef(env, self);
+  (*env)->DeleteLocalRef(env, name);
+  // only a missing class is not an error, anything else raised while defining it stays pending
+  jthrowable ex = cls ? null : (*env)->ExceptionOccurred(env);
+  if (ex) {
+    // cleared while its class is checked, as JNI calls other than the exception ones may not run with one pending
+    (*env)->ExceptionClear(env);
+    if (!(*env)->IsInstanceOf(env, ex, loader_not_found_cls)) {
+      (*env)->Throw(env, ex);
+    }
+    (*env)->DeleteLocalRef(env, ex);
+  }
+  return cls;
+}
+
+void mud_loader_close(JNIEnv* env, struct Mud_Class_Loader_S* loader) {
+  mud_stat_transition();
+  mud_mutex_lock(&loader_lock);
+  // classes already defined keep working, the java loader finds no new ones
+  (*env)->SetLongField(env, loader->loader, loader_handle_field, 0);
+  jobject global = loader->loader;
+  loader->loader = null;
+  loader->closed = true;
+  bool idle = loader->users == 0;
+  mud_mutex_unlock(&loader_lock);
+  (*env)->DeleteGlobalRef(env, global);
+  mud_stat_add(global_refs_released, 1);
+  if (idle) {
+    loader_free(loader);
+  }
+}
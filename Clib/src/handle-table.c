@@ -0,0 +1,126 @@
+#include <stdint.h>
+#include "../include/mud.h"
+#include "stats.h"
+#include "sync-util.h"
+
+// Process wide table of global refs held by .NET. A handle id packs the slot's generation into the upper 32 bits
+// and the slot index + 1 into the lower 32 bits, the generation is bumped on release so stale ids are rejected.
+
+typedef struct Mud_Handle_Slot_S {
+  jobject obj;
+  uint32_t generation;
+  // index + 1 of the next free slot, 0 when this is the last one
+  uint32_t next_free;
+} Mud_Handle_Slot;
+
+static Mud_Handle_Slot* handle_slots = null;
+static uint32_t handle_slots_cap = 0;
+static uint32_t handle_slots_used = 0;
+static uint32_t handle_free_head = 0;
+static size_t handle_live = 0;
+static mud_mutex handle_lock = MUD_MUTEX_INIT;
+
+static Mud_Handle_Slot* handle_slot_of(uint64_t id) {
+  uint32_t index = (uint32_t) (id & 0xFFFFFFFF);
+  uint32_t generation = (uint32_t) (id >> 32);
+  if (index == 0 || index > handle_slots_used) {
+    return null;
+  }
+  Mud_Handle_Slot* slot = &handle_slots[index - 1];
+  if (slot->generation != generation || !slot->obj) {
+    return null;
+  }
+  return slot;
+}
+
+static bool handle_slots_grow(void) {
+  uint32_t cap = handle_slots_cap ? handle_slots_cap * 2 : 256;
+  Mud_Handle_Slot* slots = realloc(handle_slots, sizeof(Mud_Handle_Slot) * cap);
+  if (!slots) {
+    return false;
+  }
+  handle_slots = slots;
+  handle_slots_cap = cap;
+  return true;
+}
+
+struct Mud_Handle_S mud_handle_promote(JNIEnv* env, jobject local) {
+  mud_stat_transition();
+  struct Mud_Handle_S handle = {.id = 0, .obj = null};
+  if (!local) {
+    return handle;
+  }
+  jobject global = (*env)->NewGlobalRef(env, local);
+  (*env)->DeleteLocalRef(env, local);
+  mud_stat_add(local_refs_released, 1);
+  mud_stat_add(global_refs_created, 1);
+  if (!global) {
+    return handle;
+  }
+
+  mud_mutex_lock(&handle_lock);
+  uint32_t index;
+  if (handle_free_head) {
+    index = handle_free_head - 1;
+    handle_free_head = handle_slots[index].next_free;
+  } else {
+    if (handle_slots_used == handle_slots_cap && !handle_slots_grow()) {
+      mud_mutex_unlock(&handle_lock);
+      (*env)->DeleteGlobalRef(env, global);
+      mud_stat_add(global_refs_released, 1);
+      return handle;
+    }
+    index = handle_slots_used++;
+    handle_slots[index].generation = 1;
+  }
+  Mud_Handle_Slot* slot = &handle_slots[index];
+  slot->obj = global;
+  slot->next_free = 0;
+  handle_live++;
+  handle.id = ((uint64_t) slot->generation << 32) | (index + 1);
+  mud_mutex_unlock(&handle_lock);
+
+  handle.obj = global;
+  return handle;
+}
+
+jobject mud_handle_get(uint64_t id) {
+  mud_stat_transition();
+  mud_mutex_lock(&handle_lock);
+  Mud_Handle_Slot* slot = handle_slot_of(id);
+  jobject obj = slot ? slot->obj : null;
+  mud_mutex_unlock(&handle_lock);
+  return obj;
+}
+
+bool mud_handle_release(JNIEnv* env, uint64_t id) {
+  mud_stat_transition();
+  mud_mutex_lock(&handle_lock);
+  Mud_Handle_Slot* slot = handle_slot_of(id);
+  if (!slot) {
+    mud_mutex_unlock(&handle_lock);
+    return false;
+  }
+  jobject obj = slot->obj;
+  uint32_t index = (uint32_t) (slot - handle_slots);
+  slot->obj = null;
+  // generation 0 is never handed out so a wrapped counter can't revive an id from the first lap
+  if (++slot->generation == 0) {
+    slot->generation = 1;
+  }
+  slot->next_free = handle_free_head;
+  handle_free_head = index + 1;
+  handle_live--;
+  mud_mutex_unlock(&handle_lock);
+
+  (*env)->DeleteGlobalRef(env, obj);
+  mud_stat_add(global_refs_released, 1);
+  return true;
+}
+
+size_t mud_handle_count(void) {
+  mud_mutex_lock(&handle_lock);
+  size_t live = handle_live;
+  mud_mutex_unlock(&handle_lock);
+  return live;
+}
@@ -0,0 +1,178 @@
+#include <stdint.h>
+#include "../include/mud.h"
+#include "stats.h"
+#include "sync-util.h"
+
+// Process wide map from a java object to the token .NET registered the object's wrapper under, so an object returned
+// again maps back to the wrapper already bound to it. Objects are keyed by their identity hash with IsSameObject
+// resolving collisions, and held through weak global refs so the map never keeps one alive. Entries whose object was
+// collected are dropped whenever the table is rebuilt, .NET removes the entries of wrappers it collected.
+
+typedef struct Mud_Identity_Entry_S {
+  jweak obj;
+  jint hash;
+  uint64_t token;
+} Mud_Identity_Entry;
+
+static Mud_Identity_Entry* identity_entries = null;
+static size_t identity_cap = 0;
+static size_t identity_used = 0;
+static jclass identity_system_cls = null;
+static jmethodID identity_hash = null;
+static mud_mutex identity_lock = MUD_MUTEX_INIT;
+
+static bool identity_init(JNIEnv* env) {
+  if (identity_hash) {
+    return true;
+  }
+  mud_mutex_lock(&identity_lock);
+  if (!identity_hash) {
+    jclass local = (*env)->FindClass(env, "java/lang/System");
+    if (local) {
+      identity_system_cls = (*env)->NewGlobalRef(env, local);
+      (*env)->DeleteLocalRef(env, local);
+      identity_hash = (*env)->GetStaticMethodID(env, identity_system_cls, "identityHashCode", "(Ljava/lang/Object;)I");
+    }
+  }
+  mud_mutex_unlock(&identity_lock);
+  return identity_hash != null;
+}
+
+// index of the object's entry, or of the empty slot it would be inserted at
+static size_t identity_slot(JNIEnv* env, jobject obj, jint hash) {
+  size_t mask = identity_cap - 1;
+  for (size_t i = (uint32_t) hash & mask;; i = (i + 1) & mask) {
+    Mud_Identity_Entry* entry = &identity_entries[i];
+    if (!entry->obj || (entry->hash == hash && (*env)->IsSameObject(env, entry->obj, obj))) {
+      return i;
+    }
+  }
+}
+
+static void identity_insert(Mud_Identity_Entry* entries, size_t cap, Mud_Identity_Entry entry) {
+  size_t mask = cap - 1;
+  size_t i = (uint32_t) entry.hash & mask;
+  while (entries[i].obj) {
+    i = (i + 1) & mask;
+  }
+  entries[i] = entry;
+}
+
+static void identity_release(JNIEnv* env, Mud_Identity_Entry* entry) {
+  (*env)->DeleteWeakGlobalRef(env, entry->obj);
+  mud_stat_add(global_refs_released, 1);
+  memset(entry, 0, sizeof(Mud_Identity_Entry));
+}
+
+// removes the entry, shifting the entries probed past it back so none is cut off from its home slot
+static void identity_remove_at(JNIEnv* env, size_t i) {
+  identity_release(env, &identity_entries[i]);
+  identity_used--;
+  size_t mask = identity_cap - 1;
+  size_t hole = i;
+  for (size_t j = (i + 1) & mask; identity_entries[j].obj; j = (j + 1) & mask) {
+    size_t home = (uint32_t) identity_entries[j].hash & mask;
+    // the entry can fill the hole unless its home lies cyclically in (hole, j], its probe would then start past the hole
+    bool home_past_hole = hole < j ? home > hole && home <= j : home > hole || home <= j;
+    if (!home_past_hole) {
+      identity_entries[hole] = identity_entries[j];
+      memset(&identity_entries[j], 0, sizeof(Mud_Identity_Entry));
+      hole = j;
+    }
+  }
+}
+
+// drops the entries whose object was collected and moves the rest into a table at most a quarter full
+static bool identity_rebuild(JNIEnv* env) {
+  size_t live = 0;
+  for (size_t i = 0; i < identity_cap; i++) {
+    Mud_Identity_Entry* entry = &identity_entries[i];
+    if (!entry->obj) {
+      continue;
+    }
+    if ((*env)->IsSameObject(env, entry->obj, null)) {
+      identity_release(env, entry);
+    } else {
+      live++;
+    }
+  }
+  size_t cap = 64;
+  while (live * 4 > cap) {
+    cap *= 2;
+  }
+  Mud_Identity_Entry* entries = calloc(cap, sizeof(Mud_Identity_Entry));
+  if (!entries) {
+    identity_used = live;
+    return false;
+  }
+  for (size_t i = 0; i < identity_cap; i++) {
+    if (identity_entries[i].obj) {
+      identity_insert(entries, cap, identity_entries[i]);
+    }
+  }
+  free(identity_entries);
+  identity_entries = entries;
+  identity_cap = cap;
+  identity_used = live;
+  return true;
+}
+
+uint64_t mud_identity_get(JNIEnv* env, jobject obj, jint* hash) {
+  mud_stat_transition();
+  *hash = 0;
+  if (!obj || !identity_init(env)) {
+    return 0;
+  }
+  *hash = (*env)->CallStaticIntMethod(env, identity_system_cls, identity_hash, obj);
+
+  mud_mutex_lock(&identity_lock);
+  // the empty slot a missing object would take has a token of 0
+  uint64_t token = identity_cap ? identity_entries[identity_slot(env, obj, *hash)].token : 0;
+  mud_mutex_unlock(&identity_lock);
+  return token;
+}
+
+void mud_identity_put(JNIEnv* env, jobject obj, jint hash, uint64_t token) {
+  mud_stat_transition();
+  if (!obj || !token) {
+    return;
+  }
+  mud_mutex_lock(&identity_lock);
+  // kept at most half full so probes stay short
+  if ((identity_used + 1) * 2 > identity_cap && !identity_rebuild(env)) {
+    mud_mutex_unlock(&identity_lock);
+    return;
+  }
+  Mud_Identity_Entry* entry = &identity_entries[identity_slot(env, obj, hash)];
+  if (entry->obj) {
+    entry->token = token;
+  } else if ((entry->obj = (*env)->NewWeakGlobalRef(env, obj))) {
+    mud_stat_add(global_refs_created, 1);
+    entry->hash = hash;
+    entry->token = token;
+    identity_used++;
+  }
+  mud_mutex_unlock(&identity_lock);
+}
+
+void mud_identity_remove(JNIEnv* env, jint hash, uint64_t token) {
+  mud_stat_transition();
+  mud_mutex_lock(&identity_lock);
+  if (identity_cap) {
+    size_t mask = identity_cap - 1;
+    for (size_t i = (uint32_t) hash & mask; identity_entries[i].obj; i = (i + 1) & mask) {
+      if (identity_entries[i].token == token) {
+        identity_remove_at(env, i);
+        break;
+      }
+    }
+  }
+  mud_mutex_unlock(&identity_lock);
+}
+
+size_t mud_identity_count(void) {
+  mud_mutex_lock(&identity_lock);
+  size_t used = identity_used;
+  mud_mutex_unlock(&identity_lock);
+  return used;
+}
@@ -0,0 +1,110 @@
+#include "../include/mud.h"
+#include "box.h"
+#include "stats.h"
+#include "sync-util.h"
+
+// Chunked draining of java iterators, each chunk pulls up to max elements with a single transition from .NET.
+// Primitive chunks are unboxed straight into the caller's buffer, object chunks hand back local refs which the caller
+// releases all at once by popping the local frame it pushed for the chunk.
+
+static jmethodID iter_has_next = null;
+static jmethodID iter_next = null;
+static jclass iter_string_cls = null;
+static jclass iter_class_cast_cls = null;
+static mud_mutex iter_lock = MUD_MUTEX_INIT;
+
+static jclass iter_global_class(JNIEnv* env, const char* name) {
+  jclass local = (*env)->FindClass(env, name);
+  if (!local) {
+    return null;
+  }
+  jclass global = (*env)->NewGlobalRef(env, local);
+  (*env)->DeleteLocalRef(env, local);
+  return global;
+}
+
+static bool iter_init(JNIEnv* env) {
+  if (iter_next) {
+    return true;
+  }
+  if (!mud_box_init(env)) {
+    return false;
+  }
+  mud_mutex_lock(&iter_lock);
+  if (!iter_next) {
+    iter_string_cls = iter_string_cls ? iter_string_cls : iter_global_class(env, "java/lang/String");
+    iter_class_cast_cls = iter_class_cast_cls ? iter_class_cast_cls : iter_global_class(env, "java/lang/ClassCastException");
+    jclass iterCls = iter_string_cls && iter_class_cast_cls ? (*env)->FindClass(env, "java/util/Iterator") : null;
+    if (iterCls) {
+      iter_has_next = (*env)->GetMethodID(env, iterCls, "hasNext", "()Z");
+      // set last, it marks the cache as ready
+      iter_next = (*env)->GetMethodID(env, iterCls, "next", "()Ljava/lang/Object;");
+      (*env)->DeleteLocalRef(env, iterCls);
+    }
+  }
+  mud_mutex_unlock(&iter_lock);
+  return iter_next != null;
+}
+
+struct Mud_Chunk_S mud_iterator_next_chunk(JNIEnv* env, jobject iter, Java_Type type, size_t max, void* out) {
+  mud_stat_transition();
+  struct Mud_Chunk_S chunk = {.count = 0, .done = false, .exception = null};
+  if (!iter_init(env)) {
+    chunk.exception = mud_jvm_check_exception(env);
+    return chunk;
+  }
+  while (chunk.count < max) {
+    if (!(*env)->CallBooleanMethod(env, iter, iter_has_next)) {
+      chunk.done = !(*env)->ExceptionCheck(env);
+      break;
+    }
+    jobject elem = (*env)->CallObjectMethod(env, iter, iter_next);
+    if ((*env)->ExceptionCheck(env)) {
+      break;
+    }
+    if (type == Java_Object) {
+      ((jobject*) out)[chunk.count++] = elem;
+      continue;
+    }
+    bool unboxed = mud_unbox_into(env, elem, type, out, chunk.count);
+    (*env)->DeleteLocalRef(env, elem);
+    if (!unboxed) {
+      break;
+    }
+    chunk.count++;
+  }
+  chunk.exception = mud_jvm_check_exception(env);
+  if (type == Java_Object) {
+    mud_stat_add(local_refs_created, chunk.count);
+  }
+  return chunk;
+}
+
+size_t mud_strings_copy_utf16(JNIEnv* env, const jstring* strs, size_t count, jchar* buf, size_t capacity, jsize* lengths) {
+  mud_stat_transition();
+  if (!iter_init(env)) {
+    return 0;
+  }
+  size_t used = 0;
+  for (size_t i = 0; i < count; i++) {
+    if (!strs[i]) {
+      lengths[i] = -1;
+      continue;
+    }
+    // the strings come from java collections, which may hold anything
+    if (!(*env)->IsInstanceOf(env, strs[i], iter_string_cls)) {
+      lengths[i] = 0;
+      (*env)->ThrowNew(env, iter_class_cast_cls, "element is not a java.lang.String");
+      return i;
+    }
+    jsize len = (*env)->GetStringLength(env, strs[i]);
+    lengths[i] = len;
+    if (used + (size_t) len > capacity) {
+      return i;
+    }
+    (*env)->GetStringRegion(env, strs[i], 0, len, buf + used);
+    used += (size_t) len;
+    mud_stat_add(string_bytes, sizeof(jchar) * (size_t) len);
+  }
+  return count;
+}
@@ -1,7 +1,47 @@
 #ifndef _WIN32
 #include <unistd.h>
+#include <pthread.h>
+#else
+#include <windows.h>
 #endif
 #include "../include/mud.h"
+#include "stats.h"
+
+// thread local slot holding the JavaVM a thread was attached to, its destructor detaches the thread on exit
+#ifdef _WIN32
+static DWORD mud_thread_key = FLS_OUT_OF_INDEXES;
+static void NTAPI mud_thread_exit(PVOID jvm) {
+#else
+static pthread_key_t mud_thread_key;
+static pthread_once_t mud_thread_key_once = PTHREAD_ONCE_INIT;
+static void mud_thread_exit(void* jvm) {
+#endif
+  if (jvm) {
+    (*(JavaVM*) jvm)->DetachCurrentThread((JavaVM*) jvm);
+  }
+}
+
+#ifndef _WIN32
+static void mud_thread_key_create(void) {
+  pthread_key_create(&mud_thread_key, mud_thread_exit);
+}
+#endif
+
+static void mud_thread_key_set(JavaVM* jvm) {
+#ifdef _WIN32
+  FlsSetValue(mud_thread_key, jvm);
+#else
+  pthread_setspecific(mud_thread_key, jvm);
+#endif
+}
+
+static JavaVM* mud_thread_key_get(void) {
+#ifdef _WIN32
+  return (JavaVM*) FlsGetValue(mud_thread_key);
+#else
+  return (JavaVM*) pthread_getspecific(mud_thread_key);
+#endif
+}
 
 #ifdef __clang__
 #pragma clang diagnostic push
@@ -43,17 +83,18 @@ Java_JVM_Instance mud_jvm_create_instance(JavaVMOption* options, int amnt) {
 //  char* argsCpy = (char*) malloc(sizeof(char) * (argsLen + 1));
 //  strcpy(argsCpy, args);
   Java_JVM_Instance instance = {.env = malloc(sizeof(JNIEnv)), .jvm = malloc(sizeof(JavaVM))};
+#ifdef _WIN32
+  if (mud_thread_key == FLS_OUT_OF_INDEXES) {
+    mud_thread_key = FlsAlloc(mud_thread_exit);
+  }
+#else
+  pthread_once(&mud_thread_key_once, mud_thread_key_create);
+#endif
 //================== prepare loading of Java VM ============================
   JavaVMInitArgs vm_args;                        // Initialization arguments
   vm_args.options = options;
   vm_args.nOptions = amnt;                          // number of options
 
-  printf("Creating JVM with args:\n");
-  for (int i = 0; i < amnt; ++i) {
-    printf("\t`%s`\n", options[i].optionString);
-  }
-
-
 //  options[0].optionString = args;   // where to find java .cls
   vm_args.version = JNI_VERSION_1_8;             // minimum Java version
 
@@ -66,20 +107,15 @@ Java_JVM_Instance mud_jvm_create_instance(JavaVMOption* options, int amnt) {
   jint rc = JNI_CreateJavaVM(jvm, (void**) env, jvmArgs);  // YES !!
 //  options;    // we then no longer need the initialisation options.
   if (rc != JNI_OK) {
-    // TO DO: error processing...
-//    std::cin.get();
-//    if (mud_jvm_check_exception(env, *env));
-    exit(EXIT_FAILURE);
-  }
-  //=============== Display JVM version =======================================
-  jint ver = (*instance.env)->GetVersion(instance.env);
-  printf("JVM load succeeded: Version %i.%i\n", ((ver >> 16) & 0x0f), (ver & 0x0f));
-//  std::cout << "JVM load succeeded: Version ";
-//  std::cout << ((ver >> 16) & 0x0f) << "." << (ver & 0x0f) << std::endl;
+    // e.g. an unrecognized option or a class data archive that could not be mapped with -Xshare:on,
+    // the caller sees a null jvm rather than the process exiting
+    instance.jvm = null;
+    instance.env = null;
+  }
   return instance;
 }
 
-void mud_add_class_path(JNIEnv* env, const char* path) {
+bool mud_add_class_path(JNIEnv* env, const char* path) {
 //  char urlPath[2048];
 //  sprintf(urlPath, "file://%s", path);
 //  printf("Adding %s to the classpath\n", path);
@@ -90,6 +126,11 @@ void mud_add_class_path(JNIEnv* env, const char* path) {
 
   jmethodID getSystemClassLoaderMethod = (*env)->GetStaticMethodID(env, classLoaderCls, "getSystemClassLoader", "()Ljava/lang/ClassLoader;");
   jobject classLoaderInstance = (*env)->CallStaticObjectMethod(env, classLoaderCls, getSystemClassLoaderMethod);
+  // since Java 9 the system class loader is no URLClassLoader and has no addURL
+  if (!(*env)->IsInstanceOf(env, classLoaderInstance, urlClassLoaderCls)) {
+    (*env)->DeleteLocalRef(env, classLoaderInstance);
+    return false;
+  }
   jmethodID addUrlMethod = (*env)->GetMethodID(env, urlClassLoaderCls, "addURL", "(Ljava/net/URL;)V");
   jmethodID urlConstructor = (*env)->GetMethodID(env, urlCls, "<init>", "(Ljava/lang/String;)V");
   jstring urlPathStrObj = (*env)->NewStringUTF(env,  path);
@@ -97,17 +138,24 @@ void mud_add_class_path(JNIEnv* env, const char* path) {
   (*env)->CallVoidMethod(env, classLoaderInstance, addUrlMethod, urlInstance);
 //  mud_string_release(env, urlPathStrObj, urlPath);
 //  printf("Added %s to the classpath\n", path);
+  return true;
 }
 
 jclass mud_get_class(JNIEnv* env, const char* className) {
+  mud_stat_transition();
+  mud_stat_add(local_refs_created, 1);
   return (*env)->FindClass(env, className);
 }
 
  void mud_release_object(JNIEnv* env, jobject obj) {
+  mud_stat_transition();
+  mud_stat_add(local_refs_released, 1);
   (*env)->DeleteLocalRef(env, obj);
 }
 jobject mud_new_object(JNIEnv* env, jclass cls, const char* signature, const jvalue * args) {
-
+  mud_stat_transition();
+  mud_stat_add(method_lookups, 1);
+  mud_stat_add(local_refs_created, 1);
   jmethodID ctor = (*env)->GetMethodID(env, cls, "<init>", signature);  // FIND AN OBJECT CONSTRUCTOR
   if (!ctor) {
     printf("ERROR: constructor not found matching: %s !\n", signature);
@@ -123,10 +171,55 @@ jobject mud_new_object(JNIEnv* env, jclass cls, const char* signature, const jva
 
 void mud_jvm_destroy_instance(JavaVM* jvm) {
   (*jvm)->DestroyJavaVM(jvm);
-  printf("JVM destroyed\n");
+}
+
+JNIEnv* mud_jvm_get_env(JavaVM* jvm) {
+  JNIEnv* env = null;
+  if ((*jvm)->GetEnv(jvm, (void**) &env, JNI_VERSION_1_8) != JNI_OK) {
+    return null;
+  }
+  return env;
+}
+
+JNIEnv* mud_jvm_attach_thread(JavaVM* jvm, bool daemon) {
+  JNIEnv* env = mud_jvm_get_env(jvm);
+  // already attached, either by us or by whoever owns the thread, so leave its lifetime alone
+  if (env) {
+    return env;
+  }
+  jint rc = daemon ? (*jvm)->AttachCurrentThreadAsDaemon(jvm, (void**) &env, null)
+                   : (*jvm)->AttachCurrentThread(jvm, (void**) &env, null);
+  if (rc != JNI_OK) {
+    return null;
+  }
+  mud_thread_key_set(jvm);
+  return env;
+}
+
+bool mud_jvm_detach_thread(JavaVM* jvm) {
+  // only threads we attached are detached, threads owned by java or the host keep their attachment
+  if (mud_thread_key_get() != jvm) {
+    return false;
+  }
+  mud_thread_key_set(null);
+  return (*jvm)->DetachCurrentThread(jvm) == JNI_OK;
+}
+
+jobject mud_new_global_ref(JNIEnv* env, jobject obj) {
+  mud_stat_transition();
+  mud_stat_add(global_refs_created, 1);
+  return (*env)->NewGlobalRef(env, obj);
+}
+
+void mud_release_global_ref(JNIEnv* env, jobject obj) {
+  mud_stat_transition();
+  mud_stat_add(global_refs_released, 1);
+  (*env)->DeleteGlobalRef(env, obj);
 }
 
 jclass mud_get_class_of_obj(JNIEnv* env, jobject obj) {
+  mud_stat_transition();
+  mud_stat_add(local_refs_created, 1);
 //  printf("Getting cls for %p\n", obj);
   return (*env)->GetObjectClass(env, obj);
 }
@@ -151,26 +244,64 @@ jstring mud_string_new(JNIEnv *env, const char* msg) {
 //      .java_ptr = (*env)->NewStringUTF(env, msg),
 //      .char_ptr = newStr
 //  };
+  mud_stat_transition();
+  mud_stat_add(local_refs_created, 1);
+  mud_stat_add(string_bytes, strlen(msg));
   return (*env)->NewStringUTF(env, msg);
 }
+jstring mud_string_new_utf16(JNIEnv *env, const jchar* chars, jsize len) {
+  mud_stat_transition();
+  mud_stat_add(local_refs_created, 1);
+  mud_stat_add(string_bytes, sizeof(jchar) * len);
+  return (*env)->NewString(env, chars, len);
+}
+jsize mud_string_copy_utf16(JNIEnv *env, jstring str, jchar* buf, jsize capacity) {
+  mud_stat_transition();
+  jsize len = (*env)->GetStringLength(env, str);
+  if (len <= capacity) {
+    (*env)->GetStringRegion(env, str, 0, len, buf);
+    mud_stat_add(string_bytes, sizeof(jchar) * len);
+  }
+  return len;
+}
+
+static size_t mud_type_size(Java_Type type) {
+  if (type == Java_Bool || type == Java_Byte) {
+    return 1;
+  } else if (type == Java_Char || type == Java_Short) {
+    return 2;
+  } else if (type == Java_Int || type == Java_Float) {
+    return 4;
+  }
+  return 8;
+}
+
+static jarray array_new_primitive(JNIEnv *env, size_t size, const void* values, Java_Type type);
+
 jarray mud_array_new(JNIEnv *env, size_t size, jvalue* values, Java_Type type, jclass objCls) {
-#define ret_new_arr(type, field) ptr arr = (*env)->New##type##Array(env, size); (*env)->Set##type##ArrayRegion(env, arr, 0, size, (const j##field*) values); return arr;
+  mud_stat_transition();
+  mud_stat_add(local_refs_created, 1);
+// jvalue is 8 bytes wide, so the values need to be packed down to the element width before being copied into the array
+#define ret_new_arr(type, field, member) j##field* packed = malloc(sizeof(j##field) * size); \
+  for (size_t i = 0; i < size; ++i) { packed[i] = values[i].member; } \
+  mud_stat_add(array_bytes, sizeof(j##field) * size); \
+  jarray arr = array_new_primitive(env, size, packed, Java_##type); free(packed); return arr;
   if (type == Java_Bool) {
-    ret_new_arr(Boolean, boolean)
+    ret_new_arr(Bool, boolean, z)
   } else if (type == Java_Int) {
-    ret_new_arr(Int, int)
+    ret_new_arr(Int, int, i)
   } else if (type == Java_Long) {
-    ret_new_arr(Long, long)
+    ret_new_arr(Long, long, j)
   } else if (type == Java_Byte) {
-    ret_new_arr(Byte, byte)
+    ret_new_arr(Byte, byte, b)
   } else if (type == Java_Char) {
-    ret_new_arr(Char, char)
+    ret_new_arr(Char, char, c)
   } else if (type == Java_Short) {
-    ret_new_arr(Short, short)
+    ret_new_arr(Short, short, s)
   } else if (type == Java_Float) {
-    ret_new_arr(Float, float)
+    ret_new_arr(Float, float, f)
   } else if (type == Java_Double) {
-    ret_new_arr(Double, double)
+    ret_new_arr(Double, double, d)
   }
   jobjectArray arr = (*env)->NewObjectArray(env, size, objCls, null);
   for (jsize i = 0; i < size; ++i) {
@@ -179,13 +310,357 @@ jarray mud_array_new(JNIEnv *env, size_t size, jvalue* values, Java_Type type, j
   return arr;
 }
 
+static jarray array_new_primitive(JNIEnv *env, size_t size, const void* values, Java_Type type) {
+#define ret_new_prim_arr(name, field) ptr arr = (*env)->New##name##Array(env, size); \
+  if (arr && size) { (*env)->Set##name##ArrayRegion(env, arr, 0, size, (const j##field*) values); } return arr;
+  if (type == Java_Bool) {
+    ret_new_prim_arr(Boolean, boolean)
+  } else if (type == Java_Int) {
+    ret_new_prim_arr(Int, int)
+  } else if (type == Java_Long) {
+    ret_new_prim_arr(Long, long)
+  } else if (type == Java_Byte) {
+    ret_new_prim_arr(Byte, byte)
+  } else if (type == Java_Char) {
+    ret_new_prim_arr(Char, char)
+  } else if (type == Java_Short) {
+    ret_new_prim_arr(Short, short)
+  } else if (type == Java_Float) {
+    ret_new_prim_arr(Float, float)
+  } else if (type == Java_Double) {
+    ret_new_prim_arr(Double, double)
+  }
+  return null;
+}
+
+jarray mud_array_new_primitive(JNIEnv *env, size_t size, const void* values, Java_Type type) {
+  mud_stat_transition();
+  mud_stat_add(local_refs_created, 1);
+  mud_stat_add(array_bytes, mud_type_size(type) * size);
+  return array_new_primitive(env, size, values, type);
+}
+
+jthrowable mud_array_set_region(JNIEnv *env, jarray arr, size_t start, size_t len, const void* values, Java_Type type) {
+  mud_stat_transition();
+  mud_stat_add(array_bytes, mud_type_size(type) * len);
+#define set_region(name, field) (*env)->Set##name##ArrayRegion(env, arr, start, len, (const j##field*) values);
+  if (type == Java_Bool) {
+    set_region(Boolean, boolean)
+  } else if (type == Java_Int) {
+    set_region(Int, int)
+  } else if (type == Java_Long) {
+    set_region(Long, long)
+  } else if (type == Java_Byte) {
+    set_region(Byte, byte)
+  } else if (type == Java_Char) {
+    set_region(Char, char)
+  } else if (type == Java_Short) {
+    set_region(Short, short)
+  } else if (type == Java_Float) {
+    set_region(Float, float)
+  } else if (type == Java_Double) {
+    set_region(Double, double)
+  }
+  // out of range regions leave an ArrayIndexOutOfBoundsException pending
+  return mud_jvm_check_exception(env);
+}
+
+static void array_get_region(JNIEnv *env, jarray arr, size_t start, size_t len, void* values, Java_Type type) {
+#define get_region(name, field) (*env)->Get##name##ArrayRegion(env, arr, start, len, (j##field*) values);
+  if (type == Java_Bool) {
+    get_region(Boolean, boolean)
+  } else if (type == Java_Int) {
+    get_region(Int, int)
+  } else if (type == Java_Long) {
+    get_region(Long, long)
+  } else if (type == Java_Byte) {
+    get_region(Byte, byte)
+  } else if (type == Java_Char) {
+    get_region(Char, char)
+  } else if (type == Java_Short) {
+    get_region(Short, short)
+  } else if (type == Java_Float) {
+    get_region(Float, float)
+  } else if (type == Java_Double) {
+    get_region(Double, double)
+  }
+}
+
+jthrowable mud_array_get_region(JNIEnv *env, jarray arr, size_t start, size_t len, void* values, Java_Type type) {
+  mud_stat_transition();
+  mud_stat_add(array_bytes, mud_type_size(type) * len);
+  array_get_region(env, arr, start, len, values, type);
+  return mud_jvm_check_exception(env);
+}
+
+static char mud_type_descriptor(Java_Type type) {
+  switch (type) {
+    case Java_Bool: return 'Z';
+    case Java_Byte: return 'B';
+    case Java_Char: return 'C';
+    case Java_Short: return 'S';
+    case Java_Int: return 'I';
+    case Java_Long: return 'J';
+    case Java_Float: return 'F';
+    default: return 'D';
+  }
+}
+
+// class of a primitive array nested `depth` levels deep, e.g. [[D for doubles at depth 2
+static jclass mud_nested_array_class(JNIEnv* env, Java_Type type, size_t depth) {
+  char desc[MUD_ARRAY_MAX_RANK + 2];
+  memset(desc, '[', depth);
+  desc[depth] = mud_type_descriptor(type);
+  desc[depth + 1] = '\0';
+  return (*env)->FindClass(env, desc);
+}
+
+static void mud_throw(JNIEnv* env, const char* className, const char* msg) {
+  jclass cls = (*env)->FindClass(env, className);
+  if (cls) {
+    (*env)->ThrowNew(env, cls, msg);
+    (*env)->DeleteLocalRef(env, cls);
+  }
+}
+
+// classes[level] is the element class of the arrays at that level, rows of the innermost level are consumed from values
+static jobjectArray shaped_new_level(JNIEnv* env, size_t level, size_t rank, const size_t* dims, const jclass* classes,
+                                     const uint8_t** values, Java_Type type) {
+  jobjectArray arr = (*env)->NewObjectArray(env, (jsize) dims[level], classes[level], null);
+  for (size_t i = 0; arr && i < dims[level]; ++i) {
+    jarray row;
+    if (level + 2 == rank) {
+      row = array_new_primitive(env, dims[rank - 1], *values, type);
+      *values += mud_type_size(type) * dims[rank - 1];
+    } else {
+      row = shaped_new_level(env, level + 1, rank, dims, classes, values, type);
+    }
+    if (!row) {
+      (*env)->DeleteLocalRef(env, arr);
+      return null;
+    }
+    (*env)->SetObjectArrayElement(env, arr, (jsize) i, row);
+    (*env)->DeleteLocalRef(env, row);
+  }
+  return arr;
+}
+
+jarray mud_array_new_shaped(JNIEnv* env, size_t rank, const size_t* dims, const void* values, Java_Type type) {
+  if (rank == 0 || rank > MUD_ARRAY_MAX_RANK) {
+    return null;
+  }
+  mud_stat_transition();
+  mud_stat_add(local_refs_created, 1);
+  size_t count = 1;
+  for (size_t i = 0; i < rank; ++i) {
+    count *= dims[i];
+  }
+  mud_stat_add(array_bytes, mud_type_size(type) * count);
+  if (rank == 1) {
+    return array_new_primitive(env, dims[0], values, type);
+  }
+  jclass classes[MUD_ARRAY_MAX_RANK];
+  size_t found = 0;
+  for (; found < rank - 1; ++found) {
+    if (!(classes[found] = mud_nested_array_class(env, type, rank - 1 - found))) {
+      break;
+    }
+  }
+  const uint8_t* cursor = values;
+  jobjectArray arr = found == rank - 1 ? shaped_new_level(env, 0, rank, dims, classes, &cursor, type) : null;
+  for (size_t i = 0; i < found; ++i) {
+    (*env)->DeleteLocalRef(env, classes[i]);
+  }
+  return arr;
+}
+
+jthrowable mud_array_shape(JNIEnv* env, jobjectArray arr, size_t rank, size_t* dims) {
+  mud_stat_transition();
+  jobject level = arr;
+  for (size_t i = 0; i < rank; ++i) {
+    if (!level) {
+      mud_throw(env, "java/lang/NullPointerException", "Nested array is null");
+      break;
+    }
+    dims[i] = (size_t) (*env)->GetArrayLength(env, level);
+    jobject next = i + 1 < rank && dims[i] ? (*env)->GetObjectArrayElement(env, level, 0) : null;
+    if (level != arr) {
+      (*env)->DeleteLocalRef(env, level);
+    }
+    if (i + 1 < rank && !dims[i]) {
+      // an empty level leaves the dimensions below it empty as well
+      memset(dims + i + 1, 0, sizeof(size_t) * (rank - i - 1));
+      break;
+    }
+    level = next;
+  }
+  return mud_jvm_check_exception(env);
+}
+
+static bool shaped_get_level(JNIEnv* env, jobjectArray arr, size_t level, size_t rank, const size_t* dims,
+                             uint8_t** values, Java_Type type) {
+  if (!arr) {
+    mud_throw(env, "java/lang/NullPointerException", "Nested array is null");
+    return false;
+  }
+  if ((size_t) (*env)->GetArrayLength(env, arr) != dims[level]) {
+    mud_throw(env, "java/lang/IllegalArgumentException", "Nested array is not rectangular");
+    return false;
+  }
+  if (level + 1 == rank) {
+    array_get_region(env, arr, 0, dims[level], *values, type);
+    *values += mud_type_size(type) * dims[level];
+    return true;
+  }
+  for (size_t i = 0; i < dims[level]; ++i) {
+    jobject row = (*env)->GetObjectArrayElement(env, arr, (jsize) i);
+    bool ok = shaped_get_level(env, row, level + 1, rank, dims, values, type);
+    (*env)->DeleteLocalRef(env, row);
+    if (!ok) {
+      return false;
+    }
+  }
+  return true;
+}
+
+jthrowable mud_array_get_shaped(JNIEnv* env, jobjectArray arr, size_t rank, const size_t* dims, void* values, Java_Type type) {
+  mud_stat_transition();
+  size_t count = 1;
+  for (size_t i = 0; i < rank; ++i) {
+    count *= dims[i];
+  }
+  mud_stat_add(array_bytes, mud_type_size(type) * count);
+  uint8_t* cursor = values;
+  shaped_get_level(env, arr, 0, rank, dims, &cursor, type);
+  return mud_jvm_check_exception(env);
+}
+
+jobjectArray mud_array_new_jagged(JNIEnv* env, size_t rows, const int64_t* lengths, const void* values, Java_Type type) {
+  mud_stat_transition();
+  mud_stat_add(local_refs_created, 1);
+  jclass rowCls = mud_nested_array_class(env, type, 1);
+  jobjectArray arr = rowCls ? (*env)->NewObjectArray(env, (jsize) rows, rowCls, null) : null;
+  if (rowCls) {
+    (*env)->DeleteLocalRef(env, rowCls);
+  }
+  const uint8_t* cursor = values;
+  for (size_t i = 0; arr && i < rows; ++i) {
+    if (lengths[i] < 0) {
+      continue;
+    }
+    jarray row = array_new_primitive(env, (size_t) lengths[i], cursor, type);
+    if (!row) {
+      (*env)->DeleteLocalRef(env, arr);
+      return null;
+    }
+    cursor += mud_type_size(type) * (size_t) lengths[i];
+    (*env)->SetObjectArrayElement(env, arr, (jsize) i, row);
+    (*env)->DeleteLocalRef(env, row);
+  }
+  mud_stat_add(array_bytes, (uint64_t) (cursor - (const uint8_t*) values));
+  return arr;
+}
+
+jthrowable mud_array_jagged_lengths(JNIEnv* env, jobjectArray arr, size_t rows, int64_t* lengths) {
+  mud_stat_transition();
+  for (size_t i = 0; i < rows; ++i) {
+    jobject row = (*env)->GetObjectArrayElement(env, arr, (jsize) i);
+    lengths[i] = row ? (*env)->GetArrayLength(env, row) : -1;
+    (*env)->DeleteLocalRef(env, row);
+  }
+  return mud_jvm_check_exception(env);
+}
+
+jthrowable mud_array_get_jagged(JNIEnv* env, jobjectArray arr, size_t rows, const int64_t* lengths, void* values,
+                                Java_Type type) {
+  mud_stat_transition();
+  uint8_t* cursor = values;
+  for (size_t i = 0; i < rows; ++i) {
+    jobject row = (*env)->GetObjectArrayElement(env, arr, (jsize) i);
+    // rows swapped by java since the lengths were read would no longer fit the buffer
+    if ((row ? (*env)->GetArrayLength(env, row) : -1) != lengths[i]) {
+      (*env)->DeleteLocalRef(env, row);
+      mud_throw(env, "java/util/ConcurrentModificationException", "Nested array changed while being read");
+      break;
+    }
+    if (row) {
+      array_get_region(env, row, 0, (size_t) lengths[i], cursor, type);
+      cursor += mud_type_size(type) * (size_t) lengths[i];
+      (*env)->DeleteLocalRef(env, row);
+    }
+  }
+  mud_stat_add(array_bytes, (uint64_t) (cursor - (uint8_t*) values));
+  return mud_jvm_check_exception(env);
+}
+
+ptr mud_array_pin(JNIEnv *env, jarray arr, Java_Type type, bool critical, bool* isCopy) {
+  mud_stat_transition();
+  jboolean copied = JNI_FALSE;
+  ptr elems = null;
+#define pin_elems(name, field) elems = (*env)->Get##name##ArrayElements(env, (j##field##Array) arr, &copied);
+  if (critical) {
+    elems = (*env)->GetPrimitiveArrayCritical(env, arr, &copied);
+  } else if (type == Java_Bool) {
+    pin_elems(Boolean, boolean)
+  } else if (type == Java_Int) {
+    pin_elems(Int, int)
+  } else if (type == Java_Long) {
+    pin_elems(Long, long)
+  } else if (type == Java_Byte) {
+    pin_elems(Byte, byte)
+  } else if (type == Java_Char) {
+    pin_elems(Char, char)
+  } else if (type == Java_Short) {
+    pin_elems(Short, short)
+  } else if (type == Java_Float) {
+    pin_elems(Float, float)
+  } else if (type == Java_Double) {
+    pin_elems(Double, double)
+  }
+  if (isCopy) {
+    *isCopy = copied;
+  }
+  return elems;
+}
+
+void mud_array_unpin(JNIEnv *env, jarray arr, ptr elems, Java_Type type, bool critical, Java_Release_Mode mode) {
+#define unpin_elems(name, field) (*env)->Release##name##ArrayElements(env, (j##field##Array) arr, (j##field*) elems, mode);
+  mud_stat_transition();
+  if (!elems) {
+    return;
+  }
+  if (critical) {
+    (*env)->ReleasePrimitiveArrayCritical(env, arr, elems, mode);
+  } else if (type == Java_Bool) {
+    unpin_elems(Boolean, boolean)
+  } else if (type == Java_Int) {
+    unpin_elems(Int, int)
+  } else if (type == Java_Long) {
+    unpin_elems(Long, long)
+  } else if (type == Java_Byte) {
+    unpin_elems(Byte, byte)
+  } else if (type == Java_Char) {
+    unpin_elems(Char, char)
+  } else if (type == Java_Short) {
+    unpin_elems(Short, short)
+  } else if (type == Java_Float) {
+    unpin_elems(Float, float)
+  } else if (type == Java_Double) {
+    unpin_elems(Double, double)
+  }
+}
+
 jmethodID mud_get_method(JNIEnv* env, jclass cls, const char* methodName, const char* signature) {
+  mud_stat_transition();
+  mud_stat_add(method_lookups, 1);
   return (*env)->GetMethodID(env, cls,
                              methodName,
                              signature);
 }
 
 jmethodID mud_get_static_method(JNIEnv* env, jclass cls, const char* methodName, const char* signature) {
+  mud_stat_transition();
+  mud_stat_add(method_lookups, 1);
 
 //  printf("Getting static method %s with type signature %s in class %p \n", methodName, signature, cls);
 
@@ -194,17 +669,47 @@ jmethodID mud_get_static_method(JNIEnv* env, jclass cls, const char* methodName,
                                    signature);
 }
 
+// runs the call through mud_call_handler while keeping the call counters
+static struct JavaCallResp_S mud_call_counted(JNIEnv* env, ptr objOrCls, jmethodID method, const jvalue* args, Java_Type type, bool isStatic) {
+  struct Mud_Stats_S* stats = mud_stats();
+  const bool timed = mud_stats_timing;
+  const uint64_t start = timed ? mud_stats_now_ns() : 0;
+  struct JavaCallResp_S resp = mud_call_handler(env, objOrCls, method, args, type, isStatic);
+  if (timed) {
+    mud_stats_record_latency(mud_stats_now_ns() - start);
+  }
+  stats->calls_by_type[type <= Java_Void ? type : Java_Object]++;
+  // exceptions themselves are counted by mud_jvm_check_exception
+  if (resp.is_exception || (type == Java_Object && resp.value.l)) {
+    stats->local_refs_created++;
+  }
+  return resp;
+}
+
 struct JavaCallResp_S mud_call_static_method(JNIEnv* env, jclass cls, jmethodID method, Java_Type type, const jvalue* args) {
-  struct JavaCallResp_S resp = mud_call_handler(env, cls, method, args, type, true);
+  mud_stat_transition();
+  struct JavaCallResp_S resp = mud_call_counted(env, cls, method, args, type, true);
 //  printf("StatucResp: {.ex: _%i_; .vd: _%i_; .val: {.l: _%p_};}\n", resp.is_exception, resp.is_void, resp.value.l);
   return resp;
 }
 
 struct JavaCallResp_S mud_call_method(JNIEnv* env, jobject obj, jmethodID method, Java_Type type, const jvalue* args) {
-  struct JavaCallResp_S resp = mud_call_handler(env, obj, method, args, type, false);
+  mud_stat_transition();
+  struct JavaCallResp_S resp = mud_call_counted(env, obj, method, args, type, false);
 //  printf("MethodResp[%p]: {.ex: _%i_; .vd: _%i_; .val: {.l: _%p_};}\n", method, resp.is_exception, resp.is_void, resp.value.l);
   return resp;
 }
+size_t mud_call_batch(JNIEnv* env, const struct Mud_Batch_Call_S* calls, size_t count, const jvalue* args, struct JavaCallResp_S* results) {
+  mud_stat_transition();
+  for (size_t i = 0; i < count; i++) {
+    const struct Mud_Batch_Call_S* call = &calls[i];
+    results[i] = mud_call_counted(env, call->obj_or_cls, call->method, args + call->arg_offset, call->type, call->is_static);
+    if (results[i].is_exception) {
+      return i + 1;
+    }
+  }
+  return count;
+}
 void reprint_str_test(const char* jstr) {
   printf("reprintg: `%s`\n", jstr);
 }
@@ -219,38 +724,139 @@ char* mud_jstring_to_string(JNIEnv* env, jstring jstr) {
   return copyStr;
 }
 jfieldID mud_get_static_field_id(JNIEnv* env, jclass cls, const char* field, const char* signature) {
+  mud_stat_transition();
+  mud_stat_add(field_lookups, 1);
   jfieldID fieldId = (*env)->GetStaticFieldID(env, cls, field, signature);
 //  printf("Getting static field: [%p] `%s`:`%s`:%p\n", cls, field, signature, fieldId);
   return fieldId;
 }
 jfieldID mud_get_field_id(JNIEnv* env, jclass cls, const char* field, const char* signature) {
+  mud_stat_transition();
+  mud_stat_add(field_lookups, 1);
   return (*env)->GetFieldID(env, cls, field, signature);
 }
 
 jvalue mud_get_field_value(JNIEnv* env, jobject cls, jfieldID field, Java_Type type) {
+  mud_stat_transition();
   return mud_get_field_handler(env, cls, field, type, false);
 }
 void mud_set_field_value(JNIEnv* env, jobject cls, jfieldID field, Java_Type type, jvalue value) {
+  mud_stat_transition();
   mud_set_field_handler(env, cls, field, type, value, false);
 }
 
 jvalue mud_get_static_field_value(JNIEnv* env, jclass cls, jfieldID field, Java_Type type) {
+  mud_stat_transition();
   return mud_get_field_handler(env, cls, field, type, true);
 }
 
 void mud_set_static_field_value(JNIEnv* env, jobject cls, jfieldID field, Java_Type type, jvalue value) {
+  mud_stat_transition();
   mud_set_field_handler(env, cls, field, type, value, true);
 }
 
+jthrowable mud_get_fields_bulk(JNIEnv* env, const jobject* objs, size_t count, const struct Mud_Field_Layout_S* fields,
+                               size_t fieldCount, void* records, size_t stride) {
+  mud_stat_transition();
+#define get_bulk(name, jtype) *(jtype*) dest = (*env)->Get##name##Field(env, objs[i], field->field);
+  for (size_t i = 0; i < count; i++) {
+    if (!objs[i]) {
+      mud_throw(env, "java/lang/NullPointerException", "cannot read the fields of a null object");
+      break;
+    }
+    char* record = (char*) records + i * stride;
+    for (size_t f = 0; f < fieldCount; f++) {
+      const struct Mud_Field_Layout_S* field = &fields[f];
+      void* dest = record + field->offset;
+      if (field->type == Java_Bool) {
+        get_bulk(Boolean, jboolean)
+      } else if (field->type == Java_Int) {
+        get_bulk(Int, jint)
+      } else if (field->type == Java_Long) {
+        get_bulk(Long, jlong)
+      } else if (field->type == Java_Byte) {
+        get_bulk(Byte, jbyte)
+      } else if (field->type == Java_Char) {
+        get_bulk(Char, jchar)
+      } else if (field->type == Java_Short) {
+        get_bulk(Short, jshort)
+      } else if (field->type == Java_Float) {
+        get_bulk(Float, jfloat)
+      } else {
+        get_bulk(Double, jdouble)
+      }
+    }
+  }
+  return mud_jvm_check_exception(env);
+}
+
+jthrowable mud_set_fields_bulk(JNIEnv* env, const jobject* objs, size_t count, const struct Mud_Field_Layout_S* fields,
+                               size_t fieldCount, const void* records, size_t stride) {
+  mud_stat_transition();
+#define set_bulk(name, jtype) (*env)->Set##name##Field(env, objs[i], field->field, *(const jtype*) src);
+  for (size_t i = 0; i < count; i++) {
+    if (!objs[i]) {
+      mud_throw(env, "java/lang/NullPointerException", "cannot write the fields of a null object");
+      break;
+    }
+    const char* record = (const char*) records + i * stride;
+    for (size_t f = 0; f < fieldCount; f++) {
+      const struct Mud_Field_Layout_S* field = &fields[f];
+      const void* src = record + field->offset;
+      if (field->type == Java_Bool) {
+        set_bulk(Boolean, jboolean)
+      } else if (field->type == Java_Int) {
+        set_bulk(Int, jint)
+      } else if (field->type == Java_Long) {
+        set_bulk(Long, jlong)
+      } else if (field->type == Java_Byte) {
+        set_bulk(Byte, jbyte)
+      } else if (field->type == Java_Char) {
+        set_bulk(Char, jchar)
+      } else if (field->type == Java_Short) {
+        set_bulk(Short, jshort)
+      } else if (field->type == Java_Float) {
+        set_bulk(Float, jfloat)
+      } else {
+        set_bulk(Double, jdouble)
+      }
+    }
+  }
+  return mud_jvm_check_exception(env);
+}
+
 bool mud_instance_of(JNIEnv* env, jobject obj, jclass cls) {
+  mud_stat_transition();
   return (*env)->IsInstanceOf(env, obj, cls);
 }
 
+bool mud_is_assignable_from(JNIEnv* env, jclass sub, jclass sup) {
+  mud_stat_transition();
+  return (*env)->IsAssignableFrom(env, sub, sup);
+}
+
+bool mud_push_local_frame(JNIEnv* env, jint capacity) {
+  mud_stat_transition();
+  return (*env)->PushLocalFrame(env, capacity) == JNI_OK;
+}
+
+jobject mud_pop_local_frame(JNIEnv* env, jobject keep) {
+  mud_stat_transition();
+  return (*env)->PopLocalFrame(env, keep);
+}
+
+bool mud_is_same_object(JNIEnv* env, jobject a, jobject b) {
+  mud_stat_transition();
+  return (*env)->IsSameObject(env, a, b);
+}
+
 size_t mud_array_length(JNIEnv* env, jarray arr) {
+  mud_stat_transition();
   return (*env)->GetArrayLength(env, arr);
 }
 
 jvalue mud_array_get_at(JNIEnv* env, jarray arr, int index, Java_Type type) {
+  mud_stat_transition();
 #define retGetMap(name, jtype) jtype val; (*env)->Get##name##ArrayRegion(env, arr, index, 1, &val); return map_value(type, &val);
   if (type == Java_Bool) {
     retGetMap(Boolean, jboolean)
@@ -269,6 +875,7 @@ jvalue mud_array_get_at(JNIEnv* env, jarray arr, int index, Java_Type type) {
   } else if (type == Java_Double) {
     retGetMap(Double, jdouble)
   } else {
+   mud_stat_add(local_refs_created, 1);
    return (jvalue) {
        .l = (*env)->GetObjectArrayElement(env, arr, index)
    };
@@ -284,6 +891,7 @@ jthrowable mud_jvm_check_exception(JNIEnv* env) {
     return null;
   }
   jthrowable ex = (*env)->ExceptionOccurred(env);
+  mud_stat_add(exceptions, 1);
 //  printf("[Exception]:\n");
 //  (*env)->ExceptionDescribe(env);
 //  puts("--------");
@@ -291,109 +899,6 @@ jthrowable mud_jvm_check_exception(JNIEnv* env) {
   return ex;
 }
 
-#ifdef __clang__
-#pragma clang diagnostic push
-#pragma ide diagnostic ignored "misc-no-recursion"
-#endif
-char* mud_get_exception_msg(JNIEnv* env, jthrowable ex, jmethodID getCauseMethod, jmethodID  getStackMethod, jmethodID exToStringMethod, jmethodID frameToStringMethod,
-                            bool isTop) {
-
-  char msg[2048];
-  memset(msg, 0, 2048);
-
-// Get the array of StackTraceElements.
-  jobjectArray frames =
-      (jobjectArray) (*env)->CallObjectMethod(env,
-                                              ex,
-                                              getStackMethod);
-  jsize frames_length = (*env)->GetArrayLength(env, frames);
-
-  // Add Throwable.toString() before descending
-  // stack trace messages.
-  size_t len = strlen(msg);
-  if (0 != frames)
-  {
-    jstring msg_obj =
-        (jstring) (*env)->CallObjectMethod(env, ex,
-                                           exToStringMethod);
-    const char* exMsgStr = (*env)->GetStringUTFChars(env, msg_obj, 0);
-    const size_t exMsgStrLen = strlen(exMsgStr);
-
-    // If this is not the top-of-the-trace then
-    // this is a cause.
-    if (isTop)
-    {
-      const char* causedByMsg = "Caused by: ";
-      const size_t causedByMsgLen = strlen(causedByMsg);
-      memcpy(msg + (sizeof(char) * len), causedByMsg, causedByMsgLen);
-      len += causedByMsgLen;
-    }
-    memcpy(msg + (sizeof(char) * len), exMsgStr, exMsgStrLen);
-
-    (*env)->ReleaseStringUTFChars(env, msg_obj, exMsgStr);
-    (*env)->DeleteLocalRef(env, msg_obj);
-    len += exMsgStrLen;
-  }
-
-  // Append stack trace messages if there are any.
-//  printf("Frames: %i\n", frames_length);
-  if (frames_length > 0)
-  {
-    jsize i;
-    for (i = 0; i < frames_length; i++)
-    {
-      // Get the string returned from the 'toString()'
-      // method of the next frame and append it to
-      // the error message.
-      jobject frame = (*env)->GetObjectArrayElement(env, frames, i);
-      jstring msg_obj =
-          (jstring) (*env)->CallObjectMethod(env, frame, frameToStringMethod);
-
-      const char* msg_str = (*env)->GetStringUTFChars(env, msg_obj, 0);
-//      printf("msg_str: `%s`\n", msg_str);
-      const char* indentMsg = "\n    ";
-      const size_t indentMsgLen = 5;
-      memcpy(msg + (sizeof(char) * len), indentMsg, indentMsgLen);
-      len += indentMsgLen;
-      const size_t msgStrLen = strlen(msg_str);
-      memcpy(msg + len, msg_str, msgStrLen);
-      len += msgStrLen;
-//      printf("msg: `%s`_____\n", msg);
-      (*env)->ReleaseStringUTFChars(env, msg_obj, msg_str);
-      (*env)->DeleteLocalRef(env, msg_obj);
-      (*env)->DeleteLocalRef(env, frame);
-    }
-  }
-
-  // If 'ex' has a cause then append the
-  // stack trace messages from the cause.
-  if (0 != frames)
-  {
-    jthrowable cause =
-        (jthrowable) (*env)->CallObjectMethod(env,
-                                              ex,
-                                              getCauseMethod);
-    if (0 != cause)
-    {
-      char* subFrameMsg = mud_get_exception_msg(env,
-                                                cause,
-                                                getCauseMethod,
-                                                getStackMethod,
-                                                exToStringMethod,
-                                                frameToStringMethod, false);
-      const size_t subFrameMsgLen = strlen(subFrameMsg);
-      memcpy(msg + (sizeof(char) * len), subFrameMsg, subFrameMsgLen);
-      len += subFrameMsgLen;
-      free(subFrameMsg);
-    }
-  }
-  char* finalMsg = malloc(sizeof(char) * len + 1);
-  memcpy(finalMsg, msg, len);
-  finalMsg[len] = '\0';
-  return finalMsg;
-}
 #ifdef __clang__
 #pragma clang diagnostic pop
-#pragma clang diagnostic pop
-
-#endif
\ No newline at end of file
+#endif
@@ -0,0 +1,208 @@
+#include "../include/mud.h"
+#include "stats.h"
+#include "sync-util.h"
+
+// Ring buffers shared between .NET and java. One side produces and the other consumes, both move the head and tail
+// words straight in the shared memory so messages cross without copies or JNI calls. Only a side that finds the ring
+// empty (or full) and wants to block comes through here, and the other side signals it once it sees the waiters word set.
+
+// class file of
+//   public final class mud.NativeRing {
+//     public static native long awaitReadable(long ring, long timeoutNanos);
+//     public static native long awaitWritable(long ring, int bytes, long timeoutNanos);
+//     public static native void signal(long ring);
+//   }
+static const unsigned char ring_class_bytes[] = {
+  0xca, 0xfe, 0xba, 0xbe, 0x00, 0x00, 0x00, 0x34, 0x00, 0x0b, 0x01, 0x00, 0x0e, 0x6d, 0x75, 0x64,
+  0x2f, 0x4e, 0x61, 0x74, 0x69, 0x76, 0x65, 0x52, 0x69, 0x6e, 0x67, 0x07, 0x00, 0x01, 0x01, 0x00,
+  0x10, 0x6a, 0x61, 0x76, 0x61, 0x2f, 0x6c, 0x61, 0x6e, 0x67, 0x2f, 0x4f, 0x62, 0x6a, 0x65, 0x63,
+  0x74, 0x07, 0x00, 0x03, 0x01, 0x00, 0x0d, 0x61, 0x77, 0x61, 0x69, 0x74, 0x52, 0x65, 0x61, 0x64,
+  0x61, 0x62, 0x6c, 0x65, 0x01, 0x00, 0x05, 0x28, 0x4a, 0x4a, 0x29, 0x4a, 0x01, 0x00, 0x0d, 0x61,
+  0x77, 0x61, 0x69, 0x74, 0x57, 0x72, 0x69, 0x74, 0x61, 0x62, 0x6c, 0x65, 0x01, 0x00, 0x06, 0x28,
+  0x4a, 0x49, 0x4a, 0x29, 0x4a, 0x01, 0x00, 0x06, 0x73, 0x69, 0x67, 0x6e, 0x61, 0x6c, 0x01, 0x00,
+  0x04, 0x28, 0x4a, 0x29, 0x56, 0x00, 0x31, 0x00, 0x02, 0x00, 0x04, 0x00, 0x00, 0x00, 0x00, 0x00,
+  0x03, 0x01, 0x09, 0x00, 0x05, 0x00, 0x06, 0x00, 0x00, 0x01, 0x09, 0x00, 0x07, 0x00, 0x08, 0x00,
+  0x00, 0x01, 0x09, 0x00, 0x09, 0x00, 0x0a, 0x00, 0x00, 0x00, 0x00,
+};
+
+struct Mud_Ring_S {
+  uint8_t* memory;
+  uint64_t capacity;
+  mud_mutex lock;
+  mud_cond cond;
+};
+
+static jclass ring_cls = null;
+static mud_mutex ring_init_lock = MUD_MUTEX_INIT;
+
+static inline uint64_t ring_word(const struct Mud_Ring_S* ring, size_t offset) {
+  return mud_atomic_load_u64((uint64_t*) (ring->memory + offset));
+}
+
+static inline uint64_t ring_readable(const struct Mud_Ring_S* ring) {
+  return ring_word(ring, MUD_RING_HEAD_OFFSET) - ring_word(ring, MUD_RING_TAIL_OFFSET);
+}
+
+static inline uint64_t ring_writable(const struct Mud_Ring_S* ring) {
+  return ring->capacity - ring_readable(ring);
+}
+
+struct Mud_Ring_S* mud_ring_create(uint64_t capacity) {
+  if (capacity == 0 || (capacity & (capacity - 1)) != 0) {
+    return null;
+  }
+  struct Mud_Ring_S* ring = malloc(sizeof(struct Mud_Ring_S));
+  if (!ring) {
+    return null;
+  }
+  // cache line aligned so the header words never share a line
+  size_t size = MUD_RING_HEADER_SIZE + (size_t) capacity;
+#ifdef _WIN32
+  ring->memory = _aligned_malloc(size, 64);
+#else
+  if (posix_memalign((void**) &ring->memory, 64, size) != 0) {
+    ring->memory = null;
+  }
+#endif
+  if (!ring->memory) {
+    free(ring);
+    return null;
+  }
+  memset(ring->memory, 0, MUD_RING_HEADER_SIZE);
+  *(uint64_t*) (ring->memory + MUD_RING_CAPACITY_OFFSET) = capacity;
+  ring->capacity = capacity;
+  ring->lock = (mud_mutex) MUD_MUTEX_INIT;
+  mud_cond_init(&ring->cond);
+  return ring;
+}
+
+void mud_ring_destroy(struct Mud_Ring_S* ring) {
+  if (!ring) {
+    return;
+  }
+  mud_cond_destroy(&ring->cond);
+  mud_mutex_destroy(&ring->lock);
+#ifdef _WIN32
+  _aligned_free(ring->memory);
+#else
+  free(ring->memory);
+#endif
+  free(ring);
+}
+
+uint8_t* mud_ring_memory(struct Mud_Ring_S* ring) {
+  return ring->memory;
+}
+
+jobject mud_ring_buffer(JNIEnv* env, struct Mud_Ring_S* ring) {
+  mud_stat_transition();
+  return (*env)->NewDirectByteBuffer(env, ring->memory, (jlong) (MUD_RING_HEADER_SIZE + ring->capacity));
+}
+
+// blocks until ready returns at least min, the waiters word is raised before ready is checked under the lock so a side
+// publishing in between either sees it and signals or has published before the check
+static uint64_t ring_await(struct Mud_Ring_S* ring, uint64_t (*ready)(const struct Mud_Ring_S*), uint64_t min,
+                           int64_t timeout_ns) {
+  uint64_t available = ready(ring);
+  if (available >= min || timeout_ns == 0) {
+    return available;
+  }
+  uint64_t* waiters = (uint64_t*) (ring->memory + MUD_RING_WAITERS_OFFSET);
+  uint64_t deadline = timeout_ns < 0 ? 0 : mud_stats_now_ns() + (uint64_t) timeout_ns;
+  mud_mutex_lock(&ring->lock);
+  mud_atomic_add_u64(waiters, 1);
+  while ((available = ready(ring)) < min) {
+    int64_t remaining = -1;
+    if (timeout_ns > 0) {
+      uint64_t now = mud_stats_now_ns();
+      if (now >= deadline) {
+        break;
+      }
+      remaining = (int64_t) (deadline - now);
+    }
+    mud_cond_wait(&ring->cond, &ring->lock, remaining);
+  }
+  mud_atomic_add_u64(waiters, (uint64_t) -1);
+  mud_mutex_unlock(&ring->lock);
+  return available;
+}
+
+uint64_t mud_ring_await_readable(struct Mud_Ring_S* ring, int64_t timeout_ns) {
+  return ring_await(ring, ring_readable, 1, timeout_ns);
+}
+
+uint64_t mud_ring_await_writable(struct Mud_Ring_S* ring, uint64_t bytes, int64_t timeout_ns) {
+  return ring_await(ring, ring_writable, bytes, timeout_ns);
+}
+
+void mud_ring_signal(struct Mud_Ring_S* ring) {
+  mud_mutex_lock(&ring->lock);
+  mud_cond_broadcast(&ring->cond);
+  mud_mutex_unlock(&ring->lock);
+}
+
+static jlong JNICALL ring_java_await_readable(JNIEnv* env, jclass cls, jlong ring, jlong timeout_ns) {
+  (void) env;
+  (void) cls;
+  return (jlong) mud_ring_await_readable((struct Mud_Ring_S*) (intptr_t) ring, timeout_ns);
+}
+
+static jlong JNICALL ring_java_await_writable(JNIEnv* env, jclass cls, jlong ring, jint bytes, jlong timeout_ns) {
+  (void) cls;
+  // a negative amount would wrap to more than the ring can ever hold and block forever
+  if (bytes < 0) {
+    jclass argEx = (*env)->FindClass(env, "java/lang/IllegalArgumentException");
+    if (argEx) {
+      (*env)->ThrowNew(env, argEx, "bytes must not be negative");
+      (*env)->DeleteLocalRef(env, argEx);
+    }
+    return 0;
+  }
+  return (jlong) mud_ring_await_writable((struct Mud_Ring_S*) (intptr_t) ring, (uint64_t) bytes, timeout_ns);
+}
+
+static void JNICALL ring_java_signal(JNIEnv* env, jclass cls, jlong ring) {
+  (void) env;
+  (void) cls;
+  mud_ring_signal((struct Mud_Ring_S*) (intptr_t) ring);
+}
+
+static bool ring_define_class(JNIEnv* env) {
+  // defined into the system class loader so java code anywhere can link against it
+  jclass loaderCls = (*env)->FindClass(env, "java/lang/ClassLoader");
+  if (!loaderCls) {
+    return false;
+  }
+  jmethodID getSystemLoader = (*env)->GetStaticMethodID(env, loaderCls, "getSystemClassLoader", "()Ljava/lang/ClassLoader;");
+  jobject loader = getSystemLoader ? (*env)->CallStaticObjectMethod(env, loaderCls, getSystemLoader) : null;
+  (*env)->DeleteLocalRef(env, loaderCls);
+  if (!loader) {
+    return false;
+  }
+  jclass local = (*env)->DefineClass(env, "mud/NativeRing", loader, (const jbyte*) ring_class_bytes,
+                                     (jsize) sizeof(ring_class_bytes));
+  (*env)->DeleteLocalRef(env, loader);
+  if (!local) {
+    return false;
+  }
+  JNINativeMethod natives[] = {
+      {.name = "awaitReadable", .signature = "(JJ)J", .fnPtr = (void*) ring_java_await_readable},
+      {.name = "awaitWritable", .signature = "(JIJ)J", .fnPtr = (void*) ring_java_await_writable},
+      {.name = "signal", .signature = "(J)V", .fnPtr = (void*) ring_java_signal},
+  };
+  if ((*env)->RegisterNatives(env, local, natives, sizeof(natives) / sizeof(natives[0])) != JNI_OK) {
+    (*env)->DeleteLocalRef(env, local);
+    return false;
+  }
+  ring_cls = (*env)->NewGlobalRef(env, local);
+  (*env)->DeleteLocalRef(env, local);
+  return true;
+}
+
+bool mud_ring_init(JNIEnv* env) {
+  mud_stat_transition();
+  mud_mutex_lock(&ring_init_lock);
+  bool ok = ring_cls != null || ring_define_class(env);
+  mud_mutex_unlock(&ring_init_lock);
+  return ok;
+}
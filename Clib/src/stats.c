@@ -0,0 +1,81 @@
+#ifndef _WIN32
+// clock_gettime is POSIX, not part of standard C
+#ifndef _POSIX_C_SOURCE
+#define _POSIX_C_SOURCE 199309L
+#endif
+#include <time.h>
+#endif
+#include <stdint.h>
+#include "../include/mud.h"
+#include "stats.h"
+#include "sync-util.h"
+
+// Blocks are never freed so a snapshot can still read the counts of threads that have exited
+
+typedef struct Mud_Stats_Block_S {
+  struct Mud_Stats_S stats;
+  struct Mud_Stats_Block_S* next;
+} Mud_Stats_Block;
+
+MUD_THREAD_LOCAL struct Mud_Stats_S* mud_thread_stats = null;
+volatile bool mud_stats_timing = false;
+static Mud_Stats_Block* stats_blocks = null;
+static mud_mutex stats_lock = MUD_MUTEX_INIT;
+
+struct Mud_Stats_S* mud_stats_register(void) {
+  Mud_Stats_Block* block = calloc(1, sizeof(Mud_Stats_Block));
+  if (!block) {
+    // counting is best effort, a thread that can't get a block shares a throwaway one
+    static MUD_THREAD_LOCAL struct Mud_Stats_S discarded;
+    return &discarded;
+  }
+  mud_mutex_lock(&stats_lock);
+  block->next = stats_blocks;
+  stats_blocks = block;
+  mud_mutex_unlock(&stats_lock);
+  mud_thread_stats = &block->stats;
+  return mud_thread_stats;
+}
+
+uint64_t mud_stats_now_ns(void) {
+#ifdef _WIN32
+  static LARGE_INTEGER freq = {0};
+  LARGE_INTEGER now;
+  if (!freq.QuadPart) {
+    QueryPerformanceFrequency(&freq);
+  }
+  QueryPerformanceCounter(&now);
+  return (uint64_t) ((double) now.QuadPart * 1e9 / (double) freq.QuadPart);
+#else
+  struct timespec now;
+  clock_gettime(CLOCK_MONOTONIC, &now);
+  return (uint64_t) now.tv_sec * 1000000000ull + (uint64_t) now.tv_nsec;
+#endif
+}
+
+void mud_stats_record_latency(uint64_t ns) {
+  size_t bucket = 0;
+  while (ns > 1 && bucket < MUD_STATS_LATENCY_BUCKETS - 1) {
+    ns >>= 1;
+    bucket++;
+  }
+  mud_stat_add(call_latency[bucket], 1);
+}
+
+void mud_stats_set_timing(bool enabled) {
+  mud_stats_timing = enabled;
+}
+
+void mud_stats_snapshot(struct Mud_Stats_S* out) {
+  memset(out, 0, sizeof(struct Mud_Stats_S));
+  const size_t fields = sizeof(struct Mud_Stats_S) / sizeof(uint64_t);
+  uint64_t* total = (uint64_t*) out;
+  mud_mutex_lock(&stats_lock);
+  for (Mud_Stats_Block* block = stats_blocks; block; block = block->next) {
+    const uint64_t* counts = (const uint64_t*) &block->stats;
+    for (size_t i = 0; i < fields; i++) {
+      total[i] += counts[i];
+    }
+  }
+  mud_mutex_unlock(&stats_lock);
+}
@@ -0,0 +1,30 @@
+//
+// Per thread counters behind mud_stats_snapshot, each thread bumps its own block so the hot paths never contend
+//
+
+#ifndef MUD_STATS_H_
+#define MUD_STATS_H_
+
+#include "../include/mud.h"
+
+#ifdef _WIN32
+#define MUD_THREAD_LOCAL __declspec(thread)
+#else
+#define MUD_THREAD_LOCAL _Thread_local
+#endif
+
+extern MUD_THREAD_LOCAL struct Mud_Stats_S* mud_thread_stats;
+extern volatile bool mud_stats_timing;
+
+struct Mud_Stats_S* mud_stats_register(void);
+uint64_t mud_stats_now_ns(void);
+void mud_stats_record_latency(uint64_t ns);
+
+static inline struct Mud_Stats_S* mud_stats(void) {
+  return mud_thread_stats ? mud_thread_stats : mud_stats_register();
+}
+
+#define mud_stat_add(field, n) (mud_stats()->field += (n))
+#define mud_stat_transition() mud_stat_add(transitions, 1)
+
+#endif //MUD_STATS_H_
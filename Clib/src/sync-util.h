@@ -0,0 +1,70 @@
+//
+// Cross platform locking used to guard the process wide tables in mud
+//
+
+#ifndef MUD_SYNC_UTIL_H_
+#define MUD_SYNC_UTIL_H_
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#ifdef _WIN32
+#include <windows.h>
+typedef SRWLOCK mud_mutex;
+#define MUD_MUTEX_INIT SRWLOCK_INIT
+#define mud_mutex_lock(m) AcquireSRWLockExclusive(m)
+#define mud_mutex_unlock(m) ReleaseSRWLockExclusive(m)
+#define mud_mutex_destroy(m) ((void) (m))
+
+typedef CONDITION_VARIABLE mud_cond;
+#define MUD_COND_INIT CONDITION_VARIABLE_INIT
+#define mud_cond_init(c) InitializeConditionVariable(c)
+#define mud_cond_destroy(c) ((void) (c))
+#define mud_cond_broadcast(c) WakeAllConditionVariable(c)
+
+// sequentially consistent loads and read-modify-writes of words shared with other threads, and other processes' code
+#define mud_atomic_load_u64(p) ((uint64_t) InterlockedCompareExchange64((volatile LONG64*) (p), 0, 0))
+#define mud_atomic_add_u64(p, n) InterlockedExchangeAdd64((volatile LONG64*) (p), (LONG64) (n))
+
+// waits on the condition for at most timeout_ns, forever when negative, false once the timeout has passed
+static inline bool mud_cond_wait(mud_cond* c, mud_mutex* m, int64_t timeout_ns) {
+  DWORD ms = timeout_ns < 0 ? INFINITE : (DWORD) ((timeout_ns + 999999) / 1000000);
+  return SleepConditionVariableSRW(c, m, ms, 0) != 0;
+}
+#else
+#include <pthread.h>
+#include <time.h>
+typedef pthread_mutex_t mud_mutex;
+#define MUD_MUTEX_INIT PTHREAD_MUTEX_INITIALIZER
+#define mud_mutex_lock(m) pthread_mutex_lock(m)
+#define mud_mutex_unlock(m) pthread_mutex_unlock(m)
+#define mud_mutex_destroy(m) pthread_mutex_destroy(m)
+
+typedef pthread_cond_t mud_cond;
+#define MUD_COND_INIT PTHREAD_COND_INITIALIZER
+#define mud_cond_init(c) pthread_cond_init(c, NULL)
+#define mud_cond_destroy(c) pthread_cond_destroy(c)
+#define mud_cond_broadcast(c) pthread_cond_broadcast(c)
+
+// sequentially consistent loads and read-modify-writes of words shared with other threads, and other processes' code
+#define mud_atomic_load_u64(p) __atomic_load_n((p), __ATOMIC_SEQ_CST)
+#define mud_atomic_add_u64(p, n) __atomic_fetch_add((p), (n), __ATOMIC_SEQ_CST)
+
+// waits on the condition for at most timeout_ns, forever when negative, false once the timeout has passed
+static inline bool mud_cond_wait(mud_cond* c, mud_mutex* m, int64_t timeout_ns) {
+  if (timeout_ns < 0) {
+    return pthread_cond_wait(c, m) == 0;
+  }
+  struct timespec deadline;
+  clock_gettime(CLOCK_REALTIME, &deadline);
+  deadline.tv_sec += (time_t) (timeout_ns / 1000000000);
+  deadline.tv_nsec += (long) (timeout_ns % 1000000000);
+  if (deadline.tv_nsec >= 1000000000) {
+    deadline.tv_sec++;
+    deadline.tv_nsec -= 1000000000;
+  }
+  return pthread_cond_timedwait(c, m, &deadline) == 0;
+}
+#endif
+
+#endif //MUD_SYNC_UTIL_H_
@@ -0,0 +1,151 @@
+#include "../include/mud.h"
+#include "box.h"
+#include "stats.h"
+#include "sync-util.h"
+
+// Upcalls from java into .NET. mud/NativeInvocationHandler is a java.lang.reflect.InvocationHandler whose invoke is
+// bound to upcall_invoke, proxies created through it forward every interface call to the .NET dispatcher along with
+// the handle .NET registered the implementation under.
+
+// class file of
+//   public final class mud.NativeInvocationHandler implements java.lang.reflect.InvocationHandler {
+//     public long handle;
+//     public native Object invoke(Object proxy, java.lang.reflect.Method method, Object[] args);
+//   }
+// instances are made with AllocObject so no constructor is needed
+static const unsigned char handler_class_bytes[] = {
+  0xca, 0xfe, 0xba, 0xbe, 0x00, 0x00, 0x00, 0x34, 0x00, 0x0b, 0x01, 0x00, 0x1b, 0x6d, 0x75, 0x64,
+  0x2f, 0x4e, 0x61, 0x74, 0x69, 0x76, 0x65, 0x49, 0x6e, 0x76, 0x6f, 0x63, 0x61, 0x74, 0x69, 0x6f,
+  0x6e, 0x48, 0x61, 0x6e, 0x64, 0x6c, 0x65, 0x72, 0x07, 0x00, 0x01, 0x01, 0x00, 0x10, 0x6a, 0x61,
+  0x76, 0x61, 0x2f, 0x6c, 0x61, 0x6e, 0x67, 0x2f, 0x4f, 0x62, 0x6a, 0x65, 0x63, 0x74, 0x07, 0x00,
+  0x03, 0x01, 0x00, 0x23, 0x6a, 0x61, 0x76, 0x61, 0x2f, 0x6c, 0x61, 0x6e, 0x67, 0x2f, 0x72, 0x65,
+  0x66, 0x6c, 0x65, 0x63, 0x74, 0x2f, 0x49, 0x6e, 0x76, 0x6f, 0x63, 0x61, 0x74, 0x69, 0x6f, 0x6e,
+  0x48, 0x61, 0x6e, 0x64, 0x6c, 0x65, 0x72, 0x07, 0x00, 0x05, 0x01, 0x00, 0x06, 0x68, 0x61, 0x6e,
+  0x64, 0x6c, 0x65, 0x01, 0x00, 0x01, 0x4a, 0x01, 0x00, 0x06, 0x69, 0x6e, 0x76, 0x6f, 0x6b, 0x65,
+  0x01, 0x00, 0x53, 0x28, 0x4c, 0x6a, 0x61, 0x76, 0x61, 0x2f, 0x6c, 0x61, 0x6e, 0x67, 0x2f, 0x4f,
+  0x62, 0x6a, 0x65, 0x63, 0x74, 0x3b, 0x4c, 0x6a, 0x61, 0x76, 0x61, 0x2f, 0x6c, 0x61, 0x6e, 0x67,
+  0x2f, 0x72, 0x65, 0x66, 0x6c, 0x65, 0x63, 0x74, 0x2f, 0x4d, 0x65, 0x74, 0x68, 0x6f, 0x64, 0x3b,
+  0x5b, 0x4c, 0x6a, 0x61, 0x76, 0x61, 0x2f, 0x6c, 0x61, 0x6e, 0x67, 0x2f, 0x4f, 0x62, 0x6a, 0x65,
+  0x63, 0x74, 0x3b, 0x29, 0x4c, 0x6a, 0x61, 0x76, 0x61, 0x2f, 0x6c, 0x61, 0x6e, 0x67, 0x2f, 0x4f,
+  0x62, 0x6a, 0x65, 0x63, 0x74, 0x3b, 0x00, 0x31, 0x00, 0x02, 0x00, 0x04, 0x00, 0x01, 0x00, 0x06,
+  0x00, 0x01, 0x00, 0x01, 0x00, 0x07, 0x00, 0x08, 0x00, 0x00, 0x00, 0x01, 0x01, 0x01, 0x00, 0x09,
+  0x00, 0x0a, 0x00, 0x00, 0x00, 0x00,
+};
+
+static mud_upcall_dispatcher upcall_dispatcher = null;
+static jclass upcall_handler_cls = null;
+static jfieldID upcall_handle_field = null;
+static jclass upcall_proxy_cls = null;
+static jmethodID upcall_new_proxy = null;
+static jclass upcall_class_cls = null;
+static jmethodID upcall_get_class_loader = null;
+static mud_mutex upcall_lock = MUD_MUTEX_INIT;
+
+static jobject JNICALL upcall_invoke(JNIEnv* env, jobject self, jobject proxy, jobject method, jobjectArray args) {
+  uint64_t handle = (uint64_t) (*env)->GetLongField(env, self, upcall_handle_field);
+  jvalue result;
+  memset(&result, 0, sizeof(jvalue));
+  Java_Type type = upcall_dispatcher(env, handle, proxy, (*env)->FromReflectedMethod(env, method), method, args, &result);
+  if ((*env)->ExceptionCheck(env) || type == Java_Void) {
+    return null;
+  }
+  if (type == Java_Object) {
+    // .NET may hand back a global ref it keeps owning, java expects a local one
+    return result.l ? (*env)->NewLocalRef(env, result.l) : null;
+  }
+  return mud_box_value(env, result, type);
+}
+
+static jclass upcall_global_class(JNIEnv* env, const char* name) {
+  jclass local = (*env)->FindClass(env, name);
+  if (!local) {
+    return null;
+  }
+  jclass global = (*env)->NewGlobalRef(env, local);
+  (*env)->DeleteLocalRef(env, local);
+  return global;
+}
+
+static bool upcall_define_handler(JNIEnv* env) {
+  // defined into the system class loader so the handler class is visible to every proxy
+  jclass loaderCls = (*env)->FindClass(env, "java/lang/ClassLoader");
+  if (!loaderCls) {
+    return false;
+  }
+  jmethodID getSystemLoader = (*env)->GetStaticMethodID(env, loaderCls, "getSystemClassLoader", "()Ljava/lang/ClassLoader;");
+  jobject loader = getSystemLoader ? (*env)->CallStaticObjectMethod(env, loaderCls, getSystemLoader) : null;
+  (*env)->DeleteLocalRef(env, loaderCls);
+  if (!loader) {
+    return false;
+  }
+  jclass local = (*env)->DefineClass(env, "mud/NativeInvocationHandler", loader, (const jbyte*) handler_class_bytes,
+                                     (jsize) sizeof(handler_class_bytes));
+  (*env)->DeleteLocalRef(env, loader);
+  if (!local) {
+    return false;
+  }
+  upcall_handler_cls = (*env)->NewGlobalRef(env, local);
+  (*env)->DeleteLocalRef(env, local);
+  upcall_handle_field = (*env)->GetFieldID(env, upcall_handler_cls, "handle", "J");
+  JNINativeMethod invoke = {
+      .name = "invoke",
+      .signature = "(Ljava/lang/Object;Ljava/lang/reflect/Method;[Ljava/lang/Object;)Ljava/lang/Object;",
+      .fnPtr = (void*) upcall_invoke
+  };
+  return upcall_handle_field && (*env)->RegisterNatives(env, upcall_handler_cls, &invoke, 1) == JNI_OK;
+}
+
+bool mud_upcall_init(JNIEnv* env, mud_upcall_dispatcher dispatcher) {
+  mud_stat_transition();
+  mud_mutex_lock(&upcall_lock);
+  upcall_dispatcher = dispatcher;
+  bool ok = upcall_handler_cls != null;
+  if (!ok) {
+    ok = upcall_define_handler(env)
+        && (upcall_proxy_cls = upcall_global_class(env, "java/lang/reflect/Proxy"))
+        && (upcall_new_proxy = (*env)->GetStaticMethodID(env, upcall_proxy_cls, "newProxyInstance",
+                                                           "(Ljava/lang/ClassLoader;[Ljava/lang/Class;Ljava/lang/reflect/InvocationHandler;)Ljava/lang/Object;"))
+        && (upcall_class_cls = upcall_global_class(env, "java/lang/Class"))
+        && (upcall_get_class_loader = (*env)->GetMethodID(env, upcall_class_cls, "getClassLoader", "()Ljava/lang/ClassLoader;"))
+        && mud_box_init(env);
+  }
+  mud_mutex_unlock(&upcall_lock);
+  return ok;
+}
+
+jobject mud_upcall_proxy(JNIEnv* env, jclass iface, uint64_t handle) {
+  mud_stat_transition();
+  jobject handler = (*env)->AllocObject(env, upcall_handler_cls);
+  if (!handler) {
+    return null;
+  }
+  (*env)->SetLongField(env, handler, upcall_handle_field, (jlong) handle);
+  jobject loader = (*env)->CallObjectMethod(env, iface, upcall_get_class_loader);
+  jobjectArray ifaces = (*env)->NewObjectArray(env, 1, upcall_class_cls, iface);
+  jobject proxy = ifaces ? (*env)->CallStaticObjectMethod(env, upcall_proxy_cls, upcall_new_proxy, loader, ifaces, handler) : null;
+  (*env)->DeleteLocalRef(env, handler);
+  (*env)->DeleteLocalRef(env, loader);
+  (*env)->DeleteLocalRef(env, ifaces);
+  if (proxy) {
+    mud_stat_add(local_refs_created, 1);
+  }
+  return proxy;
+}
+
+void mud_upcall_throw(JNIEnv* env, jthrowable ex, const char* msg) {
+  if (ex) {
+    (*env)->Throw(env, ex);
+    return;
+  }
+  jclass runtimeEx = (*env)->FindClass(env, "java/lang/RuntimeException");
+  if (runtimeEx) {
+    (*env)->ThrowNew(env, runtimeEx, msg);
+    (*env)->DeleteLocalRef(env, runtimeEx);
+  }
+}
+
+bool mud_register_native(JNIEnv* env, jclass cls, const char* method, const char* signature, void* fn) {
+  mud_stat_transition();
+  JNINativeMethod native = {.name = (char*) method, .signature = (char*) signature, .fnPtr = fn};
+  return (*env)->RegisterNatives(env, cls, &native, 1) == JNI_OK;
+}
@@ -0,0 +1,35 @@
+using BenchmarkDotNet.Attributes;
+using Mud.Types;
+
+namespace Mud.Benchmarks;
+
+[ClassPath("org.apache.commons.math3.stat.descriptive.SummaryStatistics")]
+public interface ISummaryStatistics
+{
+    [JavaName("addValue")]
+    public void AddValue(double val);
+
+    [JavaName("getMean")]
+    public double GetMean();
+}
+
+public class BoundInterfaceBenchmarks : JvmBenchmark
+{
+    private ISummaryStatistics _bound = null!;
+    private IBoundObject _byName = null!;
+
+    protected override void Setup()
+    {
+        _bound = ClassInfo<ISummaryStatistics>.Instance();
+        _byName = Jvm.GetClassInfo("org.apache.commons.math3.stat.descriptive.SummaryStatistics").Instance();
+    }
+
+    [Benchmark(Baseline = true)]
+    public void ByName() => _byName.Call("addValue", 42d);
+
+    [Benchmark]
+    public void ByNameFast() => _byName.CallVoid("addValue", 42d);
+
+    [Benchmark]
+    public void BoundInterface() => _bound.AddValue(42d);
+}
@@ -0,0 +1,47 @@
+using BenchmarkDotNet.Attributes;
+using Mud.Types;
+
+namespace Mud.Benchmarks;
+
+public class CallBenchmarks : JvmBenchmark
+{
+    private ClassInfo _threadCls = null!;
+    private IBoundObject _integer = null!;
+    private IBoundObject _str = null!;
+    private IBoundObject _rect = null!;
+    private JvmBatch _batch = null!;
+
+    protected override void Setup()
+    {
+        _threadCls = Jvm.GetClassInfo("java.lang.Thread");
+        _integer = Jvm.GetClassInfo("java.lang.Integer").Instance(7);
+        _str = Jvm.GetClassInfo("java.lang.StringBuilder").Instance("hello");
+        _rect = Jvm.GetClassInfo("java.awt.Rectangle").Instance();
+        _batch = new JvmBatch();
+        for (var i = 0; i < 100; i++)
+        {
+            _batch.Call(_rect, "setBounds", 1, 2, 3, 4);
+        }
+    }
+
+    [Benchmark(Baseline = true)]
+    public bool StaticNoArgs() => _threadCls.Call<bool>("interrupted");
+
+    [Benchmark]
+    public int InstanceNoArgs() => _integer.Call<int>("intValue");
+
+    [Benchmark]
+    public char InstanceOneArg() => _str.Call<char>("charAt", 1);
+
+    [Benchmark]
+    public char InstanceOneArgFast() => _str.Call<char, int>("charAt", 1);
+
+    [Benchmark]
+    public void InstanceFourArgs() => _rect.Call("setBounds", 1, 2, 3, 4);
+
+    [Benchmark]
+    public void InstanceFourArgsFast() => _rect.CallVoid("setBounds", 1, 2, 3, 4);
+
+    [Benchmark(OperationsPerInvoke = 100)]
+    public object?[] InstanceFourArgsBatched() => _batch.Execute();
+}
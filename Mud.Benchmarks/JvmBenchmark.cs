@@ -0,0 +1,35 @@
+using BenchmarkDotNet.Attributes;
+
+namespace Mud.Benchmarks;
+
+/// <summary>
+/// Starts the JVM with the commons-math jar the tests use on the class path, downloading it if it isn't there yet
+/// </summary>
+[MemoryDiagnoser]
+public abstract class JvmBenchmark
+{
+    private const string JarPath = "commons-math3.jar";
+    private const string JarUrl = "https://repo1.maven.org/maven2/org/apache/commons/commons-math3/3.6.1/commons-math3-3.6.1.jar";
+
+    [GlobalSetup]
+    public void StartJvm()
+    {
+        if (!Jvm.IsInitialized)
+        {
+            Jvm.Initialize();
+        }
+
+        var jar = new FileInfo(JarPath);
+        if (!jar.Exists)
+        {
+            using var client = new HttpClient();
+            File.WriteAllBytes(jar.FullName, client.GetByteArrayAsync(JarUrl).GetAwaiter().GetResult());
+        }
+        Jvm.AddClassPath(jar.FullName);
+        Setup();
+    }
+
+    protected virtual void Setup()
+    {
+    }
+}
@@ -0,0 +1,40 @@
+using BenchmarkDotNet.Attributes;
+using Mud.Types;
+
+namespace Mud.Benchmarks;
+
+public class StringBenchmarks : JvmBenchmark
+{
+    private ClassInfo _objectsCls = null!;
+    private string _value = null!;
+
+    [Params(16, 256, 4096, 65536)]
+    public int Length { get; set; }
+
+    protected override void Setup()
+    {
+        _objectsCls = Jvm.GetClassInfo("java.util.Objects");
+        _value = new string('m', Length);
+    }
+
+    [Benchmark]
+    public string RoundTrip() => _objectsCls.Call<string>("toString", new TypedArg[] { new(_value, "java.lang.Object") });
+}
+
+public class ArrayBenchmarks : JvmBenchmark
+{
+    private ClassInfo _arraysCls = null!;
+    private double[] _values = null!;
+
+    [Params(100, 10_000, 1_000_000)]
+    public int Length { get; set; }
+
+    protected override void Setup()
+    {
+        _arraysCls = Jvm.GetClassInfo("java.util.Arrays");
+        _values = Enumerable.Range(0, Length).Select(i => (double)i).ToArray();
+    }
+
+    [Benchmark]
+    public double[] RoundTrip() => _arraysCls.Call<double[]>("copyOf", _values, Length);
+}
@@ -0,0 +1,42 @@
+using BenchmarkDotNet.Attributes;
+using Mud.Exceptions;
+using Mud.Types;
+
+namespace Mud.Benchmarks;
+
+public class ObjectBenchmarks : JvmBenchmark
+{
+    private IBoundObject _point = null!;
+    private ClassInfo _objectCls = null!;
+    private ClassInfo _integerCls = null!;
+
+    protected override void Setup()
+    {
+        _point = Jvm.GetClassInfo("java.awt.Point").Instance();
+        _objectCls = Jvm.GetClassInfo("java.lang.Object");
+        _integerCls = Jvm.GetClassInfo("java.lang.Integer");
+    }
+
+    [Benchmark]
+    public int FieldGet() => _point.GetField<int>("x");
+
+    [Benchmark]
+    public void FieldSet() => _point.SetField("x", 5);
+
+    [Benchmark]
+    public void NewObject() => _objectCls.Instance().Release();
+
+    [Benchmark]
+    public bool ExceptionThrowCatch()
+    {
+        try
+        {
+            _integerCls.Call<int, string>("parseInt", "nope");
+            return false;
+        }
+        catch (JavaException e)
+        {
+            return e.IsInstanceOf("java.lang.NumberFormatException");
+        }
+    }
+}
@@ -0,0 +1,296 @@
+using System.Collections.Generic;
+using System.Collections.Immutable;
+using System.Linq;
+using System.Text;
+using Microsoft.CodeAnalysis;
+using Microsoft.CodeAnalysis.CSharp;
+using Microsoft.CodeAnalysis.CSharp.Syntax;
+
+namespace Mud.SourceGen;
+
+/// <summary>
+/// The generated implementation of a bound interface, or the reason none could be generated
+/// </summary>
+/// <param name="HintName">Name of the generated source file</param>
+/// <param name="Registration">Statement registering the implementation with Mud.BoundTypes</param>
+/// <param name="Source">The implementation</param>
+/// <param name="Skipped">Why the interface is left to TypeGen, null when it was generated</param>
+internal readonly record struct BoundTypeSource(string HintName, string Registration, string Source, string? Skipped);
+
+/// <summary>
+/// Generates the BoundObject subclass of every interface marked with a ClassPathAttribute, with the JNI signatures of its
+/// methods computed at build time. The implementations are registered from a module initializer so Mud finds them without
+/// Reflection.Emit or scanning assemblies, interfaces the generator cannot implement are still built at runtime by TypeGen
+/// </summary>
+[Generator(LanguageNames.CSharp)]
+public sealed class BoundTypeGenerator : IIncrementalGenerator
+{
+    private const string BoundObjectInterface = "Mud.Types.IBoundObject";
+    private const string JavaNameAttribute = "Mud.Types.JavaNameAttribute";
+    private const string JavaStaticAttribute = "Mud.Types.JavaStaticAttribute";
+    private const string JavaTypeAttribute = "Mud.Types.JavaTypeAttribute";
+
+    /// <summary>
+    /// Most arguments the typed CallSite.Invoke overloads take
+    /// </summary>
+    private const int MaxTypedArgs = 4;
+
+    private static readonly SymbolDisplayFormat TypeFormat = SymbolDisplayFormat.FullyQualifiedFormat
+        .AddMiscellaneousOptions(SymbolDisplayMiscellaneousOptions.IncludeNullableReferenceTypeModifier);
+
+    private static readonly DiagnosticDescriptor RuntimeBuilt = new("MUD001",
+        "Bound interface is built at runtime",
+        "No implementation was generated for {0}, it is built with Reflection.Emit at runtime: {1}",
+        "Mud", DiagnosticSeverity.Info, true);
+
+    public void Initialize(IncrementalGeneratorInitializationContext context)
+    {
+        var boundTypes = context.SyntaxProvider.ForAttributeWithMetadataName(JavaTypeMap.ClassPathAttribute,
+            static (node, _) => node is InterfaceDeclarationSyntax,
+            static (ctx, _) => Generate((INamedTypeSymbol)ctx.TargetSymbol));
+
+        context.RegisterSourceOutput(boundTypes.Collect(), static (ctx, sources) => Emit(ctx, sources));
+    }
+
+    private static void Emit(SourceProductionContext context, ImmutableArray<BoundTypeSource> sources)
+    {
+        var registrations = new StringBuilder();
+        // partial interfaces show up once per declaration carrying the attribute
+        foreach (var source in sources.GroupBy(s => s.HintName).Select(g => g.First()).OrderBy(s => s.HintName))
+        {
+            if (source.Skipped != null)
+            {
+                context.ReportDiagnostic(Diagnostic.Create(RuntimeBuilt, Location.None, source.HintName, source.Skipped));
+                continue;
+            }
+            context.AddSource($"{source.HintName}.g.cs", source.Source);
+            registrations.Append("            ").AppendLine(source.Registration);
+        }
+        if (registrations.Length == 0)
+        {
+            return;
+        }
+
+        context.AddSource("BoundTypeRegistration.g.cs", $$"""
+            // <auto-generated/>
+            #nullable enable
+            namespace Mud.Generated
+            {
+                internal static class BoundTypeRegistration
+                {
+            #pragma warning disable CA2255
+                    [global::System.Runtime.CompilerServices.ModuleInitializer]
+            #pragma warning restore CA2255
+                    internal static void Register()
+                    {
+            {{registrations}}        }
+                }
+            }
+            """);
+    }
+
+    private static BoundTypeSource Generate(INamedTypeSymbol target)
+    {
+        var hintName = JavaTypeMap.MetadataName(target).Replace('.', '_').Replace('+', '_');
+        var skipped = new BoundTypeSource(hintName, "", "", null);
+        if (target.IsGenericType)
+        {
+            return skipped with { Skipped = "generic interfaces are closed at runtime" };
+        }
+        for (var type = target; type != null; type = type.ContainingType)
+        {
+            if (type.DeclaredAccessibility is not (Accessibility.Public or Accessibility.Internal or Accessibility.ProtectedOrInternal))
+            {
+                return skipped with { Skipped = "the interface is not accessible from its assembly" };
+            }
+        }
+
+        var targetName = target.ToDisplayString(TypeFormat);
+        var implName = $"{hintName}_Bound";
+        var sites = new StringBuilder();
+        var members = new StringBuilder();
+        var siteCount = 0;
+        foreach (var member in BoundMembers(target))
+        {
+            string? error;
+            switch (member)
+            {
+                case { IsStatic: true }:
+                    error = $"{member.Name} is a static abstract member";
+                    break;
+                case IMethodSymbol { MethodKind: MethodKind.Ordinary } method:
+                    error = GenMethod(method, targetName, siteCount++, sites, members);
+                    break;
+                case IMethodSymbol:
+                    // accessors are generated along with their property
+                    continue;
+                case IPropertySymbol property:
+                    error = GenProp(property, targetName, members);
+                    break;
+                default:
+                    error = $"{member.Name} is not a method or property";
+                    break;
+            }
+            if (error != null)
+            {
+                return skipped with { Skipped = error };
+            }
+        }
+
+        var classPaths = string.Join(", ", JavaTypeMap.GetClassPaths(target).Select(p => SymbolDisplay.FormatLiteral(p, true)));
+        var source = $$"""
+            // <auto-generated/>
+            #nullable enable
+            namespace Mud.Generated
+            {
+                [global::System.ComponentModel.EditorBrowsable(global::System.ComponentModel.EditorBrowsableState.Never)]
+                internal sealed class {{implName}} : global::Mud.Types.BoundObject, {{targetName}}
+                {
+            {{sites}}
+            {{members}}    }
+            }
+            """;
+        return new BoundTypeSource(hintName,
+            $"global::Mud.BoundTypes.Register<{targetName}>(static () => new global::Mud.Generated.{implName}(){(classPaths.Length > 0 ? ", " : "")}{classPaths});",
+            source, null);
+    }
+
+    /// <summary>
+    /// The abstract members of the interface and the interfaces it extends, members of IBoundObject are implemented by BoundObject
+    /// </summary>
+    private static IEnumerable<ISymbol> BoundMembers(INamedTypeSymbol target)
+    {
+        var boundObject = target.AllInterfaces.FirstOrDefault(i => i.ToDisplayString() == BoundObjectInterface);
+        var inherited = boundObject == null
+            ? new HashSet<INamedTypeSymbol>(SymbolEqualityComparer.Default)
+            : new HashSet<INamedTypeSymbol>(boundObject.AllInterfaces.Append(boundObject), SymbolEqualityComparer.Default);
+        return new[] { target }.Concat(target.AllInterfaces)
+            .Where(i => !inherited.Contains(i))
+            .SelectMany(i => i.GetMembers())
+            .Where(m => m.IsAbstract);
+    }
+
+    private static string? GenMethod(IMethodSymbol method, string targetName, int index, StringBuilder sites, StringBuilder members)
+    {
+        if (method.IsGenericMethod || method.Parameters.Any(p => p.RefKind != RefKind.None))
+        {
+            return $"{method.Name} has generic or by reference parameters";
+        }
+        var isStatic = HasAttribute(method, JavaStaticAttribute);
+        if (JavaTypeMap.Map(method.ReturnType, GetJavaType(method)) is not { } returnType)
+        {
+            return $"{method.Name} returns {method.ReturnType.ToDisplayString()} which has no java type";
+        }
+
+        var paramTypes = new List<string>();
+        var signature = new StringBuilder("(");
+        var dynamicSignature = false;
+        foreach (var param in method.Parameters)
+        {
+            var classPath = GetJavaType(param);
+            if (JavaTypeMap.Map(param.Type, classPath) is not { } paramType)
+            {
+                return $"{method.Name} takes {param.Type.ToDisplayString()} which has no java type";
+            }
+            // an untyped bound object parameter takes its java type from the object that's passed in
+            dynamicSignature |= classPath == null && IsBoundObject(param.Type);
+            paramTypes.Add(paramType.Expression);
+            signature.Append(paramType.Signature);
+        }
+        signature.Append(')').Append(returnType.Signature);
+
+        var returnClrType = method.ReturnsVoid ? "void" : method.ReturnType.ToDisplayString(TypeFormat);
+        var site = $"_site{index}";
+        sites.AppendLine($$"""
+                    private static readonly global::Mud.CallSite {{site}} = global::Mud.CallSite.Generated(typeof({{targetName}}),
+                        {{SymbolDisplay.FormatLiteral(GetMemberName(method), true)}}, {{(isStatic ? "true" : "false")}}, typeof({{method.ReturnType.ToDisplayString(SymbolDisplayFormat.FullyQualifiedFormat)}}), {{returnType.Expression}},
+                        {{(paramTypes.Count == 0 ? "global::System.Array.Empty<global::Mud.Types.CustomType>()" : $"new global::Mud.Types.CustomType[] {{ {string.Join(", ", paramTypes)} }}")}},
+                        {{(dynamicSignature ? "null" : SymbolDisplay.FormatLiteral(signature.ToString(), true))}});
+            """);
+
+        var parameters = string.Join(", ", method.Parameters.Select(p => $"{p.Type.ToDisplayString(TypeFormat)} @{p.Name}"));
+        string invoke;
+        if (!dynamicSignature && method.Parameters.Length <= MaxTypedArgs)
+        {
+            // the arguments are passed as they are rather than boxed into an array
+            var typeArgs = method.Parameters.Select(p => p.Type.ToDisplayString(TypeFormat));
+            if (!method.ReturnsVoid)
+            {
+                typeArgs = typeArgs.Prepend(returnClrType);
+            }
+            var typeList = string.Join(", ", typeArgs);
+            var generic = typeList.Length == 0 ? "" : $"<{typeList}>";
+            var args = string.Join(", ", (isStatic ? Enumerable.Empty<string>() : new[] { "this" })
+                .Concat(method.Parameters.Select(p => $"@{p.Name}")));
+            invoke = (isStatic, method.ReturnsVoid) switch
+            {
+                (true, true) => $"{site}.InvokeStaticVoid{generic}({args})",
+                (true, false) => $"{site}.InvokeStatic{generic}({args})",
+                (false, true) => $"{site}.InvokeVoid{generic}({args})",
+                (false, false) => $"{site}.Invoke{generic}({args})"
+            };
+        }
+        else
+        {
+            var args = method.Parameters.Length == 0
+                ? "global::System.Array.Empty<object?>()"
+                : $"new object?[] {{ {string.Join(", ", method.Parameters.Select(p => $"@{p.Name}"))} }}";
+            invoke = (isStatic, method.ReturnsVoid) switch
+            {
+                (true, true) => $"{site}.InvokeStatic({args})",
+                (true, false) => $"{site}.InvokeStatic<{returnClrType}>({args})",
+                (false, true) => $"{site}.Invoke(this, {args})",
+                (false, false) => $"{site}.Invoke<{returnClrType}>(this, {args})"
+            };
+        }
+        members.AppendLine($"        {returnClrType} {method.ContainingType.ToDisplayString(TypeFormat)}.{method.Name}({parameters}) => {invoke};");
+        return null;
+    }
+
+    private static string? GenProp(IPropertySymbol property, string targetName, StringBuilder members)
+    {
+        if (property.IsIndexer || property.SetMethod is { IsInitOnly: true })
+        {
+            return $"{property.Name} is an indexer or init only property";
+        }
+        if (JavaTypeMap.Map(property.Type, GetJavaType(property)) is not { } type)
+        {
+            return $"{property.Name} is a {property.Type.ToDisplayString()} which has no java type";
+        }
+
+        var name = SymbolDisplay.FormatLiteral(GetMemberName(property), true);
+        var propType = property.Type.ToDisplayString(TypeFormat);
+        // static fields are read through the interface's class rather than the bound object
+        var owner = HasAttribute(property, JavaStaticAttribute) ? $"global::Mud.ClassInfo<{targetName}>.Class" : "this";
+        members.AppendLine($"        {propType} {property.ContainingType.ToDisplayString(TypeFormat)}.{property.Name}");
+        members.AppendLine("        {");
+        if (property.GetMethod != null)
+        {
+            members.AppendLine($"            get => {owner}.GetField<{propType}>({name}, {type.Expression});");
+        }
+        if (property.SetMethod != null)
+        {
+            members.AppendLine($"            set => {owner}.SetField({name}, new global::Mud.Types.TypedArg(value, {type.Expression}));");
+        }
+        members.AppendLine("        }");
+        return null;
+    }
+
+    /// <summary>
+    /// Matches TypeGen, the name of a JavaStaticAttribute wins over the one of a JavaNameAttribute
+    /// </summary>
+    private static string GetMemberName(ISymbol member) =>
+        GetAttributeName(member, JavaStaticAttribute) ?? GetAttributeName(member, JavaNameAttribute) ?? member.Name;
+
+    private static string? GetAttributeName(ISymbol member, string attribute) =>
+        member.GetAttributes().LastOrDefault(a => a.AttributeClass?.ToDisplayString() == attribute)?
+            .ConstructorArguments.FirstOrDefault().Value as string;
+
+    private static string? GetJavaType(ISymbol symbol) => GetAttributeName(symbol, JavaTypeAttribute);
+
+    private static bool HasAttribute(ISymbol symbol, string attribute) =>
+        symbol.GetAttributes().Any(a => a.AttributeClass?.ToDisplayString() == attribute);
+
+    private static bool IsBoundObject(ITypeSymbol type) =>
+        type.ToDisplayString() == BoundObjectInterface || type.AllInterfaces.Any(i => i.ToDisplayString() == BoundObjectInterface);
+}
@@ -0,0 +1,9 @@
+// ReSharper disable once CheckNamespace
+namespace System.Runtime.CompilerServices;
+
+/// <summary>
+/// Lets the records' init accessors compile on netstandard2.0, which does not ship the type
+/// </summary>
+internal static class IsExternalInit
+{
+}
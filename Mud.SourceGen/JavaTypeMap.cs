@@ -0,0 +1,149 @@
+using System.Collections.Generic;
+using System.Linq;
+using Microsoft.CodeAnalysis;
+using Microsoft.CodeAnalysis.CSharp;
+
+namespace Mud.SourceGen;
+
+/// <summary>
+/// A java type resolved at build time, the expression creates the matching Mud.Types.CustomType
+/// </summary>
+/// <param name="Expression">C# expression constructing the CustomType</param>
+/// <param name="Signature">The java type signature</param>
+internal readonly record struct JavaTypeInfo(string Expression, string Signature);
+
+/// <summary>
+/// Build time counterpart of Mud.TypeMap.MapToType, the two have to agree for generated signatures to match
+/// the ones TypeGen computes at runtime
+/// </summary>
+internal static class JavaTypeMap
+{
+    internal const string ClassPathAttribute = "Mud.Types.ClassPathAttribute";
+    private const string CustomType = "global::Mud.Types.CustomType";
+    private const string JavaType = "global::Mud.Types.JavaType";
+
+    /// <summary>
+    /// Translates the type into its java type
+    /// </summary>
+    /// <param name="type">The .NET type</param>
+    /// <param name="classPath">Class path given by a JavaTypeAttribute</param>
+    /// <returns>Null when the type has no java counterpart, TypeMap throws for those at runtime</returns>
+    internal static JavaTypeInfo? Map(ITypeSymbol type, string? classPath)
+    {
+        switch (type.SpecialType)
+        {
+            case SpecialType.System_Void:
+                return Primitive("Void", "V");
+            case SpecialType.System_Int32:
+                return Primitive("Int", "I");
+            case SpecialType.System_Byte:
+                return Primitive("Byte", "B");
+            case SpecialType.System_Boolean:
+                return Primitive("Bool", "Z");
+            case SpecialType.System_Single:
+                return Primitive("Float", "F");
+            case SpecialType.System_Double:
+            case SpecialType.System_Decimal:
+                return Primitive("Double", "D");
+            case SpecialType.System_Int16:
+                return Primitive("Short", "S");
+            case SpecialType.System_Int64:
+                return Primitive("Long", "J");
+            case SpecialType.System_Char:
+                return Primitive("Char", "C");
+        }
+
+        if (type is INamedTypeSymbol { IsGenericType: true } generic)
+        {
+            var arg = generic.TypeArguments[0].SpecialType;
+            // nullable primitives map to their boxing class, lists of primitives to a java.util.List of boxes
+            if (generic.OriginalDefinition.SpecialType == SpecialType.System_Nullable_T)
+            {
+                return BoxClassPath(arg) is { } boxClassPath ? Object(boxClassPath) : null;
+            }
+            if (IsList(generic.OriginalDefinition) && BoxClassPath(arg) != null)
+            {
+                return Object("java/util/List");
+            }
+        }
+
+        if (type is IArrayTypeSymbol array)
+        {
+            if (Map(array.ElementType, null) is not { } elem)
+            {
+                return null;
+            }
+            // multi-dimensional arrays are java arrays nested once per dimension
+            for (var i = 0; i < array.Rank; i++)
+            {
+                elem = new JavaTypeInfo($"new {CustomType}({elem.Expression})", $"[{elem.Signature}");
+            }
+            return elem;
+        }
+
+        if (type.SpecialType == SpecialType.System_String)
+        {
+            return Object("java/lang/String");
+        }
+
+        if (type is not INamedTypeSymbol named)
+        {
+            return null;
+        }
+        classPath ??= GetClassPaths(named).FirstOrDefault() ?? MetadataName(named);
+        if (classPath.StartsWith("System."))
+        {
+            return null;
+        }
+        return Object(classPath.Replace('.', '/'));
+    }
+
+    /// <summary>
+    /// The class paths of the type's ClassPathAttributes in declaration order
+    /// </summary>
+    internal static IEnumerable<string> GetClassPaths(ITypeSymbol type) =>
+        type.GetAttributes()
+            .Where(a => a.AttributeClass?.ToDisplayString() == ClassPathAttribute)
+            .Select(a => a.ConstructorArguments.FirstOrDefault().Value as string)
+            .Where(p => p != null)
+            .Select(p => p!.Replace('.', '/'));
+
+    /// <summary>
+    /// Matches Type.FullName without its generic arity, e.g. Namespace.Outer+Inner
+    /// </summary>
+    internal static string MetadataName(INamedTypeSymbol type)
+    {
+        var name = type.MetadataName.Split('`')[0];
+        if (type.ContainingType != null)
+        {
+            return $"{MetadataName(type.ContainingType)}+{name}";
+        }
+        return type.ContainingNamespace is { IsGlobalNamespace: false } ns ? $"{ns.ToDisplayString()}.{name}" : name;
+    }
+
+    /// <summary>
+    /// Matches Mud.TypeMap.BoxClassPath for the primitives TypeMap.TryGetBlittablePrimitive accepts
+    /// </summary>
+    private static string? BoxClassPath(SpecialType type) => type switch
+    {
+        SpecialType.System_Int32 => "java/lang/Integer",
+        SpecialType.System_Boolean => "java/lang/Boolean",
+        SpecialType.System_Byte => "java/lang/Byte",
+        SpecialType.System_Char => "java/lang/Character",
+        SpecialType.System_Int16 => "java/lang/Short",
+        SpecialType.System_Int64 => "java/lang/Long",
+        SpecialType.System_Single => "java/lang/Float",
+        SpecialType.System_Double => "java/lang/Double",
+        _ => null
+    };
+
+    private static bool IsList(INamedTypeSymbol definition) =>
+        definition.SpecialType is SpecialType.System_Collections_Generic_IList_T or SpecialType.System_Collections_Generic_IReadOnlyList_T
+        || definition.ToDisplayString() == "System.Collections.Generic.List<T>";
+
+    private static JavaTypeInfo Primitive(string type, string signature) =>
+        new($"new {CustomType}({JavaType}.{type})", signature);
+
+    private static JavaTypeInfo Object(string classPath) =>
+        new($"new {CustomType}({SymbolDisplay.FormatLiteral(classPath, true)})", classPath.StartsWith("[") ? classPath : $"L{classPath};");
+}
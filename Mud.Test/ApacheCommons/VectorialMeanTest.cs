@@ -23,6 +23,25 @@ public class VectorialMeanTest : Math
         Assert.Equal(0.0, mean[0], 1.0e-12);
         Assert.Equal(0.0, mean[1], 1.0e-12);
     }
+
+    [Fact]
+    public void TestBatched()
+    {
+        var stat = Jvm.GetClassInfo("org.apache.commons.math3.stat.descriptive.moment.VectorialMean").Instance(3);
+        var batch = new JvmBatch();
+        foreach (var point in _points)
+        {
+            batch.Call(stat, "increment", point);
+        }
+        batch.Call<double[]>(stat, "getResult");
+
+        var results = batch.Execute();
+        Assert.Equal(_points.Length + 1, batch.Executed);
+        var mean = (double[])results[^1]!;
+        Assert.Equal(1.78, mean[0], 1.0e-12);
+        Assert.Equal(1.62, mean[1], 1.0e-12);
+        Assert.Equal(3.12, mean[2], 1.0e-12);
+    }
   
 
 }
\ No newline at end of file
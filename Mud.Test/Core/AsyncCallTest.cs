@@ -0,0 +1,55 @@
+using Mud.Exceptions;
+using Xunit;
+
+namespace Mud.Test.Core;
+
+[Collection("Serial")]
+public class AsyncCallTest : BaseTest
+{
+    [Fact]
+    public async Task CallsRunOnWorkers()
+    {
+        var mathCls = Jvm.GetClassInfo("java.lang.Math");
+        var results = await Task.WhenAll(Enumerable.Range(0, 100)
+            .Select(i => mathCls.CallAsync<int>("abs", -i).AsTask()));
+        Assert.Equal(Enumerable.Range(0, 100), results);
+
+        var strBldr = Jvm.GetClassInfo("java.lang.StringBuilder").Instance("Foo");
+        await strBldr.CallAsync("setLength", 1);
+        Assert.Equal("F", await strBldr.CallAsync<string>("toString"));
+    }
+
+    [Fact]
+    public async Task ExceptionsAreSurfaced()
+    {
+        var integerCls = Jvm.GetClassInfo("java.lang.Integer");
+        var ex = await Assert.ThrowsAsync<JavaException>(() => integerCls.CallAsync<int>("parseInt", "nope").AsTask());
+        Assert.True(ex.IsInstanceOf("java.lang.NumberFormatException"));
+    }
+
+    [Fact]
+    public async Task BackpressureAndCancellation()
+    {
+        using var pool = new JvmWorkerPool(1, 1);
+        using var gate = new ManualResetEventSlim();
+        var blocking = pool.Run(() => gate.Wait());
+        // wait for the worker to pick the blocking call up so the queue is empty again
+        while (pool.Pending != 0)
+        {
+            await Task.Delay(1);
+        }
+
+        Assert.True(pool.TryRun(() => 1, out var queued));
+        Assert.False(pool.TryRun(() => 2, out _));
+
+        using var cts = new CancellationTokenSource();
+        var waiting = pool.Run(() => 3, cts.Token);
+        Assert.False(waiting.IsCompleted);
+        cts.Cancel();
+        await Assert.ThrowsAnyAsync<OperationCanceledException>(() => waiting.AsTask());
+
+        gate.Set();
+        await blocking;
+        Assert.Equal(1, await queued);
+    }
+}
@@ -0,0 +1,28 @@
+using Mud.Exceptions;
+using Xunit;
+
+namespace Mud.Test.Core;
+
+[Collection("Serial")]
+public class BatchTest : BaseTest
+{
+    [Fact]
+    public void StopsAtFirstException()
+    {
+        var strBldr = Jvm.GetClassInfo("java.lang.StringBuilder").Instance("Foo");
+        var integerCls = Jvm.GetClassInfo("java.lang.Integer");
+        var batch = new JvmBatch()
+            .Call(strBldr, "setLength", 1)
+            .CallStatic<int>(integerCls, "parseInt", "12")
+            .CallStatic<int>(integerCls, "parseInt", "nope")
+            .Call(strBldr, "setLength", 0);
+
+        Assert.Throws<JavaException>(() => batch.Execute());
+        Assert.Equal(3, batch.Executed);
+        Assert.Equal("F", strBldr.ToString());
+
+        batch.Clear();
+        var results = batch.CallStatic<int>(integerCls, "parseInt", "12").Call<int>(strBldr, "length").Execute();
+        Assert.Equal(new object?[] { 12, 1 }, results);
+    }
+}
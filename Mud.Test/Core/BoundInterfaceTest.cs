@@ -27,6 +27,19 @@ public class BoundInterfaceTest : BaseTest
         Assert.Equal("Foo+Bar=FooBar", strBldr.ToString());
     }
     
+    [Fact]
+    public void ReturnedClassIsCachedTest()
+    {
+        var strBldr = ClassInfo<IStringBuilder>.Instance("Foo");
+        strBldr.AppendWithGenericResp("Bar");
+        var cached = Jvm.CachedClasses;
+        for (var i = 0; i < 100; i++)
+        {
+            Assert.True(strBldr.AppendWithGenericResp("+") is IStringBuilder);
+        }
+        Assert.Equal(cached, Jvm.CachedClasses);
+    }
+
     [Fact]
     public void StaticGenericReturnTypeTest()
     {
@@ -0,0 +1,61 @@
+using Mud.Exceptions;
+using Mud.Types;
+using Xunit;
+
+namespace Mud.Test.Core;
+
+[Collection("Serial")]
+public class BoxedPrimitiveTest : BaseTest
+{
+    [Fact]
+    public void NullableReturnsUnbox()
+    {
+        Assert.Equal(42, Jvm.GetClassInfo("java.lang.Integer").Call<int?, string>("valueOf", "42"));
+        Assert.Equal(2.5, Jvm.GetClassInfo("java.lang.Double").Call<double?, string>("valueOf", "2.5"));
+    }
+
+    [Fact]
+    public void NullBoxesMapToNull()
+    {
+        using var map = Jvm.GetClassInfo("java.util.HashMap").Instance();
+        Assert.Null(map.Call<int?>("get", "missing"));
+    }
+
+    [Fact]
+    public void BoxedArgsAreBoxedNatively()
+    {
+        var objects = Jvm.GetClassInfo("java.util.Objects");
+        var str = objects.Call<string>("toString", new[] { new TypedArg(5, new CustomType("java.lang.Integer")) });
+        Assert.Equal("5", str);
+    }
+
+    [Fact]
+    public void ListRoundTrip()
+    {
+        var values = Enumerable.Range(0, 1000).Select(i => i * 0.25).ToList();
+        var copy = Jvm.GetClassInfo("java.util.Collections").Call<List<double>>("unmodifiableList", values);
+        Assert.Equal(values, copy);
+    }
+
+    [Fact]
+    public void CollectionsReadAsPrimitiveArrays()
+    {
+        using var list = Jvm.GetClassInfo("java.util.ArrayList").Instance();
+        list.Call<bool>("add", 1);
+        list.Call<bool>("add", 2);
+        list.Call<bool>("add", 3);
+        // toArray returns an Object[] of Integer boxes, numeric types convert any java.lang.Number
+        Assert.Equal(new[] { 1, 2, 3 }, list.Call<int[]>("toArray"));
+        Assert.Equal(new[] { 1L, 2L, 3L }, list.Call<long[]>("toArray"));
+        Assert.Equal(new List<double> { 1, 2, 3 }, list.Call<List<double>>("subList", 0, 3));
+    }
+
+    [Fact]
+    public void NullElementsThrow()
+    {
+        using var list = Jvm.GetClassInfo("java.util.ArrayList").Instance();
+        list.Call<bool>("add", 1.5);
+        list.Call<bool>("add", new[] { new TypedArg(null, new CustomType("java.lang.Object")) });
+        Assert.Throws<JavaException>(() => list.Call<double[]>("toArray"));
+    }
+}
@@ -0,0 +1,137 @@
+using System.IO.Compression;
+using System.Text;
+using Mud.Exceptions;
+using Xunit;
+
+namespace Mud.Test.Core;
+
+[Collection("Serial")]
+public class ClassLoaderTest : BaseTest
+{
+    private const string PluginClass = "mud.test.Plugin";
+
+    // class file of
+    //   public class mud.test.Plugin {
+    //     public static int answer() { return 42; }
+    //     public int version() { return 42; }
+    //   }
+    private static readonly byte[] PluginBytes =
+    {
+        0xca, 0xfe, 0xba, 0xbe, 0x00, 0x00, 0x00, 0x34, 0x00, 0x0d, 0x01, 0x00, 0x0f, 0x6d, 0x75, 0x64,
+        0x2f, 0x74, 0x65, 0x73, 0x74, 0x2f, 0x50, 0x6c, 0x75, 0x67, 0x69, 0x6e, 0x07, 0x00, 0x01, 0x01,
+        0x00, 0x10, 0x6a, 0x61, 0x76, 0x61, 0x2f, 0x6c, 0x61, 0x6e, 0x67, 0x2f, 0x4f, 0x62, 0x6a, 0x65,
+        0x63, 0x74, 0x07, 0x00, 0x03, 0x01, 0x00, 0x06, 0x3c, 0x69, 0x6e, 0x69, 0x74, 0x3e, 0x01, 0x00,
+        0x03, 0x28, 0x29, 0x56, 0x0c, 0x00, 0x05, 0x00, 0x06, 0x0a, 0x00, 0x04, 0x00, 0x07, 0x01, 0x00,
+        0x04, 0x43, 0x6f, 0x64, 0x65, 0x01, 0x00, 0x06, 0x61, 0x6e, 0x73, 0x77, 0x65, 0x72, 0x01, 0x00,
+        0x07, 0x76, 0x65, 0x72, 0x73, 0x69, 0x6f, 0x6e, 0x01, 0x00, 0x03, 0x28, 0x29, 0x49, 0x00, 0x21,
+        0x00, 0x02, 0x00, 0x04, 0x00, 0x00, 0x00, 0x00, 0x00, 0x03, 0x00, 0x01, 0x00, 0x05, 0x00, 0x06,
+        0x00, 0x01, 0x00, 0x09, 0x00, 0x00, 0x00, 0x11, 0x00, 0x01, 0x00, 0x01, 0x00, 0x00, 0x00, 0x05,
+        0x2a, 0xb7, 0x00, 0x08, 0xb1, 0x00, 0x00, 0x00, 0x00, 0x00, 0x09, 0x00, 0x0a, 0x00, 0x0c, 0x00,
+        0x01, 0x00, 0x09, 0x00, 0x00, 0x00, 0x0f, 0x00, 0x01, 0x00, 0x00, 0x00, 0x00, 0x00, 0x03, 0x10,
+        0x2a, 0xac, 0x00, 0x00, 0x00, 0x00, 0x00, 0x01, 0x00, 0x0b, 0x00, 0x0c, 0x00, 0x01, 0x00, 0x09,
+        0x00, 0x00, 0x00, 0x0f, 0x00, 0x01, 0x00, 0x01, 0x00, 0x00, 0x00, 0x03, 0x10, 0x2a, 0xac, 0x00,
+        0x00, 0x00, 0x00, 0x00, 0x00,
+    };
+
+    // the simple class name and the bipush operands of answer and version
+    private const int NameOffset = 22;
+    private const int AnswerOffset = 176;
+    private const int VersionOffset = 205;
+
+    /// <param name="answer">Value answer and version return</param>
+    /// <param name="name">Simple name of the class, 6 ascii chars</param>
+    /// <param name="compression">Compression of the class entry</param>
+    private static byte[] PluginJar(byte answer, string name = "Plugin", CompressionLevel compression = CompressionLevel.Optimal)
+    {
+        var cls = (byte[])PluginBytes.Clone();
+        Encoding.ASCII.GetBytes(name).CopyTo(cls, NameOffset);
+        cls[AnswerOffset] = answer;
+        cls[VersionOffset] = answer;
+        using var stream = new MemoryStream();
+        using (var zip = new ZipArchive(stream, ZipArchiveMode.Create))
+        {
+            zip.CreateEntry("META-INF/MANIFEST.MF").Open().Dispose();
+            using var entry = zip.CreateEntry($"mud/test/{name}.class", compression).Open();
+            entry.Write(cls);
+        }
+        return stream.ToArray();
+    }
+
+    [Fact]
+    public void LoadsClassesFromMemory()
+    {
+        using var loader = JavaClassLoader.Create();
+        loader.AddJar(PluginJar(42));
+        Assert.Equal(1, loader.ClassCount);
+        Assert.Equal(42, loader.GetClassInfo(PluginClass).Call<int>("answer"));
+    }
+
+    [Fact]
+    public void LoadsStoredEntries()
+    {
+        using var loader = JavaClassLoader.Create();
+        loader.AddJar(PluginJar(42, compression: CompressionLevel.NoCompression));
+        using var plugin = loader.GetClassInfo(PluginClass).Instance();
+        Assert.Equal(42, plugin.Call<int>("version"));
+    }
+
+    [Fact]
+    public void MapsJarFiles()
+    {
+        var path = Path.Combine(Path.GetTempPath(), $"mud-plugin-{Guid.NewGuid():N}.jar");
+        File.WriteAllBytes(path, PluginJar(42));
+        try
+        {
+            using var loader = JavaClassLoader.Open(path);
+            Assert.Equal(42, loader.GetClassInfo(PluginClass).Call<int>("answer"));
+        }
+        finally
+        {
+            File.Delete(path);
+        }
+    }
+
+    [Fact]
+    public void LoadersAreIsolated()
+    {
+        using var first = JavaClassLoader.Create();
+        using var second = JavaClassLoader.Create();
+        first.AddJar(PluginJar(1));
+        second.AddJar(PluginJar(2));
+
+        Assert.Equal(1, first.GetClassInfo(PluginClass).Call<int>("answer"));
+        Assert.Equal(2, second.GetClassInfo(PluginClass).Call<int>("answer"));
+        Assert.False(Jvm.TryGetClassInfo(PluginClass, out _));
+        // instances bind to the loader's class rather than one looked up by name
+        using var plugin = second.GetClassInfo(PluginClass).Instance();
+        Assert.Equal(2, plugin.Call<int>("version"));
+    }
+
+    [Fact]
+    public void AddedLoadersResolveThroughJvm()
+    {
+        using var loader = JavaClassLoader.Create();
+        loader.AddJar(PluginJar(42, "Shared"));
+        Assert.False(Jvm.TryGetClassInfo("mud.test.Shared", out _));
+        Jvm.AddClassLoader(loader);
+        Assert.Equal(42, Jvm.GetClassInfo("mud.test.Shared").Call<int>("answer"));
+    }
+
+    [Fact]
+    public void ChildrenSeeTheirParentsClasses()
+    {
+        using var parent = JavaClassLoader.Create();
+        parent.AddJar(PluginJar(42));
+        using var child = JavaClassLoader.Create(parent);
+        Assert.Equal(0, child.ClassCount);
+        Assert.Equal(42, child.GetClassInfo(PluginClass).Call<int>("answer"));
+    }
+
+    [Fact]
+    public void RejectsInvalidJars()
+    {
+        using var loader = JavaClassLoader.Create();
+        Assert.Throws<InvalidDataException>(() => loader.AddJar(new byte[] { 1, 2, 3 }));
+        Assert.Throws<ClassNotFoundException>(() => loader.GetClassInfo("mud.test.Missing"));
+    }
+}
@@ -0,0 +1,70 @@
+using Mud.Types;
+using Xunit;
+
+namespace Mud.Test.Core;
+
+[Collection("Serial")]
+public class EnumerableTest : BaseTest
+{
+    private static IBoundObject IntList(int count)
+    {
+        var list = Jvm.GetClassInfo("java.util.ArrayList").Instance(count);
+        var integerCls = Jvm.GetClassInfo("java.lang.Integer");
+        var integerType = new CustomType("java.lang.Integer");
+        for (var i = 0; i < count; i++)
+        {
+            var boxed = integerCls.Call<BoundObject>("valueOf", integerType, new TypedArg[] { new(i) });
+            list.Call<bool>("add", new TypedArg[] { new(boxed, "java.lang.Object") });
+            boxed.Release();
+        }
+        return list;
+    }
+
+    [Fact]
+    public void UnboxesPrimitivesInChunks()
+    {
+        var list = IntList(1000);
+        Assert.Equal(Enumerable.Range(0, 1000), list.AsEnumerable<int>(64));
+        Assert.Equal(999L * 1000 / 2, list.AsEnumerable<long>().Sum());
+    }
+
+    [Fact]
+    public void CopiesStringsInBulk()
+    {
+        var list = Jvm.GetClassInfo("java.util.ArrayList").Instance();
+        var expected = new List<string?>();
+        for (var i = 0; i < 300; i++)
+        {
+            var str = i == 7 ? null : new string('m', i * 100);
+            expected.Add(str);
+            list.Call<bool>("add", new TypedArg[] { new(str, "java.lang.Object") });
+        }
+        Assert.Equal(expected, list.AsEnumerable<string?>(128));
+    }
+
+    [Fact]
+    public void IteratesStreamsAndObjects()
+    {
+        var stream = IntList(10).Call("stream", new CustomType("java.util.stream.Stream"), Array.Empty<TypedArg>());
+        var elems = stream.AsEnumerable<IBoundObject>(3).ToList();
+        Assert.Equal(10, elems.Count);
+        Assert.Equal("9", elems[9].ToString());
+    }
+
+    [Fact]
+    public async Task PrefetchesChunksAsync()
+    {
+        var list = IntList(1000);
+        var sum = 0;
+        await foreach (var i in list.AsAsyncEnumerable<int>(100))
+        {
+            sum += i;
+        }
+        Assert.Equal(999 * 1000 / 2, sum);
+
+        await foreach (var _ in list.AsAsyncEnumerable<int>(10))
+        {
+            break;
+        }
+    }
+}
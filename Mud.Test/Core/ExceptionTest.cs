@@ -0,0 +1,31 @@
+using Mud.Exceptions;
+using Xunit;
+
+namespace Mud.Test.Core;
+
+[Collection("Serial")]
+public class ExceptionTest : BaseTest
+{
+    [Fact]
+    public void ClassCheckWithoutFormatting()
+    {
+        var integerCls = Jvm.GetClassInfo("java.lang.Integer");
+        var ex = Assert.Throws<JavaException>(() => integerCls.Call<int, string>("parseInt", "nope"));
+        Assert.Equal("java/lang/NumberFormatException", ex.JavaClassPath);
+        Assert.True(ex.IsInstanceOf("java.lang.NumberFormatException"));
+        Assert.True(ex.IsInstanceOf("java.lang.RuntimeException"));
+        Assert.False(ex.IsInstanceOf("java.io.IOException"));
+    }
+
+    [Fact]
+    public void LazyMessageAndFrames()
+    {
+        var integerCls = Jvm.GetClassInfo("java.lang.Integer");
+        var ex = Assert.Throws<JavaException>(() => integerCls.Call<int>("parseInt", "nope"));
+        Assert.StartsWith("java.lang.NumberFormatException", ex.Message);
+        Assert.Contains("\"nope\"", ex.Message);
+        Assert.Contains(ex.Frames, f => f.ClassName == "java.lang.Integer" && f.MethodName == "parseInt");
+        Assert.Contains("java.lang.Integer.parseInt", ex.JavaStackTrace);
+        Assert.Null(ex.Cause);
+    }
+}
@@ -0,0 +1,32 @@
+using Xunit;
+
+namespace Mud.Test.Core;
+
+[Collection("Serial")]
+public class FastCallTest : BaseTest
+{
+    [Fact]
+    public void StaticPrimitiveCalls()
+    {
+        var mathCls = Jvm.GetClassInfo("java.lang.Math");
+        Assert.Equal(2.0, mathCls.Call<double, double>("abs", -2.0));
+        Assert.Equal(7, mathCls.Call<int, int, int>("max", 3, 7));
+        Assert.Equal(8.0, mathCls.Call<double, double, double>("pow", 2.0, 3.0), 1.0e-9);
+
+        var integerCls = Jvm.GetClassInfo("java.lang.Integer");
+        Assert.Equal(42, integerCls.Call<int, string>("parseInt", "42"));
+    }
+
+    [Fact]
+    public void InstanceCalls()
+    {
+        var strBldr = Jvm.GetClassInfo("java.lang.StringBuilder").Instance("Foo");
+        strBldr.CallVoid("trimToSize");
+        strBldr.CallVoid<int, char>("setCharAt", 0, 'B');
+        Assert.Equal(3, strBldr.Call<int>("length"));
+        Assert.Equal('o', strBldr.Call<char, int>("charAt", 1));
+        Assert.Equal("oo", strBldr.Call<string, int, int>("substring", 1, 3));
+        Assert.Equal(1, strBldr.Call<int, string>("indexOf", "o"));
+        Assert.Equal("Boo", strBldr.Call<string>("toString"));
+    }
+}
@@ -0,0 +1,57 @@
+using Mud.Types;
+using Xunit;
+
+namespace Mud.Test.Core;
+
+[Collection("Serial")]
+public class FieldLayoutTest : BaseTest
+{
+    private struct Bounds
+    {
+        [JavaName("x")] public int X;
+        [JavaName("y")] public int Y;
+        [JavaName("width")] public int Width;
+        [JavaName("height")] public int Height;
+    }
+
+    [Fact]
+    public void ReadWriteSingle()
+    {
+        var rect = Jvm.GetClassInfo("java.awt.Rectangle").Instance(1, 2, 3, 4);
+        var bounds = rect.GetFields<Bounds>();
+        Assert.Equal(new Bounds { X = 1, Y = 2, Width = 3, Height = 4 }, bounds);
+
+        rect.SetFields(new Bounds { X = 5, Y = 6, Width = 7, Height = 8 });
+        Assert.Equal(7, rect.GetField<int>("width"));
+        Assert.Equal(8d, rect.Call<double>("getHeight"));
+    }
+
+    [Fact]
+    public void ReadWriteMany()
+    {
+        var rectCls = Jvm.GetClassInfo("java.awt.Rectangle");
+        var rects = Enumerable.Range(0, 200).Select(i => rectCls.Instance(i, i + 1, i + 2, i + 3)).ToArray();
+        var layout = rectCls.GetFieldLayout<Bounds>();
+        Assert.Same(layout, rectCls.GetFieldLayout<Bounds>());
+
+        var records = layout.Read(rects);
+        Assert.Equal(199, records[199].X);
+        Assert.Equal(202, records[199].Height);
+
+        for (var i = 0; i < records.Length; i++)
+        {
+            records[i].Width *= 2;
+        }
+        layout.Write(rects, records);
+        Assert.Equal(200, rects[99].GetField<int>("width"));
+    }
+
+    [Fact]
+    public void RejectsObjectsOfOtherClasses()
+    {
+        var layout = Jvm.GetClassInfo("java.awt.Rectangle").GetFieldLayout<Bounds>();
+        var point = Jvm.GetClassInfo("java.awt.Point").Instance(1, 2);
+        Assert.Throws<ArgumentException>(() => layout.Read(point));
+        Assert.Throws<ArgumentException>(() => layout.Write(new[] { point }, new Bounds[1]));
+    }
+}
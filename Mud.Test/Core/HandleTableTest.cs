@@ -0,0 +1,43 @@
+using Xunit;
+
+namespace Mud.Test.Core;
+
+[Collection("Serial")]
+public class HandleTableTest : BaseTest
+{
+    [Fact]
+    public void HandlesAreReleased()
+    {
+        GC.Collect();
+        GC.WaitForPendingFinalizers();
+        var before = Jvm.LiveHandles;
+
+        var integerCls = Jvm.GetClassInfo("java.lang.Integer");
+        var objs = Enumerable.Range(0, 1000).Select(i => integerCls.Instance(i)).ToList();
+        Assert.Equal(before + objs.Count, Jvm.LiveHandles);
+        Assert.Equal(999, objs[^1].Call<int>("intValue"));
+
+        objs.ForEach(o => o.Release());
+        Assert.Equal(before, Jvm.LiveHandles);
+    }
+
+    [Fact]
+    public void StaleHandlesAreRejected()
+    {
+        var integerCls = Jvm.GetClassInfo("java.lang.Integer");
+        var released = integerCls.Instance(1);
+        var stale = released.Handle;
+        released.Release();
+
+        // the freed slot is handed out again, with a new generation
+        var reused = integerCls.Instance(5);
+        Assert.Equal((uint)stale, (uint)reused.Handle);
+        Assert.NotEqual(stale, reused.Handle);
+
+        var live = Jvm.LiveHandles;
+        Assert.False(Jvm.ReleaseHandle(stale));
+        Assert.Equal(live, Jvm.LiveHandles);
+        Assert.Equal(5, reused.Call<int>("intValue"));
+        reused.Release();
+    }
+}
@@ -0,0 +1,90 @@
+using System.Runtime.CompilerServices;
+using Mud.Types;
+using Xunit;
+
+namespace Mud.Test.Core;
+
+[Collection("Serial")]
+public class IdentityMapTest : BaseTest
+{
+    private static readonly CustomType ListType = new("java.util.List");
+
+    private static IBoundObject EmptyList() =>
+        Jvm.GetClassInfo("java.util.Collections").Call("emptyList", ListType, Array.Empty<TypedArg>());
+
+    [Fact]
+    public void WrappersAreNewByDefault()
+    {
+        using var a = EmptyList();
+        using var b = EmptyList();
+        Assert.NotSame(a, b);
+    }
+
+    [Fact]
+    public void RepeatedReturnsShareAWrapper()
+    {
+        Jvm.PreserveIdentity = true;
+        try
+        {
+            var before = Jvm.LiveHandles;
+            var a = EmptyList();
+            var b = EmptyList();
+            Assert.Same(a, b);
+            Assert.Equal(before + 1, Jvm.LiveHandles);
+            a.Release();
+        }
+        finally
+        {
+            Jvm.PreserveIdentity = false;
+        }
+    }
+
+    [Fact]
+    public void ReleasedWrappersAreReplaced()
+    {
+        Jvm.PreserveIdentity = true;
+        try
+        {
+            var a = EmptyList();
+            a.Release();
+            using var b = EmptyList();
+            Assert.NotSame(a, b);
+            Assert.Equal(0, b.Call<int>("size"));
+        }
+        finally
+        {
+            Jvm.PreserveIdentity = false;
+        }
+    }
+
+    [Fact]
+    public void CollectedWrappersAreEvicted()
+    {
+        Jvm.PreserveIdentity = true;
+        try
+        {
+            var before = Jvm.MappedIdentities;
+            MapAndRelease();
+            GC.Collect();
+            GC.WaitForPendingFinalizers();
+            // the lookup removes the entries of collected wrappers before mapping the new one
+            using var list = EmptyList();
+            Assert.True(Jvm.MappedIdentities <= before + 1);
+        }
+        finally
+        {
+            Jvm.PreserveIdentity = false;
+        }
+    }
+
+    [MethodImpl(MethodImplOptions.NoInlining)]
+    private static void MapAndRelease()
+    {
+        for (var i = 0; i < 10; i++)
+        {
+            var builder = Jvm.GetClassInfo("java.lang.StringBuilder").Instance();
+            builder.Call("reverse", new CustomType("java.lang.StringBuilder"), Array.Empty<TypedArg>()).Release();
+            builder.Release();
+        }
+    }
+}
@@ -0,0 +1,93 @@
+using System.Runtime.CompilerServices;
+using Mud.Exceptions;
+using Mud.Types;
+using Xunit;
+
+namespace Mud.Test.Core;
+
+[Collection("Serial")]
+public class JvmScopeTest : BaseTest
+{
+    [Fact]
+    public void ScopedObjectsSkipTheHandleTable()
+    {
+        var integerCls = Jvm.GetClassInfo("java.lang.Integer");
+        var before = Jvm.LiveHandles;
+        IBoundObject scoped;
+        using (var scope = Jvm.Scope())
+        {
+            var objs = Enumerable.Range(0, 100).Select(i => integerCls.Instance(i)).ToList();
+            Assert.Equal(before, Jvm.LiveHandles);
+            Assert.Equal(100, scope.Count);
+            Assert.Equal(99, objs[^1].Call<int>("intValue"));
+            scoped = objs[0];
+        }
+        Assert.Equal(before, Jvm.LiveHandles);
+        // released along with the scope, so it no longer calls into java and releasing again is a no-op
+        Assert.Equal(scoped.ClassPath, scoped.ToString());
+        scoped.Release();
+    }
+
+    [Fact]
+    public void PromotedObjectsOutliveTheScope()
+    {
+        var before = Jvm.LiveHandles;
+        IBoundObject kept;
+        using (var scope = Jvm.Scope())
+        {
+            var builder = Jvm.GetClassInfo("java.lang.StringBuilder").Instance();
+            builder.Call("append", "mud");
+            kept = scope.Promote(builder);
+        }
+        Assert.Equal(before + 1, Jvm.LiveHandles);
+        Assert.Equal("mud", kept.ToString());
+        kept.Release();
+        Assert.Equal(before, Jvm.LiveHandles);
+    }
+
+    [Fact]
+    public void ExceptionsOutliveTheScope()
+    {
+        JavaException ex;
+        using (Jvm.Scope())
+        {
+            ex = Assert.Throws<JavaException>(() => Jvm.GetClassInfo("java.lang.Integer").Call<int, string>("parseInt", "nope"));
+        }
+        Assert.True(ex.IsInstanceOf<INumberFormatException>());
+    }
+
+    [Fact]
+    public void ScopesDisposeInOrder()
+    {
+        var outer = Jvm.Scope();
+        var inner = Jvm.Scope();
+        Assert.Throws<InvalidOperationException>(() => outer.Dispose());
+        inner.Dispose();
+        outer.Dispose();
+    }
+
+    [Fact]
+    public void CollectedObjectsAreReleasedWhenOptedIn()
+    {
+        GC.Collect();
+        GC.WaitForPendingFinalizers();
+        var before = Jvm.LiveHandles;
+        BindCollectable();
+        Assert.Equal(before + 1, Jvm.LiveHandles);
+
+        GC.Collect();
+        GC.WaitForPendingFinalizers();
+        // collected handles are released on the next promotion
+        using var next = Jvm.GetClassInfo("java.lang.Object").Instance();
+        Assert.Equal(before + 1, Jvm.LiveHandles);
+    }
+
+    [MethodImpl(MethodImplOptions.NoInlining)]
+    private static void BindCollectable() =>
+        Jvm.ReleaseWhenCollected(Jvm.GetClassInfo("java.lang.Object").Instance());
+
+    [ClassPath("java.lang.NumberFormatException")]
+    public interface INumberFormatException : IBoundObject
+    {
+    }
+}
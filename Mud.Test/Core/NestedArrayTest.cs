@@ -0,0 +1,56 @@
+using Mud.Exceptions;
+using Mud.Types;
+using Xunit;
+
+namespace Mud.Test.Core;
+
+[Collection("Serial")]
+public class NestedArrayTest : BaseTest
+{
+    private static readonly CustomType ObjectArray = new(new CustomType("java.lang.Object"));
+
+    private static T CopyOf<T>(object arr, int length) =>
+        Jvm.GetClassInfo("java.util.Arrays").Call<T>("copyOf", ObjectArray, new TypedArg[] { new(arr, ObjectArray), new(length) });
+
+    private static string DeepToString(object arr) =>
+        Jvm.GetClassInfo("java.util.Arrays").Call<string>("deepToString", new TypedArg[] { new(arr, ObjectArray) });
+
+    [Fact]
+    public void JaggedRoundTrip()
+    {
+        var rows = new[]
+        {
+            new[] { 1.2, 2.3, 4.5 },
+            null,
+            Array.Empty<double>(),
+            Enumerable.Range(0, 1000).Select(i => i * 0.25).ToArray()
+        };
+        var copy = CopyOf<double[]?[]>(rows, rows.Length);
+        Assert.Equal(rows, copy);
+        Assert.Equal("[[1, 2], null]", DeepToString(new[] { new[] { 1, 2 }, null }));
+    }
+
+    [Fact]
+    public void MultiDimensionalRoundTrip()
+    {
+        var values = new long[,] { { 1, 2, 3 }, { 4, 5, 6 } };
+        Assert.Equal("[[1, 2, 3], [4, 5, 6]]", DeepToString(values));
+        Assert.Equal(values, CopyOf<long[,]>(values, 2));
+        Assert.Equal(new long[0, 0], CopyOf<long[,]>(new long[0, 0], 0));
+    }
+
+    [Fact]
+    public void FromSpanAndShape()
+    {
+        using var arr = Jvm.NewArray<int>(Enumerable.Range(0, 12).ToArray(), new[] { 2, 2, 3 });
+        Assert.Equal("[[[0, 1, 2], [3, 4, 5]], [[6, 7, 8], [9, 10, 11]]]", DeepToString(arr));
+        Assert.Throws<ArgumentException>(() => Jvm.NewArray<int>(new[] { 1, 2, 3 }, new[] { 2, 2 }));
+    }
+
+    [Fact]
+    public void RaggedToMultiDimensionalThrows()
+    {
+        var rows = new[] { new[] { 1, 2 }, new[] { 3 } };
+        Assert.Throws<JavaException>(() => CopyOf<int[,]>(rows, rows.Length));
+    }
+}
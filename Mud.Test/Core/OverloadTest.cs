@@ -0,0 +1,62 @@
+using Mud.Exceptions;
+using Mud.Types;
+using Xunit;
+
+namespace Mud.Test.Core;
+
+[Collection("Serial")]
+public class OverloadTest : BaseTest
+{
+    [Fact]
+    public void BindsToInterfaceParameters()
+    {
+        var listCls = Jvm.GetClassInfo("java.util.ArrayList");
+        using var source = listCls.Instance();
+        using var target = listCls.Instance();
+        source.Call("add", "mud");
+        // addAll takes a java.util.Collection, not the ArrayList the call was made with
+        Assert.True(target.Call<bool>("addAll", source));
+        Assert.Equal(1, target.Call<int>("size"));
+    }
+
+    [Fact]
+    public void WidensPrimitives()
+    {
+        var math = Jvm.GetClassInfo("java.lang.Math");
+        // max(long, long) is the only overload returning a long
+        Assert.Equal(7L, math.Call<long>("max", 3, 7L));
+        Assert.Equal(7L, math.Call<long>("max", 7, 3L));
+    }
+
+    [Fact]
+    public void BoxesPrimitives()
+    {
+        using var list = Jvm.GetClassInfo("java.util.ArrayList").Instance();
+        // add(Object) with an Integer box, add(int, Object) takes two arguments
+        Assert.True(list.Call<bool>("add", 5));
+        Assert.Equal("[5]", list.ToString());
+    }
+
+    [Fact]
+    public void PrefersTheMostSpecificOverload()
+    {
+        var builderCls = Jvm.GetClassInfo("java.lang.StringBuilder");
+        using var builder = builderCls.Instance();
+        using var other = builderCls.Instance();
+        other.Call("append", "mud");
+        // append(CharSequence) is picked over append(Object), the builder's result is discarded
+        builder.Call("append", other);
+        builder.Call("append", other);
+        Assert.Equal("mudmud", builder.ToString());
+    }
+
+    [Fact]
+    public void MissingOverloadsThrow()
+    {
+        using var list = Jvm.GetClassInfo("java.util.ArrayList").Instance();
+        Assert.Throws<MemberNotFoundException>(() => list.Call<bool>("add", 1, 2, 3));
+        // the miss is cached and thrown again
+        Assert.Throws<MemberNotFoundException>(() => list.Call<bool>("add", 1, 2, 3));
+        Assert.Throws<MemberNotFoundException>(() => list.Call<bool>("add", new CustomType(JavaType.Bool), Array.Empty<TypedArg>()));
+    }
+}
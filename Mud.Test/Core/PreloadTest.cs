@@ -0,0 +1,70 @@
+using Mud.Types;
+using Xunit;
+
+namespace Mud.Test.Core;
+
+[Collection("Serial")]
+public class PreloadTest : BaseTest
+{
+    [Fact]
+    public void RecordsResolvedMembers()
+    {
+        var sb = Jvm.GetClassInfo("java.lang.StringBuilder").Instance("mud");
+        Assert.Equal(3, sb.Call<int>("length"));
+
+        var manifest = PreloadManifest.Record();
+        var recorded = Assert.Single(manifest.Classes, c => c.ClassPath == "java/lang/StringBuilder");
+        Assert.Contains(new PreloadMember("length", "()I", false), recorded.Methods);
+    }
+
+    [Fact]
+    public void SaveLoadRoundTrip()
+    {
+        var manifest = new PreloadManifest
+        {
+            Classes = new[]
+            {
+                new PreloadClass("java/lang/Integer",
+                    new[] { new PreloadMember("valueOf", "(I)Ljava/lang/Integer;", true) },
+                    new[] { new PreloadMember("MAX_VALUE", "I", true) })
+            },
+            BoundInterfaces = new[] { typeof(IBoundObject).AssemblyQualifiedName! }
+        };
+        var path = Path.GetTempFileName();
+        try
+        {
+            manifest.Save(path);
+            var loaded = PreloadManifest.Load(path);
+            var cls = Assert.Single(loaded.Classes);
+            Assert.Equal("java/lang/Integer", cls.ClassPath);
+            Assert.Equal(manifest.Classes[0].Methods, cls.Methods);
+            Assert.Equal(manifest.Classes[0].Fields, cls.Fields);
+            Assert.Equal(manifest.BoundInterfaces, loaded.BoundInterfaces);
+        }
+        finally
+        {
+            File.Delete(path);
+        }
+    }
+
+    [Fact]
+    public void PreloadSkipsMissingEntries()
+    {
+        var manifest = new PreloadManifest
+        {
+            Classes = new[]
+            {
+                new PreloadClass("java/lang/Integer",
+                    new[]
+                    {
+                        new PreloadMember("valueOf", "(I)Ljava/lang/Integer;", true),
+                        new PreloadMember("noSuchMethod", "()V", true)
+                    },
+                    new[] { new PreloadMember("MAX_VALUE", "I", true) }),
+                new PreloadClass("mud/NoSuchClass", Array.Empty<PreloadMember>(), Array.Empty<PreloadMember>())
+            }
+        };
+        Assert.Equal(2, Jvm.Preload(manifest, 2));
+        Assert.Equal(int.MaxValue, Jvm.GetClassInfo("java.lang.Integer").GetField<int>("MAX_VALUE"));
+    }
+}
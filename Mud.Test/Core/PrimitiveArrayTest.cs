@@ -0,0 +1,62 @@
+using Mud.Exceptions;
+using Mud.Types;
+using Xunit;
+
+namespace Mud.Test.Core;
+
+[Collection("Serial")]
+public class PrimitiveArrayTest : BaseTest
+{
+    [Fact]
+    public void DoubleArrayRoundTrip()
+    {
+        var values = Enumerable.Range(0, 100_000).Select(i => i * 0.5).ToArray();
+        var copy = Jvm.GetClassInfo("java.util.Arrays").Call<double[]>("copyOf", values, values.Length);
+        Assert.Equal(values, copy);
+    }
+
+    [Fact]
+    public void IntArrayRoundTrip()
+    {
+        var values = new[] { 5, -3, 12, int.MaxValue, int.MinValue };
+        var copy = Jvm.GetClassInfo("java.util.Arrays").Call<int[]>("copyOf", values, values.Length);
+        Assert.Equal(values, copy);
+    }
+
+    [Fact]
+    public void SpanReadWrite()
+    {
+        using var arr = Jvm.NewArray<double>(new[] { 1.0, 2.0, 3.0, 4.0 });
+        Assert.Equal(4, arr.ArrayLength);
+
+        arr.WriteArray<double>(new[] { 8.0, 9.0 }, 2);
+        Span<double> dest = stackalloc double[3];
+        arr.ReadArray(dest, 1);
+        Assert.Equal(new[] { 2.0, 8.0, 9.0 }, dest.ToArray());
+    }
+
+    [Fact]
+    public void PinnedWriteIsCopiedBack()
+    {
+        using var arr = Jvm.NewArray<double>(new[] { 1.0, 2.0, 3.0 });
+        using (var view = arr.Pin<double>())
+        {
+            view.Span[1] = 42.0;
+        }
+
+        var copy = Jvm.GetClassInfo("java.util.Arrays").Call<double[]>("copyOf", arr, 3);
+        Assert.Equal(new[] { 1.0, 42.0, 3.0 }, copy);
+    }
+
+    [Fact]
+    public void PinnedMisuse()
+    {
+        using var arr = Jvm.NewArray<int>(new[] { 1, 2, 3 });
+        Assert.Throws<ArrayPinException>(() => arr.Pin<double>());
+
+        var view = arr.Pin<int>(critical: true);
+        Assert.Throws<ArrayPinException>(() => Jvm.GetClassInfo("java.lang.Math").Call<double>("abs", -1.0) > 0);
+        view.Release(JavaReleaseMode.Abort);
+        Assert.Throws<ObjectDisposedException>(() => view.Span[0]);
+    }
+}
@@ -0,0 +1,98 @@
+using System.Buffers.Binary;
+using Mud.Types;
+using Xunit;
+
+namespace Mud.Test.Core;
+
+[Collection("Serial")]
+public class RingTest : BaseTest
+{
+    [Fact]
+    public void WriteReadAcrossWrap()
+    {
+        using var ring = JavaRing.Create(1024);
+        Assert.Equal(1024, ring.Capacity);
+
+        var written = 0;
+        var read = 0;
+        var payload = new byte[300];
+        var expected = new byte[300];
+        while (read < 1000)
+        {
+            // uneven lengths keep messages landing on the end of the ring
+            while (written < 1000 && ring.TryWrite(Message(written, payload)))
+            {
+                written++;
+            }
+            ring.Read(message =>
+            {
+                Assert.Equal(Message(read, expected).ToArray(), message.ToArray());
+                read++;
+            });
+        }
+        Assert.Equal(0, ring.Readable);
+    }
+
+    [Fact]
+    public void JavaSeesMessagesInPlace()
+    {
+        using var ring = JavaRing.Create(256);
+        Assert.True(ring.TryWrite(5, 0x11223344, (span, val) =>
+        {
+            BinaryPrimitives.WriteInt32LittleEndian(span, val);
+            span[4] = 7;
+        }));
+
+        // the header sits in front of the data, the message is its length followed by the payload
+        Assert.Equal(16L, ring.Buffer.Call<long, int>("getLong", 0));
+        Assert.Equal(5, ring.Buffer.Call<int, int>("getInt", 256));
+        Assert.Equal(0x11223344, ring.Buffer.Call<int, int>("getInt", 260));
+        Assert.Equal(16L, Jvm.GetClassInfo("mud.NativeRing").Call<long>("awaitReadable", ring.Address, 0L));
+    }
+
+    [Fact]
+    public void JavaReleasesSpace()
+    {
+        using var ring = JavaRing.Create(256);
+        Assert.True(ring.TryWrite(new byte[100]));
+        Assert.False(ring.TryWrite(new byte[120]));
+
+        // java consuming is moving the tail up to the head
+        var head = ring.Buffer.Call<long, int>("getLong", 0);
+        // putLong returns the buffer itself
+        ring.Buffer.Call<IBoundObject>("putLong", new CustomType("java.nio.ByteBuffer"), new TypedArg[] { new(64), new(head) })
+            .Release();
+        Assert.Equal(0, ring.Readable);
+        Assert.True(ring.TryWrite(new byte[120]));
+    }
+
+    [Fact]
+    public void WaitReadableWakesOnWrite()
+    {
+        using var ring = JavaRing.Create(256);
+        Assert.False(ring.WaitReadable(TimeSpan.FromMilliseconds(10)));
+
+        var waiter = Task.Run(() => ring.WaitReadable(TimeSpan.FromSeconds(10)));
+        Thread.Sleep(50);
+        Assert.True(ring.TryWrite(new byte[] { 1 }));
+        Assert.True(waiter.Wait(TimeSpan.FromSeconds(10)));
+        Assert.True(waiter.Result);
+    }
+
+    [Fact]
+    public void OversizedMessageThrows()
+    {
+        using var ring = JavaRing.Create(256);
+        Assert.Throws<ArgumentOutOfRangeException>(() => ring.TryWrite(new byte[ring.MaxMessageLength + 1]));
+    }
+
+    private static ReadOnlySpan<byte> Message(int index, byte[] payload)
+    {
+        var length = 1 + index * 7 % 251;
+        for (var i = 0; i < length; i++)
+        {
+            payload[i] = (byte)(index + i);
+        }
+        return payload.AsSpan(0, length);
+    }
+}
@@ -0,0 +1,49 @@
+using Mud.Test.Core.Interfaces;
+using Mud.Types;
+using Xunit;
+
+namespace Mud.Test.Core;
+
+[Collection("Serial")]
+public class SourceGenTest : BaseTest
+{
+    [ClassPath("java.util.ArrayList")]
+    public interface IJavaList<T>
+    {
+        [JavaName("size")]
+        public int Size();
+    }
+
+    [Fact]
+    public void InterfaceUsesGeneratedType()
+    {
+        var strBldr = ClassInfo<IStringBuilder>.Instance("Foo");
+        Assert.False(strBldr.GetType().Assembly.IsDynamic);
+        Assert.Equal("Mud.Generated", strBldr.GetType().Namespace);
+        Assert.Equal("Foo+Bar", strBldr.Append('+').Append("Bar").ToString());
+    }
+
+    [Fact]
+    public void ReturnedObjectUsesGeneratedType()
+    {
+        var genericResp = ClassInfo<IStringBuilder>.Instance("Foo").AppendWithGenericResp("Bar");
+        var strBldr = Assert.IsAssignableFrom<IStringBuilder>(genericResp);
+        Assert.False(strBldr.GetType().Assembly.IsDynamic);
+    }
+
+    [Fact]
+    public void GeneratedStaticMembers()
+    {
+        Assert.Equal(Math.PI, ClassInfo<IMath>.Static.Pi);
+        Assert.Equal(1d, ClassInfo<IMath>.Static.Cos(0));
+        Assert.Equal(5, ClassInfo<IInteger>.Static.ValueOf(5).IntValue());
+    }
+
+    [Fact]
+    public void GenericInterfaceFallsBackToTypeGen()
+    {
+        var list = ClassInfo<IJavaList<string>>.Instance();
+        Assert.True(list.GetType().Assembly.IsDynamic);
+        Assert.Equal(0, list.Size());
+    }
+}
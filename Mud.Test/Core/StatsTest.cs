@@ -0,0 +1,49 @@
+using System.Diagnostics.Metrics;
+using Mud.Types;
+using Xunit;
+
+namespace Mud.Test.Core;
+
+[Collection("Serial")]
+public class StatsTest : BaseTest
+{
+    [Fact]
+    public void CountsCalls()
+    {
+        var mathCls = Jvm.GetClassInfo("java.lang.Math");
+        mathCls.Call<double>("abs", -1.0);
+        var before = Jvm.Stats;
+        for (var i = 0; i < 10; i++)
+        {
+            mathCls.Call<double>("abs", -1.0);
+        }
+        var after = Jvm.Stats;
+
+        Assert.True(after.CallsByType[JavaType.Double] - before.CallsByType[JavaType.Double] >= 10);
+        Assert.True(after.Transitions - before.Transitions >= 10);
+        // the method id is cached after the first call
+        Assert.Equal(before.MethodLookups, after.MethodLookups);
+    }
+
+    [Fact]
+    public void PublishesInstruments()
+    {
+        var seen = new HashSet<string>();
+        using var listener = new MeterListener();
+        listener.InstrumentPublished = (instrument, l) =>
+        {
+            if (instrument.Meter == Jvm.Meter)
+            {
+                l.EnableMeasurementEvents(instrument);
+            }
+        };
+        listener.SetMeasurementEventCallback<long>((instrument, _, _, _) => seen.Add(instrument.Name));
+        listener.Start();
+
+        Jvm.GetClassInfo("java.lang.Math").Call<double>("abs", -1.0);
+        listener.RecordObservableInstruments();
+        Assert.Contains("mud.transitions", seen);
+        Assert.Contains("mud.calls", seen);
+        Assert.Contains("mud.refs", seen);
+    }
+}
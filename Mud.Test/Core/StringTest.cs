@@ -0,0 +1,49 @@
+using Xunit;
+
+namespace Mud.Test.Core;
+
+[Collection("Serial")]
+public class StringTest : BaseTest
+{
+    [Theory]
+    [InlineData("")]
+    [InlineData("plain ascii")]
+    [InlineData("naïve café – ünïcödé")]
+    [InlineData("emoji 🙂 and 漢字")]
+    public void RoundTrip(string value)
+    {
+        var strBldr = Jvm.GetClassInfo("java.lang.StringBuilder").Instance(value);
+        Assert.Equal(value, strBldr.ToString());
+        Assert.Equal(value.Length, strBldr.Call<int>("length"));
+    }
+
+    [Fact]
+    public void LongRoundTrip()
+    {
+        var value = string.Concat(Enumerable.Repeat("ß0123456789", 100));
+        var strBldr = Jvm.GetClassInfo("java.lang.StringBuilder").Instance(value);
+        Assert.Equal(value, strBldr.ToString());
+    }
+
+    [Fact]
+    public void ConstantStringCache()
+    {
+        var integerCls = Jvm.GetClassInfo("java.lang.Integer");
+        Jvm.AddConstantStrings("42");
+        try
+        {
+            for (var i = 0; i < 10; i++)
+            {
+                Assert.Equal(42, integerCls.Call<int>("parseInt", "42"));
+                Assert.Equal(42, integerCls.Call<int, string>("parseInt", "42"));
+            }
+            // equal strings built at runtime reuse the cached java string, others are allocated per call
+            Assert.Equal(42, integerCls.Call<int>("parseInt", 42.ToString()));
+            Assert.Equal(7, integerCls.Call<int>("parseInt", 7.ToString()));
+        }
+        finally
+        {
+            Jvm.ClearConstantStrings();
+        }
+    }
+}
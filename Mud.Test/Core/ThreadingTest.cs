@@ -0,0 +1,39 @@
+using Mud.Test.Core.Interfaces;
+using Xunit;
+
+namespace Mud.Test.Core;
+
+[Collection("Serial")]
+public class ThreadingTest : BaseTest
+{
+    [Fact]
+    public void ParallelStaticCalls()
+    {
+        var results = new double[64];
+        Parallel.For(0, results.Length, i =>
+        {
+            results[i] = ClassInfo<IMath>.Static.Cos(i);
+        });
+
+        for (var i = 0; i < results.Length; i++)
+        {
+            Assert.Equal(Math.Cos(i), results[i], 1.0e-12);
+        }
+    }
+
+    [Fact]
+    public void DedicatedThreadAttachAndDetach()
+    {
+        var thread = new Thread(() =>
+        {
+            Jvm.AttachCurrentThread(asDaemon: false);
+            var strBldr = ClassInfo<IStringBuilder>.Instance("Foo");
+            strBldr.Append("Bar");
+            Assert.Equal("FooBar", strBldr.ToString());
+            strBldr.Release();
+            Jvm.DetachCurrentThread();
+        });
+        thread.Start();
+        thread.Join();
+    }
+}
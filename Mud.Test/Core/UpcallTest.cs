@@ -0,0 +1,67 @@
+using Mud.Exceptions;
+using Mud.Types;
+using Xunit;
+
+namespace Mud.Test.Core;
+
+[Collection("Serial")]
+public class UpcallTest : BaseTest
+{
+    private static readonly CustomType ObjectType = new("java.lang.Object");
+
+    [Fact]
+    public void ImplementsInterface()
+    {
+        using var upper = JavaProxy.Create("java.util.function.Function", call => call.Arg<string>(0).ToUpper());
+        var optionalType = new CustomType("java.util.Optional");
+        var optional = Jvm.GetClassInfo("java.util.Optional")
+            .Call<BoundObject>("of", optionalType, new TypedArg[] { new("mud", "java.lang.Object") });
+        var mapped = optional.Call("map", optionalType, new TypedArg[] { new(upper.Object, "java.util.function.Function") });
+
+        Assert.Equal("MUD", mapped.Call<string>("get", ObjectType, Array.Empty<TypedArg>()));
+        Assert.Equal(upper.Object.Call<int>("hashCode"), upper.Object.Call<int>("hashCode"));
+    }
+
+    [Fact]
+    public void ReceivesCallsFromJavaThreads()
+    {
+        var calls = 0;
+        using var runnable = JavaProxy.Create("java.lang.Runnable", _ =>
+        {
+            Interlocked.Increment(ref calls);
+            return null;
+        });
+        var thread = Jvm.GetClassInfo("java.lang.Thread").Instance(new TypedArg[] { new(runnable.Object, "java.lang.Runnable") });
+        thread.Call("start");
+        thread.Call("join");
+        thread.Call("run");
+        Assert.Equal(2, calls);
+    }
+
+    [Fact]
+    public void PrimitivesAreBoxed()
+    {
+        using var comparator = JavaProxy.Create("java.util.Comparator", call => call.Arg<int>(1).CompareTo(call.Arg<int>(0)));
+        var integerCls = Jvm.GetClassInfo("java.lang.Integer");
+        var list = Jvm.GetClassInfo("java.util.ArrayList").Instance();
+        foreach (var i in new[] { 3, 1, 2 })
+        {
+            var boxed = integerCls.Call<BoundObject>("valueOf", new CustomType("java.lang.Integer"), new TypedArg[] { new(i) });
+            list.Call<bool>("add", new TypedArg[] { new(boxed, "java.lang.Object") });
+        }
+        list.Call("sort", new TypedArg[] { new(comparator.Object, "java.util.Comparator") });
+        Assert.Equal("[3, 2, 1]", list.ToString());
+    }
+
+    [Fact]
+    public void HandlerExceptionsReachJava()
+    {
+        var supplier = JavaProxy.Create("java.util.function.Supplier", _ => throw new InvalidOperationException("nope"));
+        var ex = Assert.Throws<JavaException>(() => supplier.Object.Call("get", ObjectType, Array.Empty<TypedArg>()));
+        Assert.True(ex.IsInstanceOf("java.lang.RuntimeException"));
+        Assert.Contains("nope", ex.Message);
+
+        supplier.Dispose();
+        Assert.True(supplier.IsDisposed);
+    }
+}
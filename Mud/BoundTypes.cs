@@ -0,0 +1,51 @@
+using System.Collections.Concurrent;
+using System.ComponentModel;
+using System.Diagnostics.CodeAnalysis;
+using Mud.Types;
+
+namespace Mud;
+
+/// <summary>
+/// Implementations of bound interfaces generated at build time by Mud.SourceGen, registered from the generated module
+/// initializer of the assembly declaring the interfaces. Interfaces without one are built at runtime by TypeGen
+/// </summary>
+[EditorBrowsable(EditorBrowsableState.Never)]
+public static class BoundTypes
+{
+    private static readonly ConcurrentDictionary<Type, Func<BoundObject>> Factories = new();
+
+    /// <summary>
+    /// Registers the generated implementation of a bound interface
+    /// </summary>
+    /// <param name="factory">Creates an unbound instance of the implementation</param>
+    /// <param name="classPaths">The class paths of the interface's ClassPathAttributes</param>
+    /// <typeparam name="T">The bound interface</typeparam>
+    public static void Register<T>(Func<BoundObject> factory, params string[] classPaths) where T : class
+    {
+        Factories[typeof(T)] = factory;
+        foreach (var classPath in classPaths)
+        {
+            ClassPathRegistry.Register(classPath, typeof(T));
+        }
+    }
+
+    /// <summary>
+    /// Whether an implementation was generated for the interface
+    /// </summary>
+    internal static bool IsGenerated(Type target) => Factories.ContainsKey(target);
+
+    /// <summary>
+    /// Creates an unbound instance of the interface's generated implementation
+    /// </summary>
+    /// <returns>False when no implementation was generated for the interface</returns>
+    internal static bool TryCreate(Type target, [NotNullWhen(true)] out BoundObject? obj)
+    {
+        if (Factories.TryGetValue(target, out var factory))
+        {
+            obj = factory();
+            return true;
+        }
+        obj = null;
+        return false;
+    }
+}
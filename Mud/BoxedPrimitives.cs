@@ -0,0 +1,150 @@
+using System.Collections;
+using System.Collections.Concurrent;
+using System.Runtime.InteropServices;
+using Mud.Types;
+
+namespace Mud;
+
+/// <summary>
+/// Marshals java boxed primitives without binding them, an int? is boxed and unboxed by the clib through method ids it
+/// looked up once, and arrays or collections of boxes are unboxed into a primitive buffer in a single native loop
+/// </summary>
+internal static unsafe class BoxedPrimitives
+{
+    private static readonly ConcurrentDictionary<Type, Func<Array, object>> ListFactories = new();
+
+    /// <summary>
+    /// Boxes the primitive into an instance of the boxing class, e.g. java.lang.Integer for an int
+    /// </summary>
+    /// <param name="val">The primitive, converted to the boxed type when it is another primitive</param>
+    /// <param name="type">The java primitive type that is boxed</param>
+    /// <returns>The box's local ref</returns>
+    internal static IntPtr Box(object val, JavaType type)
+    {
+        if (!TypeMap.TryGetBlittablePrimitive(val.GetType(), out var valType) || valType != type)
+        {
+            val = Convert.ChangeType(val is char c ? (int)c : val, ClrType(type));
+        }
+        var boxed = MudNative.Box(Jvm.Env, JavaVal.MapFrom(val), type);
+        if (boxed == IntPtr.Zero)
+        {
+            Jvm.ThrowException(MudInterface.check_exception(Jvm.Env));
+        }
+        return boxed;
+    }
+
+    /// <summary>
+    /// Unboxes a java box, numeric types accept any java.lang.Number and convert it as its xxxValue method does
+    /// </summary>
+    /// <param name="boxed">The box</param>
+    /// <param name="type">The java primitive type to unbox to</param>
+    /// <returns>The primitive</returns>
+    /// <exception cref="Mud.Exceptions.JavaException">Throws if the object is not a box of the type</exception>
+    internal static object Unbox(IntPtr boxed, JavaType type)
+    {
+        var resp = MudNative.Unbox(Jvm.Env, boxed, type);
+        if (resp.IsException)
+        {
+            Jvm.ThrowException(resp.Value.Object);
+        }
+        return TypeMap.MapJValue(type, typeof(object), resp.Value);
+    }
+
+    /// <summary>
+    /// Copies a java primitive array, array of boxes or collection of boxes into a .NET array
+    /// </summary>
+    /// <param name="obj">The java array or java.util.Collection</param>
+    /// <param name="elemType">Element type of the .NET array</param>
+    /// <param name="type">The java primitive type of the elements</param>
+    /// <returns>The .NET array</returns>
+    /// <exception cref="Mud.Exceptions.JavaException">Throws if the object holds nulls or values of another type</exception>
+    internal static Array ReadArray(IntPtr obj, Type elemType, JavaType type)
+    {
+        IntPtr boxes;
+        var length = MudNative.BoxedLength(Jvm.Env, obj, type, &boxes);
+        if (length < 0)
+        {
+            Jvm.ThrowException(MudInterface.check_exception(Jvm.Env));
+        }
+        var arr = Array.CreateInstance(elemType, (int)length);
+        if (boxes == IntPtr.Zero)
+        {
+            Jvm.ReadPrimitiveArray(obj, type, 0, (int)length, ref MemoryMarshal.GetArrayDataReference(arr));
+            return arr;
+        }
+        try
+        {
+            fixed (byte* values = &MemoryMarshal.GetArrayDataReference(arr))
+            {
+                Jvm.ThrowException(MudNative.UnboxArray(Jvm.Env, boxes, (nuint)length, values, type));
+            }
+        }
+        finally
+        {
+            MudNative.ReleaseObj(Jvm.Env, boxes);
+        }
+        return arr;
+    }
+
+    /// <summary>
+    /// Copies a java primitive array, array of boxes or collection of boxes into a List
+    /// </summary>
+    /// <param name="obj">The java array or java.util.Collection</param>
+    /// <param name="elemType">Element type of the List</param>
+    /// <param name="type">The java primitive type of the elements</param>
+    /// <returns>The List</returns>
+    internal static object ReadList(IntPtr obj, Type elemType, JavaType type)
+    {
+        var values = ReadArray(obj, elemType, type);
+        return ListFactories.GetOrAdd(elemType, t => typeof(BoxedPrimitives)
+            .GetMethod(nameof(NewList), System.Reflection.BindingFlags.NonPublic | System.Reflection.BindingFlags.Static)!
+            .MakeGenericMethod(t).CreateDelegate<Func<Array, object>>())(values);
+    }
+
+    private static object NewList<T>(Array values) => new List<T>((T[])values);
+
+    /// <summary>
+    /// Creates a java.util.ArrayList of the boxed values
+    /// </summary>
+    /// <param name="values">The values</param>
+    /// <param name="elemType">Element type of the values</param>
+    /// <param name="type">The java primitive type of the elements</param>
+    /// <returns>The list's local ref</returns>
+    internal static IntPtr BoxList(IEnumerable values, Type elemType, JavaType type)
+    {
+        Array arr;
+        if (values is ICollection collection)
+        {
+            arr = Array.CreateInstance(elemType, collection.Count);
+            collection.CopyTo(arr, 0);
+        }
+        else
+        {
+            var items = values.Cast<object>().ToArray();
+            arr = Array.CreateInstance(elemType, items.Length);
+            Array.Copy(items, arr, items.Length);
+        }
+        IntPtr list;
+        fixed (byte* ptr = &MemoryMarshal.GetArrayDataReference(arr))
+        {
+            list = MudNative.BoxList(Jvm.Env, (nuint)arr.Length, ptr, type);
+        }
+        if (list == IntPtr.Zero)
+        {
+            Jvm.ThrowException(MudInterface.check_exception(Jvm.Env));
+        }
+        return list;
+    }
+
+    private static Type ClrType(JavaType type) => type switch
+    {
+        JavaType.Int => typeof(int),
+        JavaType.Bool => typeof(bool),
+        JavaType.Byte => typeof(byte),
+        JavaType.Char => typeof(char),
+        JavaType.Short => typeof(short),
+        JavaType.Long => typeof(long),
+        JavaType.Float => typeof(float),
+        _ => typeof(double)
+    };
+}
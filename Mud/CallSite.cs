@@ -0,0 +1,429 @@
+using System.ComponentModel;
+using System.Reflection;
+using System.Runtime.CompilerServices;
+using Mud.Exceptions;
+using Mud.Types;
+
+namespace Mud;
+
+/// <summary>
+/// A bound interface method whose JNI signature is computed once when the bound type is built
+/// and whose method pointer is resolved on the first call. Public for the bound types generated by Mud.SourceGen.
+///
+/// The typed Invoke overloads take up to four arguments without boxing them, primitives and strings are written straight
+/// into their JavaVal and any other argument is mapped against the parameter's java type
+/// </summary>
+[EditorBrowsable(EditorBrowsableState.Never)]
+public sealed unsafe class CallSite
+{
+    private readonly Type _target;
+    private readonly string _name;
+    private readonly bool _isStatic;
+    private readonly Type _returnClrType;
+    private readonly CustomType _returnType;
+    private readonly CustomType[] _paramTypes;
+    
+    /// <summary>
+    /// The precomputed signature, null when a parameter's java type depends on the object passed in
+    /// </summary>
+    private readonly string? _signature;
+    
+    /// <summary>
+    /// The interface's java class, static methods are called on it
+    /// </summary>
+    private ClassInfo? _cls;
+
+    /// <summary>
+    /// The method pointer and the class it was resolved against, instance methods resolve against the target's class
+    /// </summary>
+    private Resolved? _resolved;
+
+    private sealed record Resolved(ClassInfo Cls, IntPtr Method);
+
+    /// <summary>
+    /// Most arguments the typed Invoke overloads take
+    /// </summary>
+    internal const int MaxTypedArgs = 4;
+
+    /// <summary>
+    /// Whether the signature depends on the objects passed in, the typed overloads then box the arguments anyway
+    /// </summary>
+    internal bool IsDynamic => _signature == null;
+
+    private CallSite(Type target, string name, bool isStatic, Type returnClrType, CustomType returnType, CustomType[] paramTypes, string? signature)
+    {
+        _target = target;
+        _name = name;
+        _isStatic = isStatic;
+        _returnClrType = returnClrType;
+        _returnType = returnType;
+        _paramTypes = paramTypes;
+        _signature = signature;
+    }
+
+    /// <summary>
+    /// Builds the call site of a generated bound type, whose signature was computed at build time
+    /// </summary>
+    /// <param name="target">The bound interface</param>
+    /// <param name="name">Name of the java method</param>
+    /// <param name="isStatic">Whether the java method is static</param>
+    /// <param name="returnClrType">The interface method's return type</param>
+    /// <param name="returnType">The java return type</param>
+    /// <param name="paramTypes">The java parameter types</param>
+    /// <param name="signature">The method's signature, null when a parameter's java type depends on the object passed in</param>
+    public static CallSite Generated(Type target, string name, bool isStatic, Type returnClrType, CustomType returnType,
+        CustomType[] paramTypes, string? signature) =>
+        new(target, name, isStatic, returnClrType, returnType, paramTypes, signature);
+
+    /// <summary>
+    /// Builds the call site for the provided interface method
+    /// </summary>
+    /// <param name="target">The bound interface</param>
+    /// <param name="methodInfo">The interface method</param>
+    /// <param name="name">Name of the java method</param>
+    internal static CallSite For(Type target, MethodInfo methodInfo, string name)
+    {
+        var returnType = TypeMap.MapToType(methodInfo.ReturnType, methodInfo.GetCustomAttributes<JavaTypeAttribute>().LastOrDefault()?.ClassPath);
+        var isStatic = methodInfo.GetCustomAttributes<JavaStaticAttribute>().LastOrDefault() != null;
+        var parameters = methodInfo.GetParameters();
+        var dynamicSignature = false;
+        var paramTypes = new CustomType[parameters.Length];
+        for (var i = 0; i < parameters.Length; i++)
+        {
+            var classPath = parameters[i].GetCustomAttribute<JavaTypeAttribute>()?.ClassPath;
+            // an untyped bound object parameter takes its java type from the object that's passed in
+            dynamicSignature |= classPath == null && parameters[i].ParameterType.IsAssignableTo(typeof(IBoundObject));
+            paramTypes[i] = TypeMap.MapToType(parameters[i].ParameterType, classPath);
+        }
+        return new CallSite(target, name, isStatic, methodInfo.ReturnType, returnType, paramTypes,
+            dynamicSignature ? null : TypeMap.GenMethodSignature(returnType, paramTypes));
+    }
+
+    /// <summary>
+    /// Gets the method pointer, resolving it against the class on first use and again when called on another class
+    /// </summary>
+    /// <param name="cls">The target object's class, or the interface's class for static methods</param>
+    /// <param name="args">The call's arguments, only read when the signature depends on them</param>
+    private IntPtr GetMethod(ClassInfo cls, object?[]? args)
+    {
+        if (_resolved is { } resolved && resolved.Cls == cls)
+        {
+            return resolved.Method;
+        }
+        if (_signature != null)
+        {
+            var method = cls.GetMethodPtr(_name, _signature, _isStatic);
+            _resolved = new Resolved(cls, method);
+            return method;
+        }
+
+        var argTypes = new CustomType[args!.Length];
+        for (var i = 0; i < args.Length; i++)
+        {
+            argTypes[i] = args[i] is IBoundObject obj ? new CustomType(obj.ClassPath) : _paramTypes[i];
+        }
+        return cls.GetMethodPtr(_name, TypeMap.GenMethodSignature(_returnType, argTypes), _isStatic);
+    }
+
+    private object Invoke(IntPtr objOrCls, ClassInfo cls, object?[] args)
+    {
+        var method = GetMethod(cls, args);
+        var type = _returnType.Type;
+        // args are mapped against the parameters' java types, so e.g. an int? is boxed for a java.lang.Integer
+        var typedArgs = new TypedArg[args.Length];
+        for (var i = 0; i < args.Length; i++)
+        {
+            typedArgs[i] = new TypedArg(args[i], _paramTypes[i]);
+        }
+        return Jvm.UsingArgs(type, _returnClrType, typedArgs, jArgs => _isStatic
+            ? MudInterface.call_static_method(Jvm.Env, objOrCls, method, type, jArgs)
+            : MudInterface.call_method(Jvm.Env, objOrCls, method, type, jArgs));
+    }
+
+    /// <summary>
+    /// Calls the method with the already mapped arguments
+    /// </summary>
+    private TRet Call<TRet>(IntPtr objOrCls, ClassInfo cls, Span<JavaVal> args)
+    {
+        var method = GetMethod(cls, null);
+        JavaCallResp resp;
+        fixed (JavaVal* argsPtr = args)
+        {
+            resp = _isStatic
+                ? MudNative.CallStaticMethod(Jvm.Env, objOrCls, method, _returnType.Type, argsPtr)
+                : MudNative.CallMethod(Jvm.Env, objOrCls, method, _returnType.Type, argsPtr);
+        }
+        if (resp.IsException)
+        {
+            Jvm.ThrowException(resp.Value.Object);
+        }
+        // primitives and void are read straight out of the JavaVal
+        return _returnType.Type != JavaType.Object
+            ? FastCall.MapReturn<TRet>(resp.Value)
+            : (TRet)TypeMap.MapJValue(_returnType.Type, _returnClrType, resp.Value);
+    }
+
+    /// <summary>
+    /// Writes the argument into its JavaVal, arguments the allocation free call path can't take are mapped against the
+    /// parameter's java type and any object allocated for them is added to pointers
+    /// </summary>
+    /// <returns>Whether the slot owns a java object that FastCall.ReleaseArgs must release</returns>
+    [MethodImpl(MethodImplOptions.AggressiveInlining)]
+    private bool SetArg<T>(ref JavaVal slot, T val, int index, ref List<IntPtr>? pointers)
+    {
+        // a primitive passed for a boxed parameter, e.g. an int for a java.lang.Integer, is mapped rather than written as is
+        if (FastCall.IsArg<T>() && (typeof(T) == typeof(string) || _paramTypes[index].Type != JavaType.Object))
+        {
+            return FastCall.SetArg(ref slot, val);
+        }
+        slot = Jvm.MapArg(new TypedArg(val, _paramTypes[index]), pointers ??= new List<IntPtr>());
+        return false;
+    }
+
+    private TRet Call<TRet>(IntPtr objOrCls, ClassInfo cls)
+    {
+        Jvm.EnsureInit();
+        return Call<TRet>(objOrCls, cls, Span<JavaVal>.Empty);
+    }
+
+    private TRet Call<TRet, T1>(IntPtr objOrCls, ClassInfo cls, T1 arg1)
+    {
+        Jvm.EnsureInit();
+        Span<JavaVal> args = stackalloc JavaVal[1];
+        var owned = 0;
+        List<IntPtr>? pointers = null;
+        try
+        {
+            owned |= SetArg(ref args[0], arg1, 0, ref pointers) ? 1 : 0;
+            return Call<TRet>(objOrCls, cls, args);
+        }
+        finally
+        {
+            FastCall.ReleaseArgs(args, owned);
+            Jvm.ReleaseArgs(pointers);
+        }
+    }
+
+    private TRet Call<TRet, T1, T2>(IntPtr objOrCls, ClassInfo cls, T1 arg1, T2 arg2)
+    {
+        Jvm.EnsureInit();
+        Span<JavaVal> args = stackalloc JavaVal[2];
+        var owned = 0;
+        List<IntPtr>? pointers = null;
+        try
+        {
+            owned |= SetArg(ref args[0], arg1, 0, ref pointers) ? 1 : 0;
+            owned |= SetArg(ref args[1], arg2, 1, ref pointers) ? 1 << 1 : 0;
+            return Call<TRet>(objOrCls, cls, args);
+        }
+        finally
+        {
+            FastCall.ReleaseArgs(args, owned);
+            Jvm.ReleaseArgs(pointers);
+        }
+    }
+
+    private TRet Call<TRet, T1, T2, T3>(IntPtr objOrCls, ClassInfo cls, T1 arg1, T2 arg2, T3 arg3)
+    {
+        Jvm.EnsureInit();
+        Span<JavaVal> args = stackalloc JavaVal[3];
+        var owned = 0;
+        List<IntPtr>? pointers = null;
+        try
+        {
+            owned |= SetArg(ref args[0], arg1, 0, ref pointers) ? 1 : 0;
+            owned |= SetArg(ref args[1], arg2, 1, ref pointers) ? 1 << 1 : 0;
+            owned |= SetArg(ref args[2], arg3, 2, ref pointers) ? 1 << 2 : 0;
+            return Call<TRet>(objOrCls, cls, args);
+        }
+        finally
+        {
+            FastCall.ReleaseArgs(args, owned);
+            Jvm.ReleaseArgs(pointers);
+        }
+    }
+
+    private TRet Call<TRet, T1, T2, T3, T4>(IntPtr objOrCls, ClassInfo cls, T1 arg1, T2 arg2, T3 arg3, T4 arg4)
+    {
+        Jvm.EnsureInit();
+        Span<JavaVal> args = stackalloc JavaVal[4];
+        var owned = 0;
+        List<IntPtr>? pointers = null;
+        try
+        {
+            owned |= SetArg(ref args[0], arg1, 0, ref pointers) ? 1 : 0;
+            owned |= SetArg(ref args[1], arg2, 1, ref pointers) ? 1 << 1 : 0;
+            owned |= SetArg(ref args[2], arg3, 2, ref pointers) ? 1 << 2 : 0;
+            owned |= SetArg(ref args[3], arg4, 3, ref pointers) ? 1 << 3 : 0;
+            return Call<TRet>(objOrCls, cls, args);
+        }
+        finally
+        {
+            FastCall.ReleaseArgs(args, owned);
+            Jvm.ReleaseArgs(pointers);
+        }
+    }
+
+    /// <summary>
+    /// The target's class, which the method is resolved against so it's found on the object's own class
+    /// </summary>
+    private ClassInfo ClassOf(IBoundObject target)
+    {
+        if (target.IsStatic)
+        {
+            throw new InstanceMemberOnStaticException(_name, target.Info ?? StaticClass);
+        }
+        return target.Info ?? StaticClass;
+    }
+
+    private ClassInfo StaticClass => _cls ??= Jvm.GetClassInfo(_target);
+
+    public T Invoke<T>(IBoundObject target, object?[] args) => (T)Invoke(target.Jobj, ClassOf(target), args);
+
+    public void Invoke(IBoundObject target, object?[] args) => Invoke(target.Jobj, ClassOf(target), args);
+
+    public T InvokeStatic<T>(object?[] args) => (T)Invoke(StaticClass.Cls, StaticClass, args);
+
+    public void InvokeStatic(object?[] args) => Invoke(StaticClass.Cls, StaticClass, args);
+
+    public TRet Invoke<TRet>(IBoundObject target) => _signature == null
+        ? Invoke<TRet>(target, Array.Empty<object?>())
+        : Call<TRet>(target.Jobj, ClassOf(target));
+
+    public TRet Invoke<TRet, T1>(IBoundObject target, T1 arg1) => _signature == null
+        ? Invoke<TRet>(target, new object?[] { arg1 })
+        : Call<TRet, T1>(target.Jobj, ClassOf(target), arg1);
+
+    public TRet Invoke<TRet, T1, T2>(IBoundObject target, T1 arg1, T2 arg2) => _signature == null
+        ? Invoke<TRet>(target, new object?[] { arg1, arg2 })
+        : Call<TRet, T1, T2>(target.Jobj, ClassOf(target), arg1, arg2);
+
+    public TRet Invoke<TRet, T1, T2, T3>(IBoundObject target, T1 arg1, T2 arg2, T3 arg3) => _signature == null
+        ? Invoke<TRet>(target, new object?[] { arg1, arg2, arg3 })
+        : Call<TRet, T1, T2, T3>(target.Jobj, ClassOf(target), arg1, arg2, arg3);
+
+    public TRet Invoke<TRet, T1, T2, T3, T4>(IBoundObject target, T1 arg1, T2 arg2, T3 arg3, T4 arg4) => _signature == null
+        ? Invoke<TRet>(target, new object?[] { arg1, arg2, arg3, arg4 })
+        : Call<TRet, T1, T2, T3, T4>(target.Jobj, ClassOf(target), arg1, arg2, arg3, arg4);
+
+    public void InvokeVoid(IBoundObject target)
+    {
+        // dynamic sites return null for void, which can't be unboxed into the marker
+        if (_signature == null)
+        {
+            Invoke(target, Array.Empty<object?>());
+            return;
+        }
+        Call<FastCall.Void>(target.Jobj, ClassOf(target));
+    }
+
+    public void InvokeVoid<T1>(IBoundObject target, T1 arg1)
+    {
+        if (_signature == null)
+        {
+            Invoke(target, new object?[] { arg1 });
+            return;
+        }
+        Call<FastCall.Void, T1>(target.Jobj, ClassOf(target), arg1);
+    }
+
+    public void InvokeVoid<T1, T2>(IBoundObject target, T1 arg1, T2 arg2)
+    {
+        if (_signature == null)
+        {
+            Invoke(target, new object?[] { arg1, arg2 });
+            return;
+        }
+        Call<FastCall.Void, T1, T2>(target.Jobj, ClassOf(target), arg1, arg2);
+    }
+
+    public void InvokeVoid<T1, T2, T3>(IBoundObject target, T1 arg1, T2 arg2, T3 arg3)
+    {
+        if (_signature == null)
+        {
+            Invoke(target, new object?[] { arg1, arg2, arg3 });
+            return;
+        }
+        Call<FastCall.Void, T1, T2, T3>(target.Jobj, ClassOf(target), arg1, arg2, arg3);
+    }
+
+    public void InvokeVoid<T1, T2, T3, T4>(IBoundObject target, T1 arg1, T2 arg2, T3 arg3, T4 arg4)
+    {
+        if (_signature == null)
+        {
+            Invoke(target, new object?[] { arg1, arg2, arg3, arg4 });
+            return;
+        }
+        Call<FastCall.Void, T1, T2, T3, T4>(target.Jobj, ClassOf(target), arg1, arg2, arg3, arg4);
+    }
+
+    public TRet InvokeStatic<TRet>() => _signature == null
+        ? InvokeStatic<TRet>(Array.Empty<object?>())
+        : Call<TRet>(StaticClass.Cls, StaticClass);
+
+    public TRet InvokeStatic<TRet, T1>(T1 arg1) => _signature == null
+        ? InvokeStatic<TRet>(new object?[] { arg1 })
+        : Call<TRet, T1>(StaticClass.Cls, StaticClass, arg1);
+
+    public TRet InvokeStatic<TRet, T1, T2>(T1 arg1, T2 arg2) => _signature == null
+        ? InvokeStatic<TRet>(new object?[] { arg1, arg2 })
+        : Call<TRet, T1, T2>(StaticClass.Cls, StaticClass, arg1, arg2);
+
+    public TRet InvokeStatic<TRet, T1, T2, T3>(T1 arg1, T2 arg2, T3 arg3) => _signature == null
+        ? InvokeStatic<TRet>(new object?[] { arg1, arg2, arg3 })
+        : Call<TRet, T1, T2, T3>(StaticClass.Cls, StaticClass, arg1, arg2, arg3);
+
+    public TRet InvokeStatic<TRet, T1, T2, T3, T4>(T1 arg1, T2 arg2, T3 arg3, T4 arg4) => _signature == null
+        ? InvokeStatic<TRet>(new object?[] { arg1, arg2, arg3, arg4 })
+        : Call<TRet, T1, T2, T3, T4>(StaticClass.Cls, StaticClass, arg1, arg2, arg3, arg4);
+
+    public void InvokeStaticVoid()
+    {
+        if (_signature == null)
+        {
+            InvokeStatic(Array.Empty<object?>());
+            return;
+        }
+        Call<FastCall.Void>(StaticClass.Cls, StaticClass);
+    }
+
+    public void InvokeStaticVoid<T1>(T1 arg1)
+    {
+        if (_signature == null)
+        {
+            InvokeStatic(new object?[] { arg1 });
+            return;
+        }
+        Call<FastCall.Void, T1>(StaticClass.Cls, StaticClass, arg1);
+    }
+
+    public void InvokeStaticVoid<T1, T2>(T1 arg1, T2 arg2)
+    {
+        if (_signature == null)
+        {
+            InvokeStatic(new object?[] { arg1, arg2 });
+            return;
+        }
+        Call<FastCall.Void, T1, T2>(StaticClass.Cls, StaticClass, arg1, arg2);
+    }
+
+    public void InvokeStaticVoid<T1, T2, T3>(T1 arg1, T2 arg2, T3 arg3)
+    {
+        if (_signature == null)
+        {
+            InvokeStatic(new object?[] { arg1, arg2, arg3 });
+            return;
+        }
+        Call<FastCall.Void, T1, T2, T3>(StaticClass.Cls, StaticClass, arg1, arg2, arg3);
+    }
+
+    public void InvokeStaticVoid<T1, T2, T3, T4>(T1 arg1, T2 arg2, T3 arg3, T4 arg4)
+    {
+        if (_signature == null)
+        {
+            InvokeStatic(new object?[] { arg1, arg2, arg3, arg4 });
+            return;
+        }
+        Call<FastCall.Void, T1, T2, T3, T4>(StaticClass.Cls, StaticClass, arg1, arg2, arg3, arg4);
+    }
+}
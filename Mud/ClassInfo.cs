@@ -1,3 +1,4 @@
+using System.Collections.Concurrent;
 using System.Runtime.InteropServices.ComTypes;
 using Mud.Exceptions;
 using Mud.Types;
@@ -49,6 +50,11 @@ public class ClassInfo
     /// </summary>
     internal IntPtr Cls { get; }
     /// <summary>
+    /// Process unique id of the class info, used as its token in the native class identity cache
+    /// </summary>
+    internal ulong Id { get; }
+    private static long _lastId;
+    /// <summary>
     /// The class path of the class
     /// </summary>
     public string ClassPath { get; }
@@ -61,12 +67,33 @@ public class ClassInfo
     /// <summary>
     /// Cached method lookups
     /// </summary>
-    internal Dictionary<string, Dictionary<string, IntPtr>> Methods { get; } = new();
+    internal ConcurrentDictionary<string, ConcurrentDictionary<string, IntPtr>> Methods { get; } = new();
     
+    /// <summary>
+    /// Methods the by-name calls bound to, by name, the signature made from the call's argument types, which of the
+    /// arguments are null and whether it's static. A null binds to any reference parameter, so it's part of the key
+    /// </summary>
+    private ConcurrentDictionary<(string Name, string Signature, ulong NullArgs, bool IsStatic), DynamicTarget> DynamicTargets { get; } = new();
+
     /// <summary>
     /// Cached field lookups
     /// </summary>
-    internal Dictionary<string, IntPtr> Props { get; } = new();
+    internal ConcurrentDictionary<string, IntPtr> Props { get; } = new();
+
+    /// <summary>
+    /// Methods resolved so far and whether each is static, recorded into preload manifests
+    /// </summary>
+    internal ConcurrentDictionary<(string Name, string Signature), bool> ResolvedMethods { get; } = new();
+
+    /// <summary>
+    /// Fields resolved so far and whether each is static, recorded into preload manifests
+    /// </summary>
+    internal ConcurrentDictionary<(string Name, string Signature), bool> ResolvedFields { get; } = new();
+
+    /// <summary>
+    /// Cached field layouts by the struct they map onto
+    /// </summary>
+    private ConcurrentDictionary<Type, object> Layouts { get; } = new();
     
     
     /// <param name="cls">The java class object pointer</param>
@@ -74,25 +101,40 @@ public class ClassInfo
     internal ClassInfo(IntPtr cls, string classPath)
     {
         Cls = cls;
+        Id = (ulong)Interlocked.Increment(ref _lastId);
         ClassPath = classPath;
-        TypeSignature = classPath switch
-        {
-            "int" => "I",
-            "long" => "J",
-            "boolean" => "Z",
-            "byte" => "B",
-            "short" => "S",
-            "char" => "C",
-            "float" => "F",
-            "double" => "D",
-            "void" or "Void" => "V",
-            _ => $"L{classPath.Replace('.', '/')};"
-        };
+        TypeSignature = TypeMap.NameSignature(classPath);
     }
 
 
     public IBoundObject Instance(params object[] args) => Instance(args.Select(a => new TypedArg(a)).ToArray());
-    public IBoundObject Instance(TypedArg[] args) => Jvm.NewObj(ClassPath, args);
+    public IBoundObject Instance(TypedArg[] args) => Jvm.NewObj(this, args);
+
+    /// <summary>
+    /// Gets the layout mapping the struct's fields onto this class' fields, field ids are resolved once per struct
+    /// </summary>
+    /// <typeparam name="T">Struct mirroring the class' fields</typeparam>
+    public FieldLayout<T> GetFieldLayout<T>() where T : unmanaged =>
+        (FieldLayout<T>)Layouts.GetOrAdd(typeof(T), _ => new FieldLayout<T>(this));
+
+    /// <summary>
+    /// Binds a native method declared by this class to an unmanaged function, such as a static UnmanagedCallersOnly method
+    /// taking the JNI env and the object or class followed by the java method's arguments
+    /// </summary>
+    /// <param name="method">Name of the native method</param>
+    /// <param name="signature">The native method's Java type signature</param>
+    /// <param name="fn">Pointer to the function implementing it</param>
+    /// <exception cref="MemberNotFoundException">Thrown when the class declares no matching native method</exception>
+    public void RegisterNative(string method, string signature, IntPtr fn)
+    {
+        Jvm.EnsureInit();
+        if (!MudInterface.register_native(Jvm.Env, Cls, method, signature, fn))
+        {
+            MudInterface.release_obj(Jvm.Env, MudInterface.check_exception(Jvm.Env));
+            throw new MemberNotFoundException(ClassPath, method, signature,
+                $"Native method {method} with type signature {signature} not found on class {ClassPath}");
+        }
+    }
 
     /// <summary>
     /// Checks if there is a matching instance or static method for this class
@@ -121,31 +163,42 @@ public class ClassInfo
     /// <param name="signature">Signature of the method</param>
     /// <param name="isStatic">Whether the method is static or not</param>
     /// <returns>Method pointer</returns>
+    /// <exception cref="MemberNotFoundException">Thrown when the class has no such method</exception>
     internal IntPtr GetMethodPtr(string method, string signature, bool isStatic)
     {
-        if (method == "")
-        {
-            _ = 0;
-        }
-        if (!Methods.TryGetValue(method, out var methodPointers))
+        if (!TryGetMethodPtr(method, signature, isStatic, out var methodPtr))
         {
-            methodPointers = new();
-            Methods[method] = methodPointers;
+            throw new MemberNotFoundException(ClassPath, method, signature,
+                $"Method {method} with type signature {signature} not found on class {ClassPath}");
         }
+        return methodPtr;
+    }
+
+    /// <summary>
+    /// Gets the corresponding method in the class
+    /// </summary>
+    /// <param name="method">Method name</param>
+    /// <param name="signature">Signature of the method</param>
+    /// <param name="isStatic">Whether the method is static or not</param>
+    /// <param name="methodPtr">Method pointer</param>
+    /// <returns>False when the class has no such method</returns>
+    internal bool TryGetMethodPtr(string method, string signature, bool isStatic, out IntPtr methodPtr)
+    {
+        var methodPointers = Methods.GetOrAdd(method, _ => new());
 
-        if (methodPointers.TryGetValue(signature, out var methodPtr) && methodPtr != IntPtr.Zero)
+        if (methodPointers.TryGetValue(signature, out methodPtr) && methodPtr != IntPtr.Zero)
         {
-            return methodPtr;
+            return true;
         }
         Jvm.EnsureInit();
         // Console.WriteLine($"Getting {(isStatic ? "static" : "member")} method {method} with type signature {signature} in class {ClassPath} [{Cls.HexAddress()}] ");
         if (isStatic)
         {
-            methodPtr = MudInterface.get_static_method(Jvm.Instance.Env, Cls, method, signature);
+            methodPtr = MudInterface.get_static_method(Jvm.Env, Cls, method, signature);
         }
         else
         {
-            methodPtr = MudInterface.get_method(Jvm.Instance.Env, Cls, method, signature);
+            methodPtr = MudInterface.get_method(Jvm.Env, Cls, method, signature);
         }
             
         methodPointers[signature] = methodPtr;
@@ -153,22 +206,72 @@ public class ClassInfo
         if (methodPtr == IntPtr.Zero)
         {
             // exception is thrown when method with sig not found, but we throw out own exception, so just capture and release
-            MudInterface.release_obj(Jvm.Instance.Env, MudInterface.check_exception(Jvm.Instance.Env));
-            throw new MemberNotFoundException(ClassPath, method, signature,
-                $"Method {method} with type signature {signature} not found on class {ClassPath}");
+            MudInterface.release_obj(Jvm.Env, MudInterface.check_exception(Jvm.Env));
+            return false;
         }
+        ResolvedMethods[(method, signature)] = isStatic;
 
-        return methodPtr;
+        return true;
+    }
+
+    /// <summary>
+    /// Gets the method a by-name call binds to, calls with the same argument types after the first are a single lookup
+    /// </summary>
+    /// <param name="method">Method name</param>
+    /// <param name="returnType">The requested return type</param>
+    /// <param name="args">The call's arguments</param>
+    /// <param name="isStatic">Whether the method is static</param>
+    /// <exception cref="MemberNotFoundException">Thrown when no overload accepts the arguments</exception>
+    internal DynamicTarget ResolveCall(string method, CustomType returnType, TypedArg[] args, bool isStatic)
+    {
+        var signature = CallSignature(returnType, args);
+        if (args.Length > 64)
+        {
+            // too many arguments to key their nullness by
+            return OverloadResolver.Resolve(this, method, signature, returnType, args, isStatic).ThrowIfMissing(this, method);
+        }
+        var key = (method, signature, NullArgs(args), isStatic);
+        if (!DynamicTargets.TryGetValue(key, out var target))
+        {
+            target = OverloadResolver.Resolve(this, method, signature, returnType, args, isStatic);
+            DynamicTargets[key] = target;
+        }
+        return target.ThrowIfMissing(this, method);
+    }
+
+    private static ulong NullArgs(TypedArg[] args)
+    {
+        var nulls = 0UL;
+        for (var i = 0; i < args.Length; i++)
+        {
+            if (args[i].Val == null)
+            {
+                nulls |= 1UL << i;
+            }
+        }
+        return nulls;
+    }
+
+    private static string CallSignature(CustomType returnType, TypedArg[] args)
+    {
+        var signatures = new string[args.Length + 3];
+        signatures[0] = "(";
+        for (var i = 0; i < args.Length; i++)
+        {
+            signatures[i + 1] = args[i].Type.TypeSignature;
+        }
+        signatures[^2] = ")";
+        signatures[^1] = returnType.TypeSignature;
+        return string.Concat(signatures);
     }
-    
 
     internal T Call<T>(IntPtr objOrClass, string method, CustomType returnType, TypedArg[] args, bool isStatic)
     {
         Func<IntPtr, IntPtr, IntPtr, JavaType, JavaVal[], JavaCallResp> func = isStatic ? MudInterface.call_static_method : MudInterface.call_method;
-        var methodPtr = GetMethodPtr(method, TypeMap.GenMethodSignature(returnType, args.Select(a => a.Type).ToArray()), isStatic);
-        return Jvm.UsingArgs<T>(args, jArgs =>
+        var target = ResolveCall(method, returnType, args, isStatic);
+        return Jvm.UsingArgs<T>(target.Convert(args), jArgs =>
         {
-            var resp = func(Jvm.Instance.Env, objOrClass, methodPtr, returnType.Type, jArgs);
+            var resp = func(Jvm.Env, objOrClass, target.Method, returnType.Type, jArgs);
             return resp;
         });
     }
@@ -190,17 +293,75 @@ public class ClassInfo
     {
         return Call<T>(Cls, method, returnType, args, true);
     }
+
+    /// <summary>
+    /// Calls the provided static method with args from one of the JVM worker threads.
+    /// Bound objects in args must not be local to a JvmScope, promote them first as local refs are only valid on the
+    /// thread that created them
+    /// </summary>
+    /// <param name="method">Method to be called</param>
+    /// <param name="args">Arguments to be passed into the method</param>
+    public ValueTask CallAsync(string method, params object[] args) => CallAsync(method, args, CancellationToken.None);
+    public ValueTask CallAsync(string method, object[] args, CancellationToken cancellationToken) =>
+        Jvm.WorkerPool.Run(() => Call(method, args), cancellationToken);
+
+    /// <summary>
+    /// Calls the provided static method with args from one of the JVM worker threads.
+    /// Bound objects in args must not be local to a JvmScope, promote them first as local refs are only valid on the
+    /// thread that created them
+    /// </summary>
+    /// <param name="method">Method to be called</param>
+    /// <param name="args">Arguments to be passed into the method</param>
+    /// <typeparam name="T"></typeparam>
+    public ValueTask<T> CallAsync<T>(string method, params object[] args) => CallAsync<T>(method, args, CancellationToken.None);
+    public ValueTask<T> CallAsync<T>(string method, object[] args, CancellationToken cancellationToken) =>
+        Jvm.WorkerPool.Run(() => Call<T>(method, args), cancellationToken);
+
+    /// <summary>
+    /// Calls the provided static method without allocating, arguments are limited to primitives and strings
+    /// </summary>
+    public TRet Call<TRet>(string method) => FastCall.Call<TRet>(this, Cls, true, method);
+    public TRet Call<TRet, T1>(string method, T1 arg1) => FastCall.Call<TRet, T1>(this, Cls, true, method, arg1);
+    public TRet Call<TRet, T1, T2>(string method, T1 arg1, T2 arg2) =>
+        FastCall.Call<TRet, T1, T2>(this, Cls, true, method, arg1, arg2);
+    public TRet Call<TRet, T1, T2, T3>(string method, T1 arg1, T2 arg2, T3 arg3) =>
+        FastCall.Call<TRet, T1, T2, T3>(this, Cls, true, method, arg1, arg2, arg3);
+    public TRet Call<TRet, T1, T2, T3, T4>(string method, T1 arg1, T2 arg2, T3 arg3, T4 arg4) =>
+        FastCall.Call<TRet, T1, T2, T3, T4>(this, Cls, true, method, arg1, arg2, arg3, arg4);
+
+    /// <summary>
+    /// Calls the provided static void method without allocating, arguments are limited to primitives and strings
+    /// </summary>
+    public void CallVoid(string method) => FastCall.Call<FastCall.Void>(this, Cls, true, method);
+    public void CallVoid<T1>(string method, T1 arg1) => FastCall.Call<FastCall.Void, T1>(this, Cls, true, method, arg1);
+    public void CallVoid<T1, T2>(string method, T1 arg1, T2 arg2) =>
+        FastCall.Call<FastCall.Void, T1, T2>(this, Cls, true, method, arg1, arg2);
+    public void CallVoid<T1, T2, T3>(string method, T1 arg1, T2 arg2, T3 arg3) =>
+        FastCall.Call<FastCall.Void, T1, T2, T3>(this, Cls, true, method, arg1, arg2, arg3);
+    public void CallVoid<T1, T2, T3, T4>(string method, T1 arg1, T2 arg2, T3 arg3, T4 arg4) =>
+        FastCall.Call<FastCall.Void, T1, T2, T3, T4>(this, Cls, true, method, arg1, arg2, arg3, arg4);
     
     internal void Call(IntPtr objOrClass, string method, TypedArg[] args, bool isStatic)
     {
         Func<IntPtr, IntPtr, IntPtr, JavaType, JavaVal[], JavaCallResp> func = isStatic ? MudInterface.call_static_method : MudInterface.call_method;
-        var methodPtr = GetMethodPtr(method, TypeMap.GenMethodSignature(args), false);
-        Jvm.UsingArgs(args, jArgs =>
+        var target = ResolveCall(method, VoidType, args, isStatic);
+        JavaCallResp resp = new();
+        Jvm.UsingArgs(target.Convert(args), jArgs =>
         {
-            func(Jvm.Instance.Env, objOrClass, methodPtr, JavaType.Void, jArgs);
+            resp = func(Jvm.Env, objOrClass, target.Method, target.ReturnType, jArgs);
         });
+        if (resp.IsException)
+        {
+            Jvm.ThrowException(resp.Value.Object);
+        }
+        if (target.ReturnType == JavaType.Object)
+        {
+            MudInterface.release_obj(Jvm.Env, resp.Value.Object);
+        }
     }
 
+    private static readonly CustomType VoidType = new(JavaType.Void);
+
     public void Call(string method, params object[] args) => 
         Call(method, args.Select(a => new TypedArg(a)).ToArray());
     
@@ -231,18 +392,19 @@ public class ClassInfo
         if (!Props.TryGetValue(name, out var fieldPtr) || fieldPtr == IntPtr.Zero)
         {
             Jvm.EnsureInit();
-            fieldPtr = isStatic ? MudInterface.get_static_field(Jvm.Instance.Env, Cls, name, signature) :
-                MudInterface.get_field(Jvm.Instance.Env, Cls, name, signature);
+            fieldPtr = isStatic ? MudInterface.get_static_field(Jvm.Env, Cls, name, signature) :
+                MudInterface.get_field(Jvm.Env, Cls, name, signature);
             Props[name] = fieldPtr;
         }
-        MudInterface.release_obj(Jvm.Instance.Env, MudInterface.check_exception(Jvm.Instance.Env));
+        MudInterface.release_obj(Jvm.Env, MudInterface.check_exception(Jvm.Env));
         if (fieldPtr == IntPtr.Zero)
         {
             // exception is thrown when field with sig not found, but we throw our own exception, so just capture and release
-            MudInterface.release_obj(Jvm.Instance.Env, MudInterface.check_exception(Jvm.Instance.Env));
+            MudInterface.release_obj(Jvm.Env, MudInterface.check_exception(Jvm.Env));
             throw new MemberNotFoundException(ClassPath, name, signature,
                 $"Field {name} with type signature {signature} not found on class {ClassPath}");
         }
+        ResolvedFields.TryAdd((name, signature), isStatic);
         return fieldPtr;
     }
     
@@ -251,8 +413,8 @@ public class ClassInfo
         Func<IntPtr, IntPtr, IntPtr, JavaType, JavaVal>
             func = isStatic ? MudInterface.get_static_field_value : MudInterface.get_field_value;
         
-        var fieldPtr = GetFieldPtr(name, customType.TypeSignature, true);
-        return TypeMap.MapJValue<BoundObject>(JavaType.Object, func(Jvm.Instance.Env, objOrCls, fieldPtr, JavaType.Object));
+        var fieldPtr = GetFieldPtr(name, customType.TypeSignature, isStatic);
+        return TypeMap.MapJValue<BoundObject>(JavaType.Object, func(Jvm.Env, objOrCls, fieldPtr, JavaType.Object));
     }
     
     public T GetField<T>(IntPtr objOrCls, string name, CustomType customType, bool isStatic)
@@ -261,8 +423,8 @@ public class ClassInfo
         Func<IntPtr, IntPtr, IntPtr, JavaType, JavaVal>
             func = isStatic ? MudInterface.get_static_field_value : MudInterface.get_field_value; 
 
-        var fieldPtr = GetFieldPtr(name, customType.TypeSignature, true);
-        return TypeMap.MapJValue<T>(customType.Type, func(Jvm.Instance.Env, objOrCls, fieldPtr, customType.Type));
+        var fieldPtr = GetFieldPtr(name, customType.TypeSignature, isStatic);
+        return TypeMap.MapJValue<T>(customType.Type, func(Jvm.Env, objOrCls, fieldPtr, customType.Type));
     }
     
     public IBoundObject GetField(string name, CustomType type)
@@ -282,7 +444,7 @@ public class ClassInfo
         {
             Action<IntPtr, IntPtr, IntPtr, JavaType, JavaVal> func =
                 isStatic ? MudInterface.set_static_field_value : MudInterface.set_field_value; 
-            func(Jvm.Instance.Env, objOrCls, fieldPtr, val.Type.Type, jArgs[0]);
+            func(Jvm.Env, objOrCls, fieldPtr, val.Type.Type, jArgs[0]);
         });
     }
 
@@ -0,0 +1,117 @@
+using System.Collections.Concurrent;
+using System.Reflection;
+using Mud.Types;
+
+namespace Mud;
+
+/// <summary>
+/// Index of the interfaces marked with a ClassPathAttribute by their class path.
+/// Interfaces with generated implementations are registered by their assembly, the rest are found by scanning the
+/// loaded assemblies once and adding assemblies loaded later as they come in
+/// </summary>
+internal static class ClassPathRegistry
+{
+    private static readonly ConcurrentDictionary<string, Type[]> Types = new();
+    private static readonly object ScanLock = new();
+    private static bool _scanned;
+
+    /// <summary>
+    /// Finds the bound interface for the class path, an interface assignable to the requested type is preferred when there are several
+    /// </summary>
+    /// <param name="classPath">Class path of the java class</param>
+    /// <param name="requested">The type the value is being mapped to</param>
+    /// <returns>The bound interface type or null if none are registered for the class path</returns>
+    internal static Type? Find(string classPath, Type requested)
+    {
+        // interfaces with generated implementations are registered up front, so assemblies are only scanned on a miss
+        if (TryFind(classPath, requested, out var found))
+        {
+            return found;
+        }
+        EnsureScanned();
+        TryFind(classPath, requested, out found);
+        return found;
+    }
+
+    /// <summary>
+    /// Adds an interface without scanning its assembly
+    /// </summary>
+    /// <param name="classPath">Class path of the java class</param>
+    /// <param name="type">The bound interface</param>
+    internal static void Register(string classPath, Type type) =>
+        Types.AddOrUpdate(classPath, _ => new[] { type }, (_, existing) => existing.Contains(type) ? existing : existing.Append(type).ToArray());
+
+    /// <returns>Whether an interface assignable to the requested type was found, found holds the first registered one otherwise</returns>
+    private static bool TryFind(string classPath, Type requested, out Type? found)
+    {
+        found = null;
+        if (!Types.TryGetValue(classPath, out var types))
+        {
+            return false;
+        }
+
+        foreach (var type in types)
+        {
+            if (type.IsAssignableTo(requested))
+            {
+                found = type;
+                return true;
+            }
+        }
+        found = types[0];
+        return false;
+    }
+
+    private static void EnsureScanned()
+    {
+        if (Volatile.Read(ref _scanned))
+        {
+            return;
+        }
+
+        lock (ScanLock)
+        {
+            if (_scanned)
+            {
+                return;
+            }
+            AppDomain.CurrentDomain.AssemblyLoad += (_, args) => Add(args.LoadedAssembly);
+            foreach (var assembly in AppDomain.CurrentDomain.GetAssemblies())
+            {
+                Add(assembly);
+            }
+            Volatile.Write(ref _scanned, true);
+        }
+    }
+
+    private static void Add(Assembly assembly)
+    {
+        // the TypeGen assembly only holds generated implementations
+        if (assembly.IsDynamic)
+        {
+            return;
+        }
+
+        Type?[] types;
+        try
+        {
+            types = assembly.GetTypes();
+        }
+        catch (ReflectionTypeLoadException e)
+        {
+            types = e.Types;
+        }
+
+        foreach (var type in types)
+        {
+            if (type is not { IsInterface: true })
+            {
+                continue;
+            }
+            foreach (var attr in type.GetCustomAttributes<ClassPathAttribute>())
+            {
+                Register(attr.ClassPath, type);
+            }
+        }
+    }
+}
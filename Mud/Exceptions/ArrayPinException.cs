@@ -0,0 +1,11 @@
+namespace Mud.Exceptions;
+
+/// <summary>
+/// A pinned java array was used in a way that would corrupt the JVM
+/// </summary>
+public class ArrayPinException : Exception
+{
+    public ArrayPinException(string message) : base(message)
+    {
+    }
+}
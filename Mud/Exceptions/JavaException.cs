@@ -1,17 +1,144 @@
+using Mud.Types;
+
 namespace Mud.Exceptions;
 
 /// <summary>
-/// Exception in the JVM
+/// A single frame of a java stack trace
+/// </summary>
+public record JavaStackFrame(string ClassName, string MethodName, string? FileName, int LineNumber)
+{
+    public override string ToString() =>
+        $"{ClassName}.{MethodName}({FileName ?? "Unknown Source"}{(LineNumber >= 0 ? $":{LineNumber}" : "")})";
+}
+
+/// <summary>
+/// Exception in the JVM.
+/// The throwable is held until the exception is collected and then released, its message and stack trace are only read from
+/// the JVM when accessed
 /// </summary>
 public class JavaException : Exception
 {
+    private readonly IBoundObject? _throwable;
+    private string? _message;
+    private string? _stackTrace;
+    private IReadOnlyList<JavaStackFrame>? _frames;
+    private JavaException? _cause;
+    private bool _causeLoaded;
+
+    public JavaException(string message, string stackTrace) : base(message)
+    {
+        _message = message;
+        _stackTrace = stackTrace;
+        _frames = Array.Empty<JavaStackFrame>();
+        _causeLoaded = true;
+    }
+
+    /// <param name="throwable">The held java throwable</param>
+    internal JavaException(IBoundObject throwable) : base(null)
+    {
+        _throwable = throwable;
+    }
+
     /// <summary>
-    /// Stack trace from the JVM
+    /// The java throwable, null if the exception was not raised by the JVM
     /// </summary>
-    public string JavaStackTrace { get; }
-    public JavaException(string message, string stackTrace) : base(message)
+    public IBoundObject? Throwable => _throwable;
+
+    /// <summary>
+    /// The class path of the java throwable
+    /// </summary>
+    public string? JavaClassPath => _throwable?.ClassPath;
+
+    /// <summary>
+    /// The java throwable's toString, read from the JVM on first access
+    /// </summary>
+    public override string Message => _message ??= _throwable!.Call<string>("toString");
+
+    /// <summary>
+    /// Stack trace from the JVM including any causes, read from the JVM on first access with a single printStackTrace
+    /// </summary>
+    public string JavaStackTrace => _stackTrace ??= ReadStackTrace();
+
+    /// <summary>
+    /// Frames of the throwable's stack trace, read from the JVM on first access
+    /// </summary>
+    public IReadOnlyList<JavaStackFrame> Frames => _frames ??= ReadFrames();
+
+    /// <summary>
+    /// The exception that caused this one, null if there isn't one
+    /// </summary>
+    public JavaException? Cause
     {
-        JavaStackTrace = stackTrace;
+        get
+        {
+            if (!_causeLoaded)
+            {
+                // the cause is cached, so it's held past the scope it's first read in like the throwable itself
+                using var unscoped = JvmScope.Suspend();
+                var cause = _throwable!.Call<BoundObject?>("getCause", new CustomType("java/lang/Throwable"), Array.Empty<TypedArg>());
+                if (cause != null)
+                {
+                    if (!Jvm.ReleaseOnCollect)
+                    {
+                        Jvm.ReleaseWhenCollected(cause);
+                    }
+                    _cause = new JavaException(cause);
+                }
+                _causeLoaded = true;
+            }
+            return _cause;
+        }
     }
-    // public override string? StackTrace { get; }
-}
\ No newline at end of file
+
+    /// <summary>
+    /// Checks the java throwable's class without reading its message or stack trace
+    /// </summary>
+    /// <param name="classPath">Class path of the exception class, ie java.lang.NumberFormatException</param>
+    /// <returns>True if the throwable is an instance of the class or one of its subclasses</returns>
+    public bool IsInstanceOf(string classPath) => _throwable?.InstanceOf(classPath) ?? false;
+
+    /// <summary>
+    /// Checks the java throwable's class without reading its message or stack trace
+    /// </summary>
+    /// <typeparam name="T">Bound interface of the exception class</typeparam>
+    /// <returns>True if the throwable is an instance of the class or one of its subclasses</returns>
+    public bool IsInstanceOf<T>() => _throwable?.InstanceOf(Jvm.GetClassInfo<T>()) ?? false;
+
+    private string ReadStackTrace()
+    {
+        var writer = Jvm.GetClassInfo("java/io/StringWriter").Instance();
+        var printer = Jvm.GetClassInfo("java/io/PrintWriter").Instance(new TypedArg[] { new(writer, "java/io/Writer") });
+        try
+        {
+            _throwable!.Call("printStackTrace", new TypedArg[] { new(printer, "java/io/PrintWriter") });
+            var trace = writer.Call<string>("toString");
+            // the first line is the throwable's toString which is already the message
+            var firstLine = trace.IndexOf('\n');
+            return firstLine == -1 ? "" : trace[(firstLine + 1)..].TrimEnd();
+        }
+        finally
+        {
+            printer.Release();
+            writer.Release();
+        }
+    }
+
+    private IReadOnlyList<JavaStackFrame> ReadFrames()
+    {
+        var elements = _throwable!.Call<BoundObject[]>("getStackTrace", new CustomType("[Ljava/lang/StackTraceElement;"),
+            Array.Empty<TypedArg>());
+        var frames = new JavaStackFrame[elements.Length];
+        for (var i = 0; i < elements.Length; i++)
+        {
+            var element = elements[i];
+            frames[i] = new JavaStackFrame(element.Call<string>("getClassName"), element.Call<string>("getMethodName"),
+                element.Call<string?>("getFileName"), element.Call<int>("getLineNumber"));
+            element.Release();
+        }
+        return frames;
+    }
+
+    public override string ToString() => _throwable == null
+        ? base.ToString()
+        : $"{GetType().FullName}: {Message}{Environment.NewLine}{JavaStackTrace}{Environment.NewLine}{StackTrace}";
+}
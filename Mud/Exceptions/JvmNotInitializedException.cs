@@ -9,4 +9,8 @@ public class JvmNotInitializedException : Exception
     {
         
     }
+
+    public JvmNotInitializedException(string message) : base(message)
+    {
+    }
 }
\ No newline at end of file
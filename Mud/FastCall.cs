@@ -0,0 +1,237 @@
+using System.Data;
+using System.Runtime.CompilerServices;
+using Mud.Types;
+
+namespace Mud;
+
+/// <summary>
+/// The allocation free call path used by the generic arity Call overloads.
+/// Arguments are limited to primitives and strings so their java signature is known from the type parameters alone
+/// </summary>
+internal static unsafe class FastCall
+{
+    /// <summary>
+    /// Marker used as the return type parameter of void methods
+    /// </summary>
+    internal struct Void
+    {
+    }
+
+    /// <summary>
+    /// Whether SetArg takes the type, i.e. it's a primitive or a string
+    /// </summary>
+    [MethodImpl(MethodImplOptions.AggressiveInlining)]
+    internal static bool IsArg<T>() =>
+        typeof(T) == typeof(int) || typeof(T) == typeof(double) || typeof(T) == typeof(long) || typeof(T) == typeof(float) ||
+        typeof(T) == typeof(bool) || typeof(T) == typeof(byte) || typeof(T) == typeof(char) || typeof(T) == typeof(short) ||
+        typeof(T) == typeof(string);
+
+    /// <summary>
+    /// Writes the argument into its JavaVal slot, strings are allocated in the JVM unless they are constant strings
+    /// </summary>
+    /// <returns>Whether the slot holds a java object allocated for the call, which ReleaseArgs must release</returns>
+    [MethodImpl(MethodImplOptions.AggressiveInlining)]
+    internal static bool SetArg<T>(ref JavaVal slot, T val)
+    {
+        if (typeof(T) == typeof(int)) slot.Int = Unsafe.As<T, int>(ref val);
+        else if (typeof(T) == typeof(double)) slot.Double = Unsafe.As<T, double>(ref val);
+        else if (typeof(T) == typeof(long)) slot.Long = Unsafe.As<T, long>(ref val);
+        else if (typeof(T) == typeof(float)) slot.Float = Unsafe.As<T, float>(ref val);
+        else if (typeof(T) == typeof(bool)) slot.Bool = Unsafe.As<T, bool>(ref val);
+        else if (typeof(T) == typeof(byte)) slot.Byte = Unsafe.As<T, byte>(ref val);
+        else if (typeof(T) == typeof(char)) slot.Char = Unsafe.As<T, ushort>(ref val);
+        else if (typeof(T) == typeof(short)) slot.Short = Unsafe.As<T, short>(ref val);
+        else if (typeof(T) == typeof(string))
+        {
+            slot.Object = NewString(Unsafe.As<T, string?>(ref val), out var owned);
+            return owned;
+        }
+        else throw new ConstraintException($"Type {typeof(T).Name} is not supported by the allocation free call path");
+        return false;
+    }
+
+    /// <summary>
+    /// Releases the java objects allocated for the arguments
+    /// </summary>
+    /// <param name="args">The call's arguments</param>
+    /// <param name="owned">Bit per argument, set when SetArg returned that the slot owns its object</param>
+    [MethodImpl(MethodImplOptions.AggressiveInlining)]
+    internal static void ReleaseArgs(Span<JavaVal> args, int owned)
+    {
+        for (var i = 0; owned != 0; i++, owned >>= 1)
+        {
+            if ((owned & 1) != 0 && args[i].Object != IntPtr.Zero)
+            {
+                MudNative.ReleaseObj(Jvm.Env, args[i].Object);
+            }
+        }
+    }
+
+    private static IntPtr NewString(string? str, out bool owned)
+    {
+        if (str == null)
+        {
+            owned = false;
+            return IntPtr.Zero;
+        }
+        if (Jvm.HasConstantStrings)
+        {
+            return Jvm.JavaArgString(str, out owned);
+        }
+        owned = true;
+        fixed (char* chars = str)
+        {
+            return MudNative.StringNewUtf16(Jvm.Env, chars, str.Length);
+        }
+    }
+
+    /// <summary>
+    /// Calls the method with the already mapped arguments
+    /// </summary>
+    /// <exception cref="Mud.Exceptions.JavaException">Will throw if there is an exception in the JVM</exception>
+    internal static JavaVal Invoke(ClassInfo cls, IntPtr objOrCls, bool isStatic, string method, string signature, JavaType returnType,
+        Span<JavaVal> args)
+    {
+        Jvm.EnsureInit();
+        var methodPtr = cls.GetMethodPtr(method, signature, isStatic);
+        JavaCallResp resp;
+        fixed (JavaVal* argsPtr = args)
+        {
+            resp = isStatic
+                ? MudNative.CallStaticMethod(Jvm.Env, objOrCls, methodPtr, returnType, argsPtr)
+                : MudNative.CallMethod(Jvm.Env, objOrCls, methodPtr, returnType, argsPtr);
+        }
+
+        if (resp.IsException)
+        {
+            Jvm.ThrowException(resp.Value.Object);
+        }
+        return resp.Value;
+    }
+
+    /// <summary>
+    /// Maps the returned value, primitives are read straight out of the JavaVal
+    /// </summary>
+    [MethodImpl(MethodImplOptions.AggressiveInlining)]
+    internal static TRet MapReturn<TRet>(JavaVal val)
+    {
+        if (typeof(TRet) == typeof(int)) return Unsafe.As<int, TRet>(ref val.Int);
+        if (typeof(TRet) == typeof(double)) return Unsafe.As<double, TRet>(ref val.Double);
+        if (typeof(TRet) == typeof(long)) return Unsafe.As<long, TRet>(ref val.Long);
+        if (typeof(TRet) == typeof(float)) return Unsafe.As<float, TRet>(ref val.Float);
+        if (typeof(TRet) == typeof(bool)) return Unsafe.As<bool, TRet>(ref val.Bool);
+        if (typeof(TRet) == typeof(byte)) return Unsafe.As<byte, TRet>(ref val.Byte);
+        if (typeof(TRet) == typeof(short)) return Unsafe.As<short, TRet>(ref val.Short);
+        if (typeof(TRet) == typeof(char)) return Unsafe.As<ushort, TRet>(ref val.Char);
+        if (typeof(TRet) == typeof(Void)) return default!;
+        return (TRet)TypeMap.MapJValue(typeof(TRet), val);
+    }
+
+    internal static TRet Call<TRet>(ClassInfo cls, IntPtr objOrCls, bool isStatic, string method)
+    {
+        var val = Invoke(cls, objOrCls, isStatic, method, Signature<TRet>.Value, Signature<TRet>.Return, Span<JavaVal>.Empty);
+        return MapReturn<TRet>(val);
+    }
+
+    internal static TRet Call<TRet, T1>(ClassInfo cls, IntPtr objOrCls, bool isStatic, string method, T1 arg1)
+    {
+        Span<JavaVal> args = stackalloc JavaVal[1];
+        var owned = 0;
+        try
+        {
+            owned |= SetArg(ref args[0], arg1) ? 1 : 0;
+            var val = Invoke(cls, objOrCls, isStatic, method, Signature<TRet, T1>.Value, Signature<TRet>.Return, args);
+            return MapReturn<TRet>(val);
+        }
+        finally
+        {
+            ReleaseArgs(args, owned);
+        }
+    }
+
+    internal static TRet Call<TRet, T1, T2>(ClassInfo cls, IntPtr objOrCls, bool isStatic, string method, T1 arg1, T2 arg2)
+    {
+        Span<JavaVal> args = stackalloc JavaVal[2];
+        var owned = 0;
+        try
+        {
+            owned |= SetArg(ref args[0], arg1) ? 1 : 0;
+            owned |= SetArg(ref args[1], arg2) ? 1 << 1 : 0;
+            var val = Invoke(cls, objOrCls, isStatic, method, Signature<TRet, T1, T2>.Value, Signature<TRet>.Return, args);
+            return MapReturn<TRet>(val);
+        }
+        finally
+        {
+            ReleaseArgs(args, owned);
+        }
+    }
+
+    internal static TRet Call<TRet, T1, T2, T3>(ClassInfo cls, IntPtr objOrCls, bool isStatic, string method, T1 arg1, T2 arg2, T3 arg3)
+    {
+        Span<JavaVal> args = stackalloc JavaVal[3];
+        var owned = 0;
+        try
+        {
+            owned |= SetArg(ref args[0], arg1) ? 1 : 0;
+            owned |= SetArg(ref args[1], arg2) ? 1 << 1 : 0;
+            owned |= SetArg(ref args[2], arg3) ? 1 << 2 : 0;
+            var val = Invoke(cls, objOrCls, isStatic, method, Signature<TRet, T1, T2, T3>.Value, Signature<TRet>.Return, args);
+            return MapReturn<TRet>(val);
+        }
+        finally
+        {
+            ReleaseArgs(args, owned);
+        }
+    }
+
+    internal static TRet Call<TRet, T1, T2, T3, T4>(ClassInfo cls, IntPtr objOrCls, bool isStatic, string method, T1 arg1, T2 arg2, T3 arg3, T4 arg4)
+    {
+        Span<JavaVal> args = stackalloc JavaVal[4];
+        var owned = 0;
+        try
+        {
+            owned |= SetArg(ref args[0], arg1) ? 1 : 0;
+            owned |= SetArg(ref args[1], arg2) ? 1 << 1 : 0;
+            owned |= SetArg(ref args[2], arg3) ? 1 << 2 : 0;
+            owned |= SetArg(ref args[3], arg4) ? 1 << 3 : 0;
+            var val = Invoke(cls, objOrCls, isStatic, method, Signature<TRet, T1, T2, T3, T4>.Value, Signature<TRet>.Return, args);
+            return MapReturn<TRet>(val);
+        }
+        finally
+        {
+            ReleaseArgs(args, owned);
+        }
+    }
+
+    private static string Sig(Type type) => type == typeof(Void) ? "V" : TypeMap.GenSignature(type);
+
+    /// <summary>
+    /// Method signatures computed once per combination of type parameters
+    /// </summary>
+    private static class Signature<TRet>
+    {
+        internal static readonly string Value = $"(){Sig(typeof(TRet))}";
+        internal static readonly JavaType Return = typeof(TRet) == typeof(Void) ? JavaType.Void : TypeMap.MapToType(typeof(TRet), null).Type;
+    }
+
+    private static class Signature<TRet, T1>
+    {
+        internal static readonly string Value = $"({Sig(typeof(T1))}){Sig(typeof(TRet))}";
+    }
+
+    private static class Signature<TRet, T1, T2>
+    {
+        internal static readonly string Value = $"({Sig(typeof(T1))}{Sig(typeof(T2))}){Sig(typeof(TRet))}";
+    }
+
+    private static class Signature<TRet, T1, T2, T3>
+    {
+        internal static readonly string Value = $"({Sig(typeof(T1))}{Sig(typeof(T2))}{Sig(typeof(T3))}){Sig(typeof(TRet))}";
+    }
+
+    private static class Signature<TRet, T1, T2, T3, T4>
+    {
+        internal static readonly string Value =
+            $"({Sig(typeof(T1))}{Sig(typeof(T2))}{Sig(typeof(T3))}{Sig(typeof(T4))}){Sig(typeof(TRet))}";
+    }
+}
@@ -0,0 +1,233 @@
+using System.Collections.Concurrent;
+using System.Reflection;
+using System.Runtime.CompilerServices;
+using System.Runtime.InteropServices;
+using Mud.Exceptions;
+using Mud.Types;
+
+namespace Mud;
+
+/// <summary>
+/// Maps the primitive fields of a .NET struct onto the fields of a java class so that all of them
+/// can be read from or written to one or many java objects in a single native call.
+/// Each struct field binds to the java field of the same name, or the name given by its JavaName attribute
+/// </summary>
+/// <typeparam name="T">Struct mirroring the java class' fields</typeparam>
+public sealed unsafe class FieldLayout<T> where T : unmanaged
+{
+    // arrays of objects up to this size have their pointers gathered on the stack
+    private const int StackObjects = 128;
+
+    private readonly JavaFieldLayout[] _fields;
+
+    /// <summary>
+    /// Whether objects bound to a class are instances of the layout's class, checked once per bound class
+    /// </summary>
+    private readonly ConcurrentDictionary<ClassInfo, bool> _boundClasses = new();
+
+    /// <summary>
+    /// The java class the layout was resolved against
+    /// </summary>
+    public ClassInfo Class { get; }
+
+    /// <summary>
+    /// Number of fields in the layout
+    /// </summary>
+    public int FieldCount => _fields.Length;
+
+    /// <summary>
+    /// Resolves the field ids of each of the struct's fields on the java class
+    /// </summary>
+    /// <param name="cls">Class the struct mirrors</param>
+    /// <exception cref="ArgumentException">Thrown when a struct field is not a java primitive type</exception>
+    /// <exception cref="MemberNotFoundException">Thrown when the java class has no matching field</exception>
+    public FieldLayout(ClassInfo cls)
+    {
+        Class = cls;
+        var fields = typeof(T).GetFields(BindingFlags.Instance | BindingFlags.Public | BindingFlags.NonPublic);
+        _fields = new JavaFieldLayout[fields.Length];
+        for (var i = 0; i < fields.Length; i++)
+        {
+            var field = fields[i];
+            var type = MapFieldType(field);
+            var name = field.GetCustomAttribute<JavaNameAttribute>()?.Name ?? field.Name;
+            _fields[i] = new JavaFieldLayout
+            {
+                Field = cls.GetFieldPtr(name, new CustomType(type).TypeSignature, false),
+                Type = type,
+                Offset = FieldOffset(field)
+            };
+        }
+    }
+
+    /// <summary>
+    /// Reads all of the layout's fields from the java object
+    /// </summary>
+    /// <param name="obj">Object to read from</param>
+    /// <exception cref="ArgumentException">Thrown when the object is not an instance of the layout's class</exception>
+    public T Read(IBoundObject obj)
+    {
+        T record = default;
+        var jobj = ObjPtr(obj);
+        fixed (JavaFieldLayout* fields = _fields)
+        {
+            Jvm.ThrowException(MudNative.GetFieldsBulk(Jvm.Env, &jobj, 1, fields, (nuint)_fields.Length, &record, (nuint)sizeof(T)));
+        }
+        return record;
+    }
+
+    /// <summary>
+    /// Reads all of the layout's fields from each of the java objects into the record at the same index
+    /// </summary>
+    /// <param name="objs">Objects to read from</param>
+    /// <param name="records">Records to fill, must be at least as long as objs</param>
+    public void Read(IReadOnlyList<IBoundObject> objs, Span<T> records)
+    {
+        if (records.Length < objs.Count)
+        {
+            throw new ArgumentException($"{objs.Count} records are needed to read {objs.Count} objects", nameof(records));
+        }
+        var jobjs = objs.Count <= StackObjects ? stackalloc IntPtr[objs.Count] : new IntPtr[objs.Count];
+        GatherPtrs(objs, jobjs);
+        fixed (IntPtr* objPtrs = jobjs)
+        fixed (JavaFieldLayout* fields = _fields)
+        fixed (T* recordPtrs = records)
+        {
+            Jvm.ThrowException(MudNative.GetFieldsBulk(Jvm.Env, objPtrs, (nuint)jobjs.Length, fields, (nuint)_fields.Length,
+                recordPtrs, (nuint)sizeof(T)));
+        }
+    }
+
+    /// <summary>
+    /// Reads all of the layout's fields from each of the java objects
+    /// </summary>
+    /// <param name="objs">Objects to read from</param>
+    public T[] Read(IReadOnlyList<IBoundObject> objs)
+    {
+        var records = new T[objs.Count];
+        Read(objs, records);
+        return records;
+    }
+
+    /// <summary>
+    /// Writes all of the layout's fields of the record into the java object
+    /// </summary>
+    /// <param name="obj">Object to write to</param>
+    /// <param name="record">Values to be written</param>
+    public void Write(IBoundObject obj, in T record)
+    {
+        var jobj = ObjPtr(obj);
+        fixed (JavaFieldLayout* fields = _fields)
+        fixed (T* recordPtr = &record)
+        {
+            Jvm.ThrowException(MudNative.SetFieldsBulk(Jvm.Env, &jobj, 1, fields, (nuint)_fields.Length, recordPtr, (nuint)sizeof(T)));
+        }
+    }
+
+    /// <summary>
+    /// Writes all of the layout's fields of each record into the java object at the same index
+    /// </summary>
+    /// <param name="objs">Objects to write to</param>
+    /// <param name="records">Values to be written, must be at least as long as objs</param>
+    public void Write(IReadOnlyList<IBoundObject> objs, ReadOnlySpan<T> records)
+    {
+        if (records.Length < objs.Count)
+        {
+            throw new ArgumentException($"{objs.Count} records are needed to write {objs.Count} objects", nameof(records));
+        }
+        var jobjs = objs.Count <= StackObjects ? stackalloc IntPtr[objs.Count] : new IntPtr[objs.Count];
+        GatherPtrs(objs, jobjs);
+        fixed (IntPtr* objPtrs = jobjs)
+        fixed (JavaFieldLayout* fields = _fields)
+        fixed (T* recordPtrs = records)
+        {
+            Jvm.ThrowException(MudNative.SetFieldsBulk(Jvm.Env, objPtrs, (nuint)jobjs.Length, fields, (nuint)_fields.Length,
+                recordPtrs, (nuint)sizeof(T)));
+        }
+    }
+
+    /// <exception cref="ArgumentException">Thrown when the object is not an instance of the layout's class</exception>
+    /// <exception cref="ObjectDisposedException">Thrown when the object's java object has been released</exception>
+    private IntPtr ObjPtr(IBoundObject? obj)
+    {
+        ArgumentNullException.ThrowIfNull(obj);
+        if (obj.IsStatic)
+        {
+            throw new InstanceMemberOnStaticException(typeof(T).Name, obj.Info);
+        }
+        // a released object keeps its class, so the instance check alone would pass it through as a null object
+        if (obj.Jobj == IntPtr.Zero)
+        {
+            throw new ObjectDisposedException(obj.GetType().Name, "The java object has already been released");
+        }
+        // the field ids are only valid on instances of the class, the JVM does not check them
+        if (!IsInstance(obj))
+        {
+            throw new ArgumentException($"A {obj.ClassPath} is not an instance of {Class.ClassPath}", nameof(obj));
+        }
+        return obj.Jobj;
+    }
+
+    private bool IsInstance(IBoundObject obj)
+    {
+        var info = obj.Info;
+        if (info == Class)
+        {
+            return true;
+        }
+        // an object is an instance of the class it's bound to, so one check covers every object bound to a subclass
+        if (info != null && _boundClasses.GetOrAdd(info, i => MudInterface.is_assignable_from(Jvm.Env, i.Cls, Class.Cls)))
+        {
+            return true;
+        }
+        return obj.InstanceOf(Class);
+    }
+
+    private void GatherPtrs(IReadOnlyList<IBoundObject> objs, Span<IntPtr> jobjs)
+    {
+        for (var i = 0; i < jobjs.Length; i++)
+        {
+            jobjs[i] = ObjPtr(objs[i]);
+        }
+    }
+
+    private static JavaType MapFieldType(FieldInfo field)
+    {
+        var type = field.FieldType;
+        if (type == typeof(int)) return JavaType.Int;
+        if (type == typeof(long)) return JavaType.Long;
+        if (type == typeof(double)) return JavaType.Double;
+        if (type == typeof(float)) return JavaType.Float;
+        if (type == typeof(bool)) return JavaType.Bool;
+        if (type == typeof(byte) || type == typeof(sbyte)) return JavaType.Byte;
+        if (type == typeof(short)) return JavaType.Short;
+        if (type == typeof(char)) return JavaType.Char;
+        throw new ArgumentException(
+            $"Field {field.Name} of {typeof(T).Name} is a {type.Name}, only java primitive types can be part of a field layout");
+    }
+
+    /// <summary>
+    /// Finds the field's byte offset within the struct by setting every bit of it on a boxed default
+    /// and looking for the first byte that changed, this holds for any layout the runtime picks
+    /// </summary>
+    private static uint FieldOffset(FieldInfo field)
+    {
+        object boxed = default(T);
+        field.SetValue(boxed, AllBitsSet(field.FieldType));
+        var bytes = MemoryMarshal.AsBytes(new ReadOnlySpan<T>(in Unsafe.Unbox<T>(boxed)));
+        return (uint)bytes.IndexOfAnyExcept((byte)0);
+    }
+
+    private static object AllBitsSet(Type type)
+    {
+        if (type == typeof(int)) return -1;
+        if (type == typeof(long)) return -1L;
+        if (type == typeof(double)) return BitConverter.Int64BitsToDouble(-1L);
+        if (type == typeof(float)) return BitConverter.Int32BitsToSingle(-1);
+        if (type == typeof(bool)) return true;
+        if (type == typeof(byte)) return byte.MaxValue;
+        if (type == typeof(sbyte)) return (sbyte)-1;
+        if (type == typeof(short)) return (short)-1;
+        return char.MaxValue;
+    }
+}
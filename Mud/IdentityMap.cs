@@ -0,0 +1,94 @@
+using System.Collections.Concurrent;
+using System.Runtime.CompilerServices;
+using Mud.Types;
+
+namespace Mud;
+
+/// <summary>
+/// Maps java objects back to the wrapper already bound to them while Jvm.PreserveIdentity is on, so a java object
+/// returned again reuses one live wrapper rather than binding another. The clib keys objects by identity hash through
+/// weak global refs, an entry is dropped once the java object is collected or once its wrapper is
+/// </summary>
+internal static class IdentityMap
+{
+    private static readonly ConcurrentDictionary<ulong, WeakReference<IBoundObject>> Wrappers = new();
+    private static readonly ConditionalWeakTable<IBoundObject, Entry> Entries = new();
+    /// <summary>
+    /// Entries of collected wrappers, removed on the next lookup rather than from the finalizer thread
+    /// </summary>
+    private static readonly ConcurrentQueue<(int Hash, ulong Token)> Collected = new();
+    private static long _lastToken;
+
+    /// <summary>
+    /// Amount of java objects mapped to a wrapper
+    /// </summary>
+    internal static long Count => (long)MudInterface.identity_count();
+
+    /// <summary>
+    /// Finds the live wrapper bound to the java object
+    /// </summary>
+    /// <param name="obj">The java object</param>
+    /// <param name="valType">Type the wrapper has to be an instance of</param>
+    /// <param name="wrapper">The wrapper</param>
+    /// <param name="hash">The object's identity hash, passed on to Add after a miss</param>
+    internal static unsafe bool TryGet(IntPtr obj, Type valType, out IBoundObject wrapper, out int hash)
+    {
+        if (!Collected.IsEmpty)
+        {
+            RemoveCollected();
+        }
+        int objHash;
+        var token = MudNative.IdentityGet(Jvm.Env, obj, &objHash);
+        hash = objHash;
+        // released wrappers no longer hold the object, and one bound to another type is replaced by the new one
+        if (token != 0 && Wrappers.TryGetValue(token, out var weak) && weak.TryGetTarget(out var target) &&
+            target.Jobj != IntPtr.Zero && valType.IsInstanceOfType(target))
+        {
+            wrapper = target;
+            return true;
+        }
+        wrapper = null!;
+        return false;
+    }
+
+    /// <summary>
+    /// Maps the java object to the wrapper, the wrapper must hold a handle so it outlives the current frame
+    /// </summary>
+    /// <param name="wrapper">The wrapper</param>
+    /// <param name="hash">Identity hash from the missed TryGet</param>
+    internal static void Add(IBoundObject wrapper, int hash)
+    {
+        var token = (ulong)Interlocked.Increment(ref _lastToken);
+        Wrappers[token] = new WeakReference<IBoundObject>(wrapper);
+        Entries.AddOrUpdate(wrapper, new Entry(hash, token));
+        MudInterface.identity_put(Jvm.Env, wrapper.Jobj, hash, token);
+    }
+
+    private static void RemoveCollected()
+    {
+        var env = Jvm.Env;
+        while (Collected.TryDequeue(out var entry))
+        {
+            Wrappers.TryRemove(entry.Token, out _);
+            // a no-op when the object has been mapped to a newer wrapper since
+            MudInterface.identity_remove(env, entry.Hash, entry.Token);
+        }
+    }
+
+    /// <summary>
+    /// Lives as long as the wrapper it was attached to, queues the wrapper's entry for removal once both are collected
+    /// </summary>
+    private sealed class Entry
+    {
+        private readonly int _hash;
+        private readonly ulong _token;
+
+        internal Entry(int hash, ulong token)
+        {
+            _hash = hash;
+            _token = token;
+        }
+
+        ~Entry() => Collected.Enqueue((_hash, _token));
+    }
+}
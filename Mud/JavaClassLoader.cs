@@ -0,0 +1,274 @@
+using System.Collections.Concurrent;
+using System.Diagnostics.CodeAnalysis;
+using System.Runtime.InteropServices;
+using Mud.Exceptions;
+using Mud.Types;
+
+namespace Mud;
+
+/// <summary>
+/// A java class loader over jars held in native memory. Jars are memory mapped, or copied from a buffer, and their
+/// central directories are indexed once, classes are then defined straight from that memory when they are first used
+/// rather than read from disk per class. Every loader is isolated, it sees the classes of its own jars and those of its
+/// parent, so plugins can each get a loader and bundle conflicting versions of a library.
+///
+/// Classes of a loader are resolved through TryGetClassInfo/GetClassInfo, Jvm.TryGetClassInfo resolves through the
+/// loaders added with Jvm.AddClassLoader. Only the .class entries of a jar are indexed, resources are not served, and
+/// compressed entries need Java 11 to be inflated
+/// </summary>
+public sealed class JavaClassLoader : IDisposable
+{
+    private readonly IntPtr _loader;
+    private readonly ConcurrentDictionary<string, ClassInfo> _classes = new();
+
+    /// <summary>
+    /// Calls using the native loader plus one held until the loader is disposed, the last one out closes it
+    /// </summary>
+    private int _users = 1;
+    private int _disposed;
+
+    /// <summary>
+    /// The loader's java.lang.ClassLoader, e.g. to pass it to java or to use it as the parent of another loader
+    /// </summary>
+    public IBoundObject Loader { get; }
+
+    /// <summary>
+    /// Amount of classes indexed across the loader's jars
+    /// </summary>
+    public long ClassCount
+    {
+        get
+        {
+            Acquire();
+            try
+            {
+                return (long)MudInterface.loader_class_count(_loader);
+            }
+            finally
+            {
+                ReleaseUse();
+            }
+        }
+    }
+
+    /// <summary>
+    /// Keeps the native loader open until the matching ReleaseUse, so Dispose can't free it under a running call
+    /// </summary>
+    /// <exception cref="ObjectDisposedException">Throws if the loader has been disposed</exception>
+    private void Acquire()
+    {
+        int users;
+        do
+        {
+            users = Volatile.Read(ref _users);
+            if (users == 0 || Volatile.Read(ref _disposed) != 0)
+            {
+                throw new ObjectDisposedException(nameof(JavaClassLoader));
+            }
+        } while (Interlocked.CompareExchange(ref _users, users + 1, users) != users);
+    }
+
+    private void ReleaseUse()
+    {
+        if (Interlocked.Decrement(ref _users) == 0)
+        {
+            MudInterface.loader_close(Jvm.Env, _loader);
+        }
+    }
+
+    private JavaClassLoader(IntPtr loader)
+    {
+        _loader = loader;
+        // the loader object lives as long as the loader rather than the scope it was created in
+        using var unscoped = JvmScope.Suspend();
+        Loader = TypeMap.MapJValue<BoundObject>(JavaType.Object,
+            new JavaVal { Object = MudInterface.loader_object(Jvm.Env, loader) });
+    }
+
+    /// <summary>
+    /// Creates a loader without any jars
+    /// </summary>
+    /// <param name="parent">Loader asked for a class before this one, defaults to the system class loader</param>
+    public static JavaClassLoader Create(JavaClassLoader? parent = null)
+    {
+        Jvm.EnsureInit();
+        var loader = MudInterface.loader_create(Jvm.Env, parent?.Loader.Jobj ?? IntPtr.Zero);
+        if (loader == IntPtr.Zero)
+        {
+            Jvm.ThrowException(MudInterface.check_exception(Jvm.Env));
+            throw new InvalidOperationException("Unable to create a java class loader");
+        }
+        try
+        {
+            return new JavaClassLoader(loader);
+        }
+        catch
+        {
+            MudInterface.loader_close(Jvm.Env, loader);
+            throw;
+        }
+    }
+
+    /// <summary>
+    /// Creates a loader over the jars
+    /// </summary>
+    /// <param name="jarPaths">Paths of the jars, a class in an earlier jar wins</param>
+    public static JavaClassLoader Open(params string[] jarPaths) => Open(null, jarPaths);
+
+    /// <summary>
+    /// Creates a loader over the jars
+    /// </summary>
+    /// <param name="parent">Loader asked for a class before this one, defaults to the system class loader</param>
+    /// <param name="jarPaths">Paths of the jars, a class in an earlier jar wins</param>
+    public static JavaClassLoader Open(JavaClassLoader? parent, params string[] jarPaths)
+    {
+        var loader = Create(parent);
+        try
+        {
+            foreach (var path in jarPaths)
+            {
+                loader.AddJar(path);
+            }
+            return loader;
+        }
+        catch
+        {
+            loader.Dispose();
+            throw;
+        }
+    }
+
+    /// <summary>
+    /// Memory maps the jar and indexes its classes, a class of a jar added earlier wins
+    /// </summary>
+    /// <param name="path">Path of the jar</param>
+    /// <exception cref="FileNotFoundException">Will throw if the jar does not exist</exception>
+    /// <exception cref="InvalidDataException">Will throw if the file is not a jar</exception>
+    public void AddJar(string path)
+    {
+        path = Path.GetFullPath(path);
+        if (!File.Exists(path))
+        {
+            throw new FileNotFoundException("Jar not found", path);
+        }
+        Acquire();
+        try
+        {
+            if (!MudInterface.loader_add_jar(_loader, path))
+            {
+                throw new InvalidDataException($"{path} is not a jar that can be loaded");
+            }
+        }
+        finally
+        {
+            ReleaseUse();
+        }
+    }
+
+    /// <summary>
+    /// Indexes the classes of a jar held in memory, the bytes are copied so the buffer can be reused once this returns
+    /// </summary>
+    /// <param name="jar">Contents of the jar</param>
+    /// <exception cref="InvalidDataException">Will throw if the bytes are not a jar</exception>
+    public void AddJar(ReadOnlySpan<byte> jar)
+    {
+        if (jar.IsEmpty)
+        {
+            throw new InvalidDataException("The bytes are not a jar that can be loaded");
+        }
+        Acquire();
+        try
+        {
+            if (!MudInterface.loader_add_jar_bytes(_loader, ref MemoryMarshal.GetReference(jar), (nuint)jar.Length))
+            {
+                throw new InvalidDataException("The bytes are not a jar that can be loaded");
+            }
+        }
+        finally
+        {
+            ReleaseUse();
+        }
+    }
+
+    /// <summary>
+    /// Resolves the class through the loader's parent first and then its jars
+    /// </summary>
+    /// <param name="classPath">The java class path</param>
+    /// <param name="classInfo">The class</param>
+    public bool TryGetClassInfo(string classPath, [NotNullWhen(true)] out ClassInfo? classInfo)
+    {
+        Jvm.EnsureInit();
+        classPath = classPath.Replace(".", "/");
+        if (_classes.TryGetValue(classPath, out classInfo))
+        {
+            return true;
+        }
+        lock (_classes)
+        {
+            if (_classes.TryGetValue(classPath, out classInfo))
+            {
+                return true;
+            }
+            var localCls = LoadClass(classPath);
+            if (localCls == IntPtr.Zero)
+            {
+                return false;
+            }
+            classInfo = _classes[classPath] = Jvm.ClassInfoOf(localCls, classPath);
+            MudInterface.release_obj(Jvm.Env, localCls);
+            return true;
+        }
+    }
+
+    /// <exception cref="Mud.Exceptions.ClassNotFoundException"></exception>
+    public ClassInfo GetClassInfo(string classPath)
+    {
+        if (TryGetClassInfo(classPath, out var cls))
+        {
+            return cls;
+        }
+
+        throw new ClassNotFoundException(classPath);
+    }
+
+    /// <summary>
+    /// Loads the class, the local ref is released by the caller
+    /// </summary>
+    /// <param name="classPath">The java class path with slashes</param>
+    /// <returns>The class, zero when it is not found</returns>
+    /// <exception cref="JavaException">Throws if the class was found but could not be defined</exception>
+    internal IntPtr LoadClass(string classPath)
+    {
+        Acquire();
+        IntPtr localCls;
+        try
+        {
+            localCls = MudInterface.loader_load_class(Jvm.Env, _loader, classPath);
+        }
+        finally
+        {
+            ReleaseUse();
+        }
+        if (localCls == IntPtr.Zero)
+        {
+            // a missing class is cleared natively, any other error is left pending
+            Jvm.ThrowException(MudInterface.check_exception(Jvm.Env));
+        }
+        return localCls;
+    }
+
+    /// <summary>
+    /// Unmaps the loader's jars once the calls running on it return, classes already resolved stay usable but no new ones
+    /// are found
+    /// </summary>
+    public void Dispose()
+    {
+        if (Interlocked.Exchange(ref _disposed, 1) != 0)
+        {
+            return;
+        }
+        Jvm.RemoveClassLoader(this);
+        Loader.Release();
+        ReleaseUse();
+    }
+}
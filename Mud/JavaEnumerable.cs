@@ -0,0 +1,244 @@
+using System.Buffers;
+using System.Runtime.CompilerServices;
+using System.Runtime.InteropServices;
+using Mud.Types;
+
+namespace Mud;
+
+/// <summary>
+/// Streams the elements of java Iterables, Iterators and Streams into .NET in chunks, each chunk is pulled from the
+/// iterator with a single native call. Primitive elements are unboxed natively and strings copied in bulk,
+/// the local refs of a chunk are released together by popping the local frame it was pulled in
+/// </summary>
+public static class JavaEnumerable
+{
+    /// <summary>
+    /// Number of elements pulled per native call when no chunk size is given
+    /// </summary>
+    public const int DefaultChunkSize = 256;
+
+    // chunks up to this size gather their element refs on the stack
+    private const int StackRefs = 512;
+    private const int StringBufferChars = 16 * 1024;
+    private static readonly CustomType IteratorType = new("java.util.Iterator");
+
+    internal static IEnumerable<T> Enumerate<T>(IBoundObject source, int chunkSize)
+    {
+        ValidateChunkSize(chunkSize);
+        var iterator = IteratorOf(source, out var owned);
+        try
+        {
+            var chunk = new T[chunkSize];
+            while (true)
+            {
+                var count = NextChunk(iterator.Jobj, chunk, out var done);
+                for (var i = 0; i < count; i++)
+                {
+                    yield return chunk[i];
+                }
+                if (done)
+                {
+                    yield break;
+                }
+            }
+        }
+        finally
+        {
+            if (owned)
+            {
+                iterator.Release();
+            }
+        }
+    }
+
+    internal static async IAsyncEnumerable<T> EnumerateAsync<T>(IBoundObject source, int chunkSize,
+        [EnumeratorCancellation] CancellationToken cancellationToken)
+    {
+        ValidateChunkSize(chunkSize);
+        var pool = Jvm.WorkerPool;
+        var (iterator, owned) = await pool.Run(() => (IteratorOf(source, out var o), o), cancellationToken);
+        // two buffers alternate so the next chunk is pulled on the pool while the current one is consumed
+        var buffers = new[] { new T[chunkSize], new T[chunkSize] };
+        Task<(int Count, bool Done)>? pending = null;
+        try
+        {
+            var current = 0;
+            var next = pending = Pull(buffers[current]);
+            while (true)
+            {
+                var (count, done) = await next;
+                pending = null;
+                var chunk = buffers[current];
+                if (!done)
+                {
+                    current ^= 1;
+                    next = pending = Pull(buffers[current]);
+                }
+                for (var i = 0; i < count; i++)
+                {
+                    yield return chunk[i];
+                }
+                if (done)
+                {
+                    yield break;
+                }
+            }
+        }
+        finally
+        {
+            // the iterator can only be released once no worker is pulling from it
+            if (pending != null)
+            {
+                try
+                {
+                    await pending;
+                }
+                catch
+                {
+                    // the consumer already stopped, so failures of the prefetched chunk have no one to go to
+                }
+            }
+            if (owned)
+            {
+                iterator.Release();
+            }
+        }
+
+        Task<(int, bool)> Pull(T[] dest) => pool.Run(() =>
+        {
+            var count = NextChunk(iterator.Jobj, dest, out var done);
+            return (count, done);
+        }, cancellationToken).AsTask();
+    }
+
+    private static void ValidateChunkSize(int chunkSize)
+    {
+        if (chunkSize <= 0)
+        {
+            throw new ArgumentOutOfRangeException(nameof(chunkSize), "Chunk size must be positive");
+        }
+    }
+
+    private static IBoundObject IteratorOf(IBoundObject source, out bool owned)
+    {
+        owned = false;
+        if (source.InstanceOf("java.util.Iterator"))
+        {
+            return source;
+        }
+        if (!source.InstanceOf("java.lang.Iterable") && !source.InstanceOf("java.util.stream.BaseStream"))
+        {
+            throw new ArgumentException($"{source.ClassPath} is not an Iterable, Iterator or Stream", nameof(source));
+        }
+        owned = true;
+        return source.Call("iterator", IteratorType, Array.Empty<TypedArg>());
+    }
+
+    /// <summary>
+    /// Pulls up to dest.Length elements from the iterator into dest
+    /// </summary>
+    /// <returns>The number of elements pulled</returns>
+    private static unsafe int NextChunk<T>(IntPtr iterator, T[] dest, out bool done)
+    {
+        JavaChunk chunk;
+        if (TypeMap.TryGetBlittablePrimitive(typeof(T), out var primType))
+        {
+            fixed (byte* values = &Unsafe.As<T, byte>(ref MemoryMarshal.GetArrayDataReference(dest)))
+            {
+                chunk = MudNative.IteratorNextChunk(Jvm.Env, iterator, primType, (nuint)dest.Length, values);
+            }
+            Jvm.ThrowException(chunk.Exception);
+            done = chunk.Done != 0;
+            return (int)chunk.Count;
+        }
+
+        var refs = dest.Length <= StackRefs ? stackalloc IntPtr[dest.Length] : new IntPtr[dest.Length];
+        // the elements outlive the chunk's frame so they are never left as locals of a JvmScope
+        using var unscoped = JvmScope.Suspend();
+        if (MudNative.PushLocalFrame(Jvm.Env, dest.Length + 1) == 0)
+        {
+            Jvm.ThrowException(MudInterface.check_exception(Jvm.Env));
+        }
+        chunk = default;
+        try
+        {
+            fixed (IntPtr* refPtrs = refs)
+            {
+                chunk = MudNative.IteratorNextChunk(Jvm.Env, iterator, JavaType.Object, (nuint)dest.Length, refPtrs);
+            }
+            var elems = refs[..(int)chunk.Count];
+            if (typeof(T) == typeof(string))
+            {
+                CopyStrings(elems, Unsafe.As<T[], string?[]>(ref dest));
+            }
+            else
+            {
+                // plain IBoundObject elements are bound as BoundObject, like any other unmapped class
+                var valType = typeof(T) == typeof(IBoundObject) ? typeof(BoundObject) : typeof(T);
+                for (var i = 0; i < elems.Length; i++)
+                {
+                    dest[i] = (T)TypeMap.MapJValue(JavaType.Object, valType, new JavaVal { Object = elems[i] });
+                }
+            }
+        }
+        finally
+        {
+            // the exception is the only ref of the chunk that outlives its frame
+            chunk.Exception = MudNative.PopLocalFrame(Jvm.Env, chunk.Exception);
+        }
+        Jvm.ThrowException(chunk.Exception);
+        done = chunk.Done != 0;
+        return (int)chunk.Count;
+    }
+
+    /// <summary>
+    /// Copies the java strings into dest with as few native calls as the shared char buffer allows
+    /// </summary>
+    private static unsafe void CopyStrings(ReadOnlySpan<IntPtr> strs, string?[] dest)
+    {
+        var lengths = strs.Length <= StackRefs ? stackalloc int[strs.Length] : new int[strs.Length];
+        var buf = ArrayPool<char>.Shared.Rent(StringBufferChars);
+        try
+        {
+            var copied = 0;
+            while (copied < strs.Length)
+            {
+                nuint count;
+                fixed (IntPtr* strPtrs = strs[copied..])
+                fixed (char* chars = buf)
+                fixed (int* lens = lengths[copied..])
+                {
+                    count = MudNative.StringsCopyUtf16(Jvm.Env, strPtrs, (nuint)(strs.Length - copied), chars,
+                        (nuint)buf.Length, lens);
+                }
+                var offset = 0;
+                for (var i = copied; i < copied + (int)count; i++)
+                {
+                    var len = lengths[i];
+                    dest[i] = len < 0 ? null : new string(buf, offset, len);
+                    offset += Math.Max(len, 0);
+                }
+                copied += (int)count;
+                if (copied == strs.Length)
+                {
+                    break;
+                }
+                // stopped early, either at a string that does not fit or at an element that is not a string
+                Jvm.ThrowException(MudInterface.check_exception(Jvm.Env));
+                if (count == 0 && lengths[copied] <= buf.Length)
+                {
+                    throw new InvalidOperationException("Unable to copy the java strings");
+                }
+                if (lengths[copied] > buf.Length)
+                {
+                    ArrayPool<char>.Shared.Return(buf);
+                    buf = ArrayPool<char>.Shared.Rent(lengths[copied]);
+                }
+            }
+        }
+        finally
+        {
+            ArrayPool<char>.Shared.Return(buf);
+        }
+    }
+}
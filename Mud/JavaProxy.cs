@@ -0,0 +1,178 @@
+using System.Collections.Concurrent;
+using System.Runtime.CompilerServices;
+using System.Runtime.InteropServices;
+using Mud.Exceptions;
+using Mud.Types;
+
+namespace Mud;
+
+/// <summary>
+/// A java object implementing a java interface whose methods are handled by .NET, letting java push calls
+/// such as listener events straight into .NET on whichever java thread makes them.
+/// Calls are routed through a java.lang.reflect.Proxy whose invocation handler is bound to mud via RegisterNatives,
+/// hashCode, equals and toString are answered by mud without calling the handler
+/// </summary>
+public sealed unsafe class JavaProxy : IDisposable
+{
+    private static readonly ConcurrentDictionary<ulong, JavaProxy> Proxies = new();
+    private static readonly ConcurrentDictionary<IntPtr, string> MethodNames = new();
+    private static readonly object InitLock = new();
+    private static bool _initialized;
+    private static long _lastHandle;
+
+    private readonly ulong _handle;
+    private readonly Func<JavaUpcall, object?> _handler;
+
+    /// <summary>
+    /// The interface the proxy implements
+    /// </summary>
+    public ClassInfo Interface { get; }
+
+    /// <summary>
+    /// The java proxy object, pass it to java wherever the interface is expected
+    /// </summary>
+    public IBoundObject Object { get; }
+
+    /// <summary>
+    /// Whether the proxy has been disposed, java calls made on a disposed proxy throw a RuntimeException
+    /// </summary>
+    public bool IsDisposed { get; private set; }
+
+    private JavaProxy(ClassInfo iface, Func<JavaUpcall, object?> handler)
+    {
+        Interface = iface;
+        _handler = handler;
+        _handle = (ulong)Interlocked.Increment(ref _lastHandle);
+        Proxies[_handle] = this;
+        var proxy = MudInterface.upcall_proxy(Jvm.Env, iface.Cls, _handle);
+        if (proxy == IntPtr.Zero)
+        {
+            Proxies.TryRemove(_handle, out _);
+            Jvm.ThrowException(MudInterface.check_exception(Jvm.Env));
+        }
+        // the proxy lives until disposed, not until the end of the scope it was made in
+        using var unscoped = JvmScope.Suspend();
+        Object = TypeMap.MapJValue<BoundObject>(JavaType.Object, new JavaVal { Object = proxy });
+    }
+
+    /// <summary>
+    /// Creates a java object implementing the interface, every call java makes on it is handed to the handler
+    /// </summary>
+    /// <param name="iface">The java interface to implement</param>
+    /// <param name="handler">Handles each call, its result is returned to java and primitives are boxed as needed</param>
+    public static JavaProxy Create(ClassInfo iface, Func<JavaUpcall, object?> handler)
+    {
+        Jvm.EnsureInit();
+        EnsureUpcallsBound();
+        return new JavaProxy(iface, handler);
+    }
+
+    /// <summary>
+    /// Creates a java object implementing the interface, every call java makes on it is handed to the handler
+    /// </summary>
+    /// <param name="iface">Class path of the java interface to implement</param>
+    /// <param name="handler">Handles each call, its result is returned to java and primitives are boxed as needed</param>
+    public static JavaProxy Create(string iface, Func<JavaUpcall, object?> handler) =>
+        Create(Jvm.GetClassInfo(iface), handler);
+
+    /// <summary>
+    /// Number of proxies that have not been disposed
+    /// </summary>
+    public static int Active => Proxies.Count;
+
+    /// <summary>
+    /// Stops handling calls and releases the proxy object, java calls made on it afterwards throw a RuntimeException
+    /// </summary>
+    public void Dispose()
+    {
+        if (IsDisposed)
+        {
+            return;
+        }
+        IsDisposed = true;
+        Proxies.TryRemove(_handle, out _);
+        Object.Release();
+    }
+
+    private static void EnsureUpcallsBound()
+    {
+        if (_initialized)
+        {
+            return;
+        }
+        lock (InitLock)
+        {
+            if (_initialized)
+            {
+                return;
+            }
+            delegate* unmanaged[Cdecl]<IntPtr, ulong, IntPtr, IntPtr, IntPtr, IntPtr, JavaVal*, JavaType> dispatch = &Dispatch;
+            if (!MudInterface.upcall_init(Jvm.Env, (IntPtr)dispatch))
+            {
+                Jvm.ThrowException(MudInterface.check_exception(Jvm.Env));
+                throw new JvmNotInitializedException("Unable to bind the mud invocation handler");
+            }
+            _initialized = true;
+        }
+    }
+
+    [UnmanagedCallersOnly(CallConvs = new[] { typeof(CallConvCdecl) })]
+    private static JavaType Dispatch(IntPtr env, ulong handle, IntPtr proxy, IntPtr methodId, IntPtr method, IntPtr args,
+        JavaVal* result)
+    {
+        Jvm.EnterUpcall(env);
+        // objects bound by the handler must not be left in the upcall's frame, which java pops when the upcall returns
+        using var unscoped = JvmScope.Suspend();
+        try
+        {
+            if (!Proxies.TryGetValue(handle, out var target))
+            {
+                MudInterface.upcall_throw(env, IntPtr.Zero, $"Mud proxy {handle} has been disposed");
+                return JavaType.Void;
+            }
+            var call = new JavaUpcall(MethodName(methodId, method), args);
+            return MapResult(target.Invoke(call, proxy), result);
+        }
+        catch (JavaException e) when (e.Throwable != null)
+        {
+            MudInterface.upcall_throw(env, e.Throwable.Jobj, null);
+        }
+        catch (Exception e)
+        {
+            MudInterface.upcall_throw(env, IntPtr.Zero, $"{e.GetType().FullName}: {e.Message}");
+        }
+        return JavaType.Void;
+    }
+
+    private object? Invoke(JavaUpcall call, IntPtr proxy) => (call.Method, call.ArgCount) switch
+    {
+        ("hashCode", 0) => _handle.GetHashCode(),
+        ("equals", 1) => MudInterface.is_same_object(Jvm.Env, proxy,
+            MudInterface.array_get_at(Jvm.Env, call.Args, 0, JavaType.Object).Object),
+        ("toString", 0) => $"{Interface.ClassPath}$MudProxy@{_handle}",
+        _ => _handler(call)
+    };
+
+    private static string MethodName(IntPtr methodId, IntPtr method) =>
+        MethodNames.GetOrAdd(methodId, _ =>
+        {
+            var reflected = TypeMap.MapJValue<BoundObject>(JavaType.Object, new JavaVal { Object = method });
+            try
+            {
+                return reflected.Call<string>("getName");
+            }
+            finally
+            {
+                reflected.Release();
+            }
+        });
+
+    private static JavaType MapResult(object? value, JavaVal* result)
+    {
+        // any local refs made for the result belong to the upcall's frame and are freed when it returns to java
+        *result = Jvm.MapArg(value, new List<IntPtr>());
+        return value != null && TypeMap.TryGetBlittablePrimitive(value.GetType(), out var primType)
+            ? primType
+            : JavaType.Object;
+    }
+}
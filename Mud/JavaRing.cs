@@ -0,0 +1,315 @@
+using System.Buffers;
+using System.Numerics;
+using Mud.Types;
+
+namespace Mud;
+
+/// <summary>
+/// Handles a message read from a JavaRing, the span points into the ring and is only valid during the call
+/// </summary>
+public delegate void RingMessageHandler(ReadOnlySpan<byte> message);
+
+/// <summary>
+/// A single producer single consumer ring buffer in native memory that java sees as a direct ByteBuffer, so messages
+/// cross between .NET and java without copies or JNI calls. Either side can produce, the other consumes.
+///
+/// The buffer starts with a header of 64 bit words in native byte order, each on its own cache line: the bytes ever
+/// published by the producer at 0 (head), the bytes ever released by the consumer at 64 (tail), the threads blocked
+/// on the ring at 128 and the data capacity at 192. The data starts at 256, each message is an int length followed
+/// by the payload and padded to 8 bytes. A length of -1 means the rest of the data up to its end is skipped.
+///
+/// Java reads and writes head and tail with acquire and release semantics through a VarHandle made by
+/// MethodHandles.byteBufferViewVarHandle, after setting the buffer's order to ByteOrder.nativeOrder().
+/// A side that wants to block calls mud.NativeRing.awaitReadable or awaitWritable with Address, and a side that
+/// moved head or tail calls mud.NativeRing.signal with Address when it then finds the waiters word set
+/// </summary>
+public sealed unsafe class JavaRing : IDisposable
+{
+    private const int HeadOffset = 0;
+    private const int TailOffset = 64;
+    private const int WaitersOffset = 128;
+    private const int HeaderSize = 256;
+    private const int LengthSize = sizeof(int);
+    private const int Alignment = 8;
+    private const int Padding = -1;
+
+    private IntPtr _ring;
+    private readonly byte* _memory;
+    private readonly byte* _data;
+    private readonly long _mask;
+    // end of the message reserved by the producer, published as the new head
+    private long _reservedEnd;
+
+    /// <summary>
+    /// Size of the data in bytes
+    /// </summary>
+    public int Capacity { get; }
+
+    /// <summary>
+    /// Longest message the ring accepts, half the capacity so a message always fits once the ring drains
+    /// </summary>
+    public int MaxMessageLength => Capacity / 2 - Alignment;
+
+    /// <summary>
+    /// The java.nio.ByteBuffer over the ring's memory, in native byte order
+    /// </summary>
+    public IBoundObject Buffer { get; }
+
+    /// <summary>
+    /// The ring's address as java's mud.NativeRing methods take it
+    /// </summary>
+    public long Address => (long)_ring;
+
+    private ref long Head => ref *(long*)(_memory + HeadOffset);
+    private ref long Tail => ref *(long*)(_memory + TailOffset);
+    private ref long Waiters => ref *(long*)(_memory + WaitersOffset);
+
+    private JavaRing(IntPtr ring, int capacity)
+    {
+        _ring = ring;
+        _memory = (byte*)MudInterface.ring_memory(ring);
+        _data = _memory + HeaderSize;
+        _mask = capacity - 1;
+        Capacity = capacity;
+
+        // the buffer lives as long as the ring rather than the scope it was created in
+        using var unscoped = JvmScope.Suspend();
+        var buffer = TypeMap.MapJValue<BoundObject>(JavaType.Object,
+            new JavaVal { Object = MudInterface.ring_buffer(Jvm.Env, ring) });
+        var byteOrder = new CustomType("java.nio.ByteOrder");
+        using var nativeOrder = Jvm.GetClassInfo("java.nio.ByteOrder").Call("nativeOrder", byteOrder, Array.Empty<TypedArg>());
+        // order returns the buffer itself
+        buffer.Call("order", new CustomType("java.nio.ByteBuffer"), new[] { new TypedArg(nativeOrder, byteOrder) }).Release();
+        Buffer = buffer;
+    }
+
+    /// <summary>
+    /// Allocates a ring, the capacity is rounded up to a power of two
+    /// </summary>
+    /// <param name="capacity">Minimum size of the data in bytes</param>
+    public static JavaRing Create(int capacity)
+    {
+        if (capacity is < 64 or > 1 << 30)
+        {
+            throw new ArgumentOutOfRangeException(nameof(capacity), "Ring capacity must be between 64 bytes and 1GiB");
+        }
+        Jvm.EnsureInit();
+        if (!MudInterface.ring_init(Jvm.Env))
+        {
+            Jvm.ThrowException(MudInterface.check_exception(Jvm.Env));
+        }
+        capacity = (int)BitOperations.RoundUpToPowerOf2((uint)capacity);
+        var ring = MudInterface.ring_create((ulong)capacity);
+        if (ring == IntPtr.Zero)
+        {
+            throw new OutOfMemoryException($"Unable to allocate a {capacity} byte ring");
+        }
+        try
+        {
+            return new JavaRing(ring, capacity);
+        }
+        catch
+        {
+            MudInterface.ring_destroy(ring);
+            throw;
+        }
+    }
+
+    /// <summary>
+    /// Bytes published and not read yet
+    /// </summary>
+    public int Readable => (int)(Volatile.Read(ref Head) - Volatile.Read(ref Tail));
+
+    /// <summary>
+    /// Publishes a copy of the message, only one thread may write at a time
+    /// </summary>
+    /// <returns>False when the ring does not have room for the message</returns>
+    public bool TryWrite(ReadOnlySpan<byte> message)
+    {
+        if (!TryReserve(message.Length, out var dest, out _))
+        {
+            return false;
+        }
+        message.CopyTo(dest);
+        Publish();
+        return true;
+    }
+
+    /// <summary>
+    /// Publishes a message written straight into the ring by the writer, only one thread may write at a time
+    /// </summary>
+    /// <param name="length">Length of the message</param>
+    /// <param name="state">Passed to the writer</param>
+    /// <param name="writer">Fills the message</param>
+    /// <returns>False when the ring does not have room for the message</returns>
+    public bool TryWrite<TState>(int length, TState state, SpanAction<byte, TState> writer)
+    {
+        if (!TryReserve(length, out var dest, out _))
+        {
+            return false;
+        }
+        writer(dest, state);
+        Publish();
+        return true;
+    }
+
+    /// <summary>
+    /// Publishes a copy of the message, blocking while the ring is full
+    /// </summary>
+    /// <param name="message">The message</param>
+    /// <param name="timeout">Longest time to block for, Timeout.InfiniteTimeSpan to wait until there is room</param>
+    /// <returns>False when the timeout passed before there was room for the message</returns>
+    public bool Write(ReadOnlySpan<byte> message, TimeSpan timeout)
+    {
+        var deadline = Deadline(timeout);
+        while (true)
+        {
+            if (TryReserve(message.Length, out var dest, out var required))
+            {
+                message.CopyTo(dest);
+                Publish();
+                return true;
+            }
+            if (!Await(deadline, remaining => MudInterface.ring_await_writable(_ring, (ulong)required, remaining) >= (ulong)required))
+            {
+                return false;
+            }
+        }
+    }
+
+    /// <summary>
+    /// Hands the published messages to the handler in order and releases their space, only one thread may read at a time
+    /// </summary>
+    /// <param name="handler">Handles each message</param>
+    /// <param name="limit">Most messages to read</param>
+    /// <returns>The number of messages read</returns>
+    /// <exception cref="InvalidDataException">Throws if a message's length does not fit the published messages</exception>
+    public int Read(RingMessageHandler handler, int limit = int.MaxValue)
+    {
+        var tail = Tail;
+        var head = Volatile.Read(ref Head);
+        var read = 0;
+        try
+        {
+            while (tail < head && read < limit)
+            {
+                var offset = tail & _mask;
+                if (head - tail < LengthSize)
+                {
+                    throw new InvalidDataException($"The ring holds a partial message length at {tail}");
+                }
+                var length = *(int*)(_data + offset);
+                if (length == Padding && Capacity - offset <= head - tail)
+                {
+                    tail += Capacity - offset;
+                    continue;
+                }
+                // the buffer is shared with java, so a corrupt length must not read past the published messages
+                if ((uint)length > (uint)MaxMessageLength || LengthSize + length > head - tail)
+                {
+                    throw new InvalidDataException($"The ring holds a message of invalid length {length} at {tail}");
+                }
+                handler(new ReadOnlySpan<byte>(_data + offset + LengthSize, length));
+                tail += RecordLength(length);
+                read++;
+            }
+        }
+        finally
+        {
+            // space of the messages handled before a handler threw is released as well
+            Volatile.Write(ref Tail, tail);
+            SignalWaiters();
+        }
+        return read;
+    }
+
+    /// <summary>
+    /// Blocks until there is a message to read
+    /// </summary>
+    /// <param name="timeout">Longest time to block for, Timeout.InfiniteTimeSpan to wait until there is a message</param>
+    /// <returns>False when the timeout passed first</returns>
+    public bool WaitReadable(TimeSpan timeout) =>
+        Readable > 0 || Await(Deadline(timeout), remaining => MudInterface.ring_await_readable(_ring, remaining) > 0);
+
+    private bool TryReserve(int length, out Span<byte> dest, out long required)
+    {
+        if ((uint)length > (uint)MaxMessageLength)
+        {
+            throw new ArgumentOutOfRangeException(nameof(length), $"Messages are limited to {MaxMessageLength} bytes");
+        }
+        var head = Head;
+        var offset = head & _mask;
+        var toEnd = Capacity - offset;
+        var recordLength = RecordLength(length);
+        // a message never wraps, the rest of the data is skipped when it does not fit before the end
+        required = recordLength > toEnd ? recordLength + toEnd : recordLength;
+        if (required > Capacity - (head - Volatile.Read(ref Tail)))
+        {
+            dest = default;
+            return false;
+        }
+        if (recordLength > toEnd)
+        {
+            // the skipped space is published along with the message
+            *(int*)(_data + offset) = Padding;
+            head += toEnd;
+            offset = 0;
+        }
+        *(int*)(_data + offset) = length;
+        _reservedEnd = head + recordLength;
+        dest = new Span<byte>(_data + offset + LengthSize, length);
+        return true;
+    }
+
+    private void Publish()
+    {
+        Volatile.Write(ref Head, _reservedEnd);
+        SignalWaiters();
+    }
+
+    /// <summary>
+    /// Wakes the other side if it is blocked on the ring, the fence orders the head or tail store before the waiters load
+    /// </summary>
+    private void SignalWaiters()
+    {
+        Interlocked.MemoryBarrier();
+        if (Volatile.Read(ref Waiters) != 0)
+        {
+            MudInterface.ring_signal(_ring);
+        }
+    }
+
+    private static long RecordLength(int length) => (LengthSize + length + Alignment - 1) & ~(long)(Alignment - 1);
+
+    private static long Deadline(TimeSpan timeout) =>
+        timeout == Timeout.InfiniteTimeSpan ? -1 : Environment.TickCount64 + (long)timeout.TotalMilliseconds;
+
+    /// <param name="deadline">Tick count to give up at, negative to never give up</param>
+    /// <param name="wait">Blocks for at most the remaining nanoseconds, negative to block until woken</param>
+    private static bool Await(long deadline, Func<long, bool> wait)
+    {
+        long remaining = -1;
+        if (deadline >= 0)
+        {
+            var ms = deadline - Environment.TickCount64;
+            if (ms <= 0)
+            {
+                return false;
+            }
+            remaining = ms * 1_000_000;
+        }
+        return wait(remaining);
+    }
+
+    public void Dispose()
+    {
+        if (_ring == IntPtr.Zero)
+        {
+            return;
+        }
+        // java must be done with the buffer by now, its memory is freed along with the ring
+        Buffer.Release();
+        MudInterface.ring_destroy(_ring);
+        _ring = IntPtr.Zero;
+    }
+}
@@ -0,0 +1,75 @@
+using Mud.Types;
+
+namespace Mud;
+
+/// <summary>
+/// A call made from java on a JavaProxy, only valid for the duration of the call
+/// </summary>
+public sealed class JavaUpcall
+{
+    /// <summary>
+    /// The java Object[] of arguments, null when the method takes none
+    /// </summary>
+    internal IntPtr Args { get; }
+
+    /// <summary>
+    /// Name of the interface method java called
+    /// </summary>
+    public string Method { get; }
+
+    /// <summary>
+    /// Number of arguments java passed
+    /// </summary>
+    public int ArgCount { get; }
+
+    internal JavaUpcall(string method, IntPtr args)
+    {
+        Method = method;
+        Args = args;
+        ArgCount = args == IntPtr.Zero ? 0 : MudInterface.array_length(Jvm.Env, args);
+    }
+
+    /// <summary>
+    /// Gets an argument of the call, java passes primitives boxed so they are unboxed when T is a primitive
+    /// </summary>
+    /// <param name="index">Index of the argument</param>
+    /// <typeparam name="T">Type to map the argument to</typeparam>
+    /// <exception cref="InvalidCastException">Thrown when a primitive is requested for a null argument</exception>
+    public T Arg<T>(int index)
+    {
+        if ((uint)index >= (uint)ArgCount)
+        {
+            throw new ArgumentOutOfRangeException(nameof(index), $"{Method} was called with {ArgCount} arguments");
+        }
+        var arg = MudInterface.array_get_at(Jvm.Env, Args, index, JavaType.Object);
+        if (!TypeMap.TryGetBlittablePrimitive(typeof(T), out var primType))
+        {
+            return TypeMap.MapJValue<T>(JavaType.Object, arg);
+        }
+        if (arg.Object == IntPtr.Zero)
+        {
+            throw new InvalidCastException($"Argument {index} of {Method} is null and cannot be read as {typeof(T).Name}");
+        }
+        var boxed = TypeMap.MapJValue<BoundObject>(JavaType.Object, arg);
+        try
+        {
+            return boxed.Call<T>(UnboxMethod(primType));
+        }
+        finally
+        {
+            boxed.Release();
+        }
+    }
+
+    private static string UnboxMethod(JavaType type) => type switch
+    {
+        JavaType.Int => "intValue",
+        JavaType.Long => "longValue",
+        JavaType.Double => "doubleValue",
+        JavaType.Float => "floatValue",
+        JavaType.Short => "shortValue",
+        JavaType.Byte => "byteValue",
+        JavaType.Bool => "booleanValue",
+        _ => "charValue"
+    };
+}
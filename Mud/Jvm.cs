@@ -1,5 +1,8 @@
+using System.Collections;
+using System.Collections.Concurrent;
 using System.Diagnostics.CodeAnalysis;
 using System.Reflection;
+using System.Runtime.CompilerServices;
 using System.Runtime.InteropServices;
 using System.Text.RegularExpressions;
 using Mud.Exceptions;
@@ -10,20 +13,341 @@ namespace Mud;
 public static class Jvm
 {
     internal static JvmInstance Instance { get; private set; }
-    internal static Dictionary<string, ClassInfo> ClassInfos { get; } = new();
-    internal static List<IntPtr> ObjPointers { get; } = new();
+    internal static ConcurrentDictionary<string, ClassInfo> ClassInfos { get; } = new();
+    /// <summary>
+    /// Registered class infos by their id, the id is the token held by the native class identity cache
+    /// </summary>
+    internal static ConcurrentDictionary<ulong, ClassInfo> ClassInfoIds { get; } = new();
+    /// <summary>
+    /// Loaders classes are resolved through when the system class loader does not have them, replaced on every change
+    /// so lookups read it without locking
+    /// </summary>
+    private static volatile JavaClassLoader[] _classLoaders = Array.Empty<JavaClassLoader>();
+    private static readonly object ClassLoaderLock = new();
+    /// <summary>
+    /// Loader of the jars added through AddClassPath on JVMs whose system class loader can not be extended
+    /// </summary>
+    private static JavaClassLoader? _classPathLoader;
     
     public static bool IsInitialized => Instance.Env != IntPtr.Zero;
 
+    [ThreadStatic]
+    private static IntPtr _threadEnv;
+
+    /// <summary>
+    /// Whether mud attached the current thread, threads adopted from an upcall belong to java and are never detached
+    /// </summary>
+    [ThreadStatic]
+    private static bool _attachedByMud;
+
+    /// <summary>
+    /// Whether threads that are automatically attached to the JVM are attached as daemon threads, which do not keep the JVM alive
+    /// </summary>
+    public static bool AttachAsDaemon { get; set; } = true;
+
+    /// <summary>
+    /// The JNI env of the current thread, attaches the thread to the JVM the first time it is used on the thread
+    /// </summary>
+    internal static IntPtr Env => _threadEnv != IntPtr.Zero ? _threadEnv : AttachThread(AttachAsDaemon);
+
+    /// <summary>
+    /// Attaches the current thread to the JVM, threads attached this way are detached automatically when they exit
+    /// </summary>
+    /// <param name="asDaemon">Whether the thread should be attached as a daemon thread</param>
+    /// <returns>The JNI env of the current thread</returns>
+    private static IntPtr AttachThread(bool asDaemon)
+    {
+        if (Instance.Jvm == IntPtr.Zero)
+        {
+            throw new JvmNotInitializedException();
+        }
+        _threadEnv = MudInterface.attach_thread(Instance.Jvm, asDaemon);
+        if (_threadEnv == IntPtr.Zero)
+        {
+            throw new JvmNotInitializedException("Unable to attach the current thread to the JVM");
+        }
+        _attachedByMud = true;
+        return _threadEnv;
+    }
+
+    /// <summary>
+    /// Adopts the env java handed to an upcall when the thread has not called into the JVM through mud yet,
+    /// the thread is owned by java so it is never detached by mud
+    /// </summary>
+    /// <param name="env">The JNI env of the calling java thread</param>
+    internal static void EnterUpcall(IntPtr env)
+    {
+        if (_threadEnv == IntPtr.Zero)
+        {
+            _threadEnv = env;
+        }
+    }
+
+    /// <summary>
+    /// Attaches the current thread to the JVM, only required to control the daemon status of the thread as
+    /// threads are otherwise attached automatically when first calling into the JVM
+    /// </summary>
+    /// <param name="asDaemon">Whether the thread should be attached as a daemon thread</param>
+    public static void AttachCurrentThread(bool asDaemon = true)
+    {
+        if (_threadEnv == IntPtr.Zero)
+        {
+            AttachThread(asDaemon);
+        }
+    }
+
+    /// <summary>
+    /// Detaches the current thread from the JVM, any java objects created on the thread that are not globally referenced are invalidated.
+    /// Only threads mud attached are detached, threads owned by java, e.g. ones that called into .NET through an upcall, stay attached
+    /// </summary>
+    public static void DetachCurrentThread()
+    {
+        EnsureInit();
+        if (!_attachedByMud)
+        {
+            return;
+        }
+        _attachedByMud = false;
+        // the native side also leaves threads alone that were already attached when mud asked for their env
+        if (MudInterface.detach_thread(Instance.Jvm))
+        {
+            _threadEnv = IntPtr.Zero;
+        }
+    }
+
+    private static JvmWorkerPool? _workerPool;
+    private static readonly object WorkerPoolLock = new();
+
+    /// <summary>
+    /// Pool of attached JVM threads the async calls run on, created with a worker per processor on first use
+    /// unless configured beforehand with ConfigureWorkerPool
+    /// </summary>
+    public static JvmWorkerPool WorkerPool
+    {
+        get
+        {
+            if (_workerPool != null)
+            {
+                return _workerPool;
+            }
+            lock (WorkerPoolLock)
+            {
+                return _workerPool ??= new JvmWorkerPool(Environment.ProcessorCount);
+            }
+        }
+    }
+
+    /// <summary>
+    /// Replaces the worker pool used by the async calls, the previous pool finishes its queued calls before its threads exit
+    /// </summary>
+    /// <param name="workers">Amount of worker threads</param>
+    /// <param name="capacity">Maximum amount of queued calls before callers have to wait</param>
+    public static void ConfigureWorkerPool(int workers, int capacity = 1024)
+    {
+        JvmWorkerPool? previous;
+        lock (WorkerPoolLock)
+        {
+            previous = _workerPool;
+            _workerPool = new JvmWorkerPool(workers, capacity);
+        }
+        previous?.Dispose();
+    }
+
+    /// <summary>
+    /// Amount of java objects currently held by .NET through the native handle table
+    /// </summary>
+    public static long LiveHandles => (long)MudInterface.handle_count();
+
+    /// <summary>
+    /// Meter the interop counters are published under, see JvmStats for what each counts
+    /// </summary>
+    public static System.Diagnostics.Metrics.Meter Meter => JvmMetrics.Meter;
+
+    /// <summary>
+    /// Takes a snapshot of the interop counters kept by the mud clib
+    /// </summary>
+    public static JvmStats Stats => JvmStats.Snapshot();
+
+    private static bool _statsTiming;
+
+    /// <summary>
+    /// Whether java method call latencies are recorded, off by default as it adds a clock read either side of every call
+    /// </summary>
+    public static bool StatsTiming
+    {
+        get => _statsTiming;
+        set
+        {
+            MudInterface.stats_set_timing(value);
+            _statsTiming = value;
+        }
+    }
+
+    /// <summary>
+    /// Amount of java classes registered in the native class identity cache used when mapping returned objects
+    /// </summary>
+    public static long CachedClasses => (long)MudInterface.class_cache_count();
+
+    /// <summary>
+    /// Holds a newly bound object, inside a JvmScope it is left as a local ref of the scope's frame,
+    /// otherwise it is promoted into the handle table
+    /// </summary>
+    /// <param name="obj">Object whose Jobj is a local ref</param>
+    internal static void Hold(IBoundObject obj)
+    {
+        if (JvmScope.Current is { } scope)
+        {
+            scope.Add(obj);
+            return;
+        }
+        Promote(obj);
+    }
+
+    /// <summary>
+    /// Promotes the bound object's local ref into a global ref held by the native handle table,
+    /// allowing it to outlive the current native frame and be used from any thread
+    /// </summary>
+    /// <param name="obj">Object whose Jobj is a local ref, is updated to the global ref</param>
+    internal static void Promote(IBoundObject obj)
+    {
+        if (!PendingReleases.IsEmpty)
+        {
+            ReleasePending();
+        }
+        var handle = MudInterface.handle_promote(Env, obj.Jobj);
+        obj.Jobj = handle.Obj;
+        obj.Handle = handle.Id;
+        if (ReleaseOnCollect && handle.Id != 0)
+        {
+            ReleaseWhenCollected(obj);
+        }
+    }
+
+    /// <summary>
+    /// Starts a scope on the current thread, every java object bound until it is disposed is released in one native call
+    /// when it is, unless promoted out of it with JvmScope.Promote
+    /// </summary>
+    /// <param name="capacity">Amount of objects expected to be bound in the scope</param>
+    /// <example><code>
+    /// IBoundObject kept;
+    /// using (var scope = Jvm.Scope())
+    /// {
+    ///     var builder = Jvm.GetClassInfo("java.lang.StringBuilder").Instance();
+    ///     builder.Call("append", "mud");
+    ///     kept = scope.Promote(builder.Call("reverse", new CustomType("java.lang.StringBuilder")));
+    /// }
+    /// </code></example>
+    public static JvmScope Scope(int capacity = 16)
+    {
+        EnsureInit();
+        return JvmScope.Push(capacity);
+    }
+
+    /// <summary>
+    /// Whether every object bound outside a JvmScope is released when it is garbage collected. Off by default as each
+    /// such object then goes through finalization, objects are otherwise released with Dispose, Release or a JvmScope
+    /// </summary>
+    public static bool ReleaseOnCollect { get; set; }
+
+    /// <summary>
+    /// Whether a java object returned again maps to the wrapper already bound to it rather than a new one, as long as
+    /// that wrapper is alive, not released and an instance of the requested type. Off by default as it costs an
+    /// identity lookup per returned object. Releasing a shared wrapper releases it for everything holding it
+    /// </summary>
+    public static bool PreserveIdentity { get; set; }
+
+    /// <summary>
+    /// Amount of java objects mapped to their wrapper while PreserveIdentity is on
+    /// </summary>
+    public static long MappedIdentities => IdentityMap.Count;
+
+    /// <summary>
+    /// Handles whose objects were collected, released on the next promotion rather than from the finalizer thread
+    /// </summary>
+    private static readonly ConcurrentQueue<ulong> PendingReleases = new();
+
+    private static readonly ConditionalWeakTable<IBoundObject, CollectedHandle> CollectedHandles = new();
+
+    /// <summary>
+    /// Releases the object's java object once the object is garbage collected, unless it was released already.
+    /// Registering an object again keeps its first registration, replacing it would queue the live handle from the
+    /// finalizer of the replaced entry
+    /// </summary>
+    /// <param name="obj">Object bound outside a JvmScope or promoted out of one</param>
+    /// <exception cref="InvalidOperationException">Throws if the object is only a local ref of a JvmScope</exception>
+    public static void ReleaseWhenCollected(IBoundObject obj)
+    {
+        if (obj.Handle == 0)
+        {
+            throw new InvalidOperationException("Only objects held by the handle table can be released when collected");
+        }
+        if (CollectedHandles.TryGetValue(obj, out _))
+        {
+            return;
+        }
+        var collected = new CollectedHandle(obj.Handle);
+        if (!CollectedHandles.TryAdd(obj, collected))
+        {
+            // lost a race with another registration, the unused entry must not queue the handle
+            GC.SuppressFinalize(collected);
+        }
+    }
+
+    private static void ReleasePending()
+    {
+        var env = Env;
+        while (PendingReleases.TryDequeue(out var handle))
+        {
+            // handles released explicitly in the meantime are stale and rejected by the table
+            MudInterface.handle_release(env, handle);
+        }
+    }
+
+    /// <summary>
+    /// Lives as long as the object it was attached to, queues the object's handle to be released once both are collected
+    /// </summary>
+    private sealed class CollectedHandle
+    {
+        private readonly ulong _handle;
+
+        internal CollectedHandle(ulong handle) => _handle = handle;
+
+        ~CollectedHandle() => PendingReleases.Enqueue(_handle);
+    }
+
+    /// <summary>
+    /// Releases the global ref held by the provided handle
+    /// </summary>
+    /// <param name="handle">The handle id</param>
+    /// <returns>False if the handle had already been released</returns>
+    internal static bool ReleaseHandle(ulong handle)
+    {
+        EnsureInit();
+        return MudInterface.handle_release(Env, handle);
+    }
+
     /// <summary>
     /// Load the JVM with the provided arguments and will append rt.jar to the class path if it is not provided
     /// </summary>
     /// <param name="javaHome">Java installation directory</param>
     /// <param name="args">Desired JVM arguments</param>
     /// <exception cref="JavaLocateException">Will throw if the provided JAVA_HOME directory does not exist</exception>
-    public static void Initialize(DirectoryInfo javaHome, params string[] args)
+    public static void Initialize(DirectoryInfo javaHome, params string[] args) =>
+        Initialize(javaHome, new JvmStartupOptions(), args);
+
+    /// <summary>
+    /// Load the JVM with the provided startup options and arguments, then resolve the options' preload manifest.
+    /// Arguments given explicitly take precedence over the ones generated from the options
+    /// </summary>
+    /// <param name="javaHome">Java installation directory</param>
+    /// <param name="startup">Class data sharing and preloading options</param>
+    /// <param name="args">Desired JVM arguments</param>
+    /// <exception cref="JavaLocateException">Will throw if the provided JAVA_HOME directory does not exist</exception>
+    /// <exception cref="JvmNotInitializedException">Will throw if the JVM rejects the arguments, e.g. with -Xshare:on
+    /// and an archive that cannot be mapped</exception>
+    public static void Initialize(DirectoryInfo javaHome, JvmStartupOptions startup, params string[] args)
     {
-        args = args.Where(a => !string.IsNullOrWhiteSpace(a)).ToArray();
+        args = startup.JvmArgs().Concat(args).Where(a => !string.IsNullOrWhiteSpace(a)).ToArray();
         if (!javaHome.Exists)
         {
             throw new JavaLocateException($"Path ({javaHome}) provided by JAVA_HOME environment does not exist");
@@ -52,6 +376,16 @@ public static class Jvm
         var options = MudInterface.gen_options_arr(args.Length, args);
         Instance = MudInterface.create_instance(options, args.Length);
         MudInterface.interop_free(options);
+        if (Instance.Jvm == IntPtr.Zero)
+        {
+            throw new JvmNotInitializedException("The JVM could not be created with the provided arguments");
+        }
+        // instruments are registered up front so listeners see them before the first collection
+        _ = JvmMetrics.Meter;
+        if (startup.Preload != null)
+        {
+            Preload(startup.Preload, startup.PreloadParallelism);
+        }
     }
     
     /// <summary>
@@ -71,64 +405,312 @@ public static class Jvm
     }
 
     /// <summary>
-    /// Makes sure the JVM has been inizialized 
+    /// Will locate java home via environment variable JAVA_HOME and forward the call to
+    /// Initialize(DirectoryInfo, JvmStartupOptions, params string[] args)
+    /// </summary>
+    /// <param name="startup">Class data sharing and preloading options</param>
+    /// <param name="args">Desired JVM arguments</param>
+    /// <exception cref="JavaLocateException">Will throw the environment variable JAVA_HOME is not set</exception>
+    public static void Initialize(JvmStartupOptions startup, params string[] args)
+    {
+        var javaHome = Environment.GetEnvironmentVariable("JAVA_HOME");
+        if (string.IsNullOrWhiteSpace(javaHome))
+        {
+            throw new JavaLocateException("JAVA_HOME environment variable not set");
+        }
+
+        Initialize(new DirectoryInfo(javaHome), startup, args);
+    }
+
+    /// <summary>
+    /// Resolves the classes, members and bound interfaces of the manifest in parallel so their first calls skip the lookups.
+    /// Entries that no longer resolve, e.g. after the java side changed, are skipped
+    /// </summary>
+    /// <param name="manifest">Manifest recorded with PreloadManifest.Record</param>
+    /// <param name="parallelism">Number of threads resolving the manifest, defaults to the processor count</param>
+    /// <returns>The number of entries that could not be resolved</returns>
+    public static int Preload(PreloadManifest manifest, int? parallelism = null)
+    {
+        EnsureInit();
+        var failed = 0;
+        var parallel = new ParallelOptions { MaxDegreeOfParallelism = parallelism ?? Environment.ProcessorCount };
+        Parallel.ForEach(manifest.Classes, parallel, preload =>
+        {
+            if (!TryGetClassInfo(preload.ClassPath, out var classInfo))
+            {
+                Interlocked.Increment(ref failed);
+                return;
+            }
+            foreach (var method in preload.Methods)
+            {
+                if (!TryResolve(() => classInfo.GetMethodPtr(method.Name, method.Signature, method.IsStatic)))
+                {
+                    Interlocked.Increment(ref failed);
+                }
+            }
+            foreach (var field in preload.Fields)
+            {
+                if (!TryResolve(() => classInfo.GetFieldPtr(field.Name, field.Signature, field.IsStatic)))
+                {
+                    Interlocked.Increment(ref failed);
+                }
+            }
+        });
+        // generated types are built one at a time under the TypeGen lock, so they gain nothing from the pool
+        foreach (var name in manifest.BoundInterfaces)
+        {
+            var type = Type.GetType(name);
+            if (type == null || !BoundTypes.IsGenerated(type) && !TryResolve(() => TypeGen.Build(type)))
+            {
+                failed++;
+            }
+        }
+        return failed;
+
+        static bool TryResolve(Func<object> resolve)
+        {
+            try
+            {
+                resolve();
+                return true;
+            }
+            catch (Exception e) when (e is MemberNotFoundException or InvalidBoundObjectException)
+            {
+                return false;
+            }
+        }
+    }
+
+    /// <summary>
+    /// Amount of critical array pins held by the current thread, no JVM calls may be made while any are held
+    /// </summary>
+    [ThreadStatic]
+    internal static int CriticalPins;
+
+    /// <summary>
+    /// Makes sure the JVM has been inizialized and that the current thread is able to call into it
     /// </summary>
     /// <exception cref="JvmNotInitializedException"></exception>
+    /// <exception cref="ArrayPinException">Will throw if the current thread holds a critical array pin</exception>
     internal static void EnsureInit()
     {
         if (Instance.Jvm == IntPtr.Zero)
         {
             throw new JvmNotInitializedException();
         }
+
+        if (CriticalPins != 0)
+        {
+            throw new ArrayPinException("Attempt to call into the JVM while a critical array pin is held by the thread");
+        }
     }
 
-    public static bool TryGetClassInfo(string classPath, [NotNullWhen(true)] out ClassInfo? classInfo)
+    public static bool TryGetClassInfo(string classPath, [NotNullWhen(true)] out ClassInfo? classInfo)
+    {
+        EnsureInit();
+        classPath = classPath.Replace(".", "/");
+        if (!ClassInfos.TryGetValue(classPath, out classInfo))
+        {
+            var localCls = MudInterface.get_class(Env, classPath);
+
+            if (localCls == IntPtr.Zero)
+            {
+                // a NoClassDefFoundError is left pending when the class is not found
+                MudInterface.release_obj(Env, MudInterface.check_exception(Env));
+                localCls = LoadFromClassLoaders(classPath);
+            }
+            if (localCls == IntPtr.Zero)
+            {
+                classInfo = null;
+                return false;
+            }
+            
+            // classes are shared across threads so they must be held as global refs
+            var cls = MudInterface.new_global_ref(Env, localCls);
+            MudInterface.release_obj(Env, localCls);
+            // Console.WriteLine($"GetClass `{classPath}`::{cls.HexAddress()}");
+            classInfo = new ClassInfo(cls, classPath);
+            if (!ClassInfos.TryAdd(classPath, classInfo))
+            {
+                MudInterface.release_global_ref(Env, cls);
+                classInfo = ClassInfos[classPath];
+            }
+            else
+            {
+                ClassInfoIds[classInfo.Id] = classInfo;
+            }
+        }
+        return true;
+    }
+
+    /// <summary>
+    /// Loads the class through the added class loaders, in the order they were added
+    /// </summary>
+    /// <returns>The local ref of the class, zero when none of them has it</returns>
+    private static IntPtr LoadFromClassLoaders(string classPath)
+    {
+        foreach (var loader in _classLoaders)
+        {
+            IntPtr localCls;
+            try
+            {
+                localCls = loader.LoadClass(classPath);
+            }
+            catch (ObjectDisposedException)
+            {
+                // disposed after the loaders were read
+                continue;
+            }
+            if (localCls != IntPtr.Zero)
+            {
+                return localCls;
+            }
+        }
+        return IntPtr.Zero;
+    }
+
+    /// <summary>
+    /// Holds the class as a global ref and registers its ClassInfo, reusing the one already registered under the class
+    /// path when it is the same class
+    /// </summary>
+    /// <param name="cls">The class, the caller keeps owning the ref</param>
+    /// <param name="classPath">The java class path with slashes</param>
+    internal static ClassInfo ClassInfoOf(IntPtr cls, string classPath)
+    {
+        if (ClassInfos.TryGetValue(classPath, out var named) && MudInterface.is_same_object(Env, named.Cls, cls))
+        {
+            return named;
+        }
+        var classInfo = new ClassInfo(MudInterface.new_global_ref(Env, cls), classPath);
+        ClassInfoIds[classInfo.Id] = classInfo;
+        return classInfo;
+    }
+
+    /// <summary>
+    /// Makes GetClassInfo/TryGetClassInfo fall back to the loader for classes the system class loader does not have,
+    /// loaders are asked in the order they were added
+    /// </summary>
+    /// <param name="loader">The loader, removed again when it is disposed</param>
+    public static void AddClassLoader(JavaClassLoader loader)
+    {
+        lock (ClassLoaderLock)
+        {
+            if (!_classLoaders.Contains(loader))
+            {
+                _classLoaders = _classLoaders.Append(loader).ToArray();
+            }
+        }
+    }
+
+    /// <summary>
+    /// Stops resolving classes through the loader, classes already resolved through it stay registered
+    /// </summary>
+    /// <param name="loader">The loader</param>
+    public static void RemoveClassLoader(JavaClassLoader loader)
+    {
+        lock (ClassLoaderLock)
+        {
+            _classLoaders = _classLoaders.Where(l => l != loader).ToArray();
+        }
+    }
+
+    public static ClassInfo GetClassInfo<T>() => GetClassInfo(typeof(T));
+
+    /// <exception cref="Mud.Exceptions.ClassNotFoundException"></exception>
+    public static ClassInfo GetClassInfo(Type type)
+    {
+        var classPath = type.GetCustomAttributes<ClassPathAttribute>().FirstOrDefault()?.ClassPath;
+        return GetClassInfo(classPath ?? type.FullName!.Split('`')[0]);
+    }
+    
+    /// <exception cref="Mud.Exceptions.ClassNotFoundException"></exception>
+    public static ClassInfo GetClassInfo(string classPath)
+    {
+        if (TryGetClassInfo(classPath, out var cls))
+        {
+            return cls;
+        }
+
+        throw new ClassNotFoundException(classPath);
+    }
+
+    /// <summary>
+    /// Creates a new String in the JVM straight from the string's UTF-16 chars
+    /// </summary>
+    /// <param name="str">String to be allocated</param>
+    /// <returns>The java string pointer</returns>
+    internal static unsafe IntPtr JavaString(string str)
+    {
+        fixed (char* chars = str)
+        {
+            return MudInterface.string_new_utf16(Env, chars, str.Length);
+        }
+    }
+
+    private static readonly ConcurrentDictionary<string, IntPtr> ConstantStrings = new();
+
+    /// <summary>
+    /// Whether any constant strings were added, checked before the cache is searched so calls skip the lookup by default
+    /// </summary>
+    internal static volatile bool HasConstantStrings;
+
+    /// <summary>
+    /// Adds strings that are passed repeatedly, such as literals and constants, to the constant string cache. Passing a
+    /// string equal to one of these as an argument reuses a global ref instead of allocating a new java string per call
+    /// </summary>
+    /// <param name="strs">Strings to be cached</param>
+    public static void AddConstantStrings(params string[] strs)
     {
         EnsureInit();
-        classPath = classPath.Replace(".", "/");
-        if (!ClassInfos.TryGetValue(classPath, out classInfo))
+        foreach (var str in strs)
         {
-            var cls = MudInterface.get_class(Instance.Env, classPath);
-
-            if (cls == IntPtr.Zero)
+            if (ConstantStrings.ContainsKey(str))
             {
-                classInfo = null;
-                return false;
+                continue;
+            }
+            var local = JavaString(str);
+            var global = MudInterface.new_global_ref(Env, local);
+            MudInterface.release_obj(Env, local);
+            if (!ConstantStrings.TryAdd(str, global))
+            {
+                MudInterface.release_global_ref(Env, global);
             }
-            
-            ObjPointers.Add(cls);
-            // Console.WriteLine($"GetClass `{classPath}`::{cls.HexAddress()}");
-            classInfo = new ClassInfo(cls, classPath);
-            ClassInfos[classPath] = classInfo;
         }
-        return true;
+        HasConstantStrings = !ConstantStrings.IsEmpty;
     }
 
-    public static ClassInfo GetClassInfo<T>()
-    {
-        var classPath = typeof(T).GetCustomAttributes<ClassPathAttribute>().FirstOrDefault()?.ClassPath;
-        return GetClassInfo(classPath ?? typeof(T).FullName!.Split('`')[0]);
-    }
-    
-    /// <exception cref="Mud.Exceptions.ClassNotFoundException"></exception>
-    public static ClassInfo GetClassInfo(string classPath)
+    /// <summary>
+    /// Gets the java string for an argument, reusing the one of the constant string cache when the string was added to it
+    /// </summary>
+    /// <param name="str">String to be passed</param>
+    /// <param name="owned">Whether the returned string belongs to the caller and must be released</param>
+    /// <returns>The java string pointer</returns>
+    internal static IntPtr JavaArgString(string str, out bool owned)
     {
-        if (TryGetClassInfo(classPath, out var cls))
+        if (HasConstantStrings && ConstantStrings.TryGetValue(str, out var cached))
         {
-            return cls;
+            owned = false;
+            return cached;
         }
 
-        throw new ClassNotFoundException(classPath);
+        owned = true;
+        return JavaString(str);
     }
 
     /// <summary>
-    /// Creates a new String in the JVM
+    /// Releases all of the java strings held by the constant string cache. Calls pass the cached strings without holding
+    /// refs of their own, so this must only be called while no calls are in flight on any thread
     /// </summary>
-    /// <param name="str">String to be allocated</param>
-    /// <returns>A JavaString struct containing the pointer to the java string as well as the malloc C string </returns>
-    internal static IntPtr JavaString(string str)
+    public static void ClearConstantStrings()
     {
-        return MudInterface.string_new(Instance.Env, str);
+        HasConstantStrings = false;
+        foreach (var str in ConstantStrings.Keys)
+        {
+            if (ConstantStrings.TryRemove(str, out var global))
+            {
+                MudInterface.release_global_ref(Env, global);
+            }
+        }
     }
 
     internal static string ExtractStr(IBoundObject jString, bool releaseStrObj = false)
@@ -142,59 +724,50 @@ public static class Jvm
     /// <param name="jString">The java string pointer</param>
     /// <param name="releaseStrObj">Should the Java string be released as well</param>
     /// <returns></returns>
-    internal static string ExtractStr(IntPtr jString, bool releaseStrObj = false)
+    internal static unsafe string ExtractStr(IntPtr jString, bool releaseStrObj = false)
     {
-        [DllImport("libMud", CharSet = CharSet.Ansi, EntryPoint = "mud_jstring_to_string")]
-        static extern IntPtr jstring_to_string(IntPtr env, IntPtr jStr);
-        
-        var mallocStr = jstring_to_string(Instance.Env, jString);
-        var str = Marshal.PtrToStringAnsi(mallocStr)!;
-        MudInterface.interop_free(mallocStr);
+        // UTF-16 chars are copied straight into .NET owned memory, short strings only need the one native call
+        const int bufLength = 256;
+        var buf = stackalloc char[bufLength];
+        var len = MudInterface.string_copy_utf16(Env, jString, buf, bufLength);
+        var str = len <= bufLength
+            ? new string(buf, 0, len)
+            : string.Create(len, jString, (chars, s) =>
+            {
+                fixed (char* ptr = chars)
+                {
+                    MudInterface.string_copy_utf16(Env, s, ptr, chars.Length);
+                }
+            });
         if (releaseStrObj)
         {
-            MudInterface.release_obj(Instance.Env, jString);
+            MudInterface.release_obj(Env, jString);
         }
 
         return str;
     }
 
-    private static IntPtr ExceptionCls { get; set; }
-    private static IntPtr GetExceptionCauseMethod { get; set; }
-    private static IntPtr GetExceptionStackMethod { get; set; }
-    private static IntPtr ExceptionToStringMethod { get; set; }
-    private static IntPtr FrameCls { get; set; }
-    private static IntPtr FrameToStringMethod { get; set; }
-
     /// <summary>
-    /// Gets the exception message and stack trace from the provided exception obj pointer
+    /// Holds the provided java exception object and throws it as a JavaException, does nothing if the pointer is null.
+    /// Only the exception's class is resolved here, its message and stack trace are read when they are accessed
     /// </summary>
     /// <param name="ex">The exception object pointer</param>
-    /// <returns>Message and stack</returns>
-    private static string GetException(IntPtr ex)
+    /// <exception cref="JavaException">Will throw if the exception pointer is set</exception>
+    internal static void ThrowException(IntPtr ex)
     {
-        if (ExceptionCls == IntPtr.Zero)
+        if (ex == IntPtr.Zero)
         {
-            ExceptionCls = MudInterface.get_class(Instance.Env, "java/lang/Throwable");
-            FrameCls = MudInterface.get_class(Instance.Env, "java/lang/StackTraceElement");
-
-            GetExceptionCauseMethod =
-                MudInterface.get_method(Instance.Env, ExceptionCls, "getCause", "()Ljava/lang/Throwable;");
-
-            GetExceptionStackMethod = MudInterface.get_method(Instance.Env, ExceptionCls, "getStackTrace",
-                "()[Ljava/lang/StackTraceElement;");
-
-            ExceptionToStringMethod =
-                MudInterface.get_method(Instance.Env, ExceptionCls, "toString", "()Ljava/lang/String;");
-
-            FrameToStringMethod = MudInterface.get_method(Instance.Env, FrameCls, "toString", "()Ljava/lang/String;");
+            return;
         }
-
-        var mallocStr = MudInterface.get_exception_msg(Instance.Env, ex, GetExceptionCauseMethod,
-            GetExceptionStackMethod, ExceptionToStringMethod,
-            FrameToStringMethod, true);
-        var str = Marshal.PtrToStringAnsi(mallocStr)!;
-        MudInterface.interop_free(mallocStr);
-        return str;
+        // the exception carries the throwable past any scope it was raised in
+        using var unscoped = JvmScope.Suspend();
+        var throwable = (IBoundObject)TypeMap.MapJValue(JavaType.Object, typeof(BoundObject), new JavaVal { Object = ex });
+        // promoting it already registered it when every object is released on collect
+        if (!ReleaseOnCollect)
+        {
+            ReleaseWhenCollected(throwable);
+        }
+        throw new JavaException(throwable);
     }
 
     internal static T UsingArgs<T>(TypedArg[] args, Func<JavaVal[], JavaCallResp> action)
@@ -217,16 +790,7 @@ public static class Jvm
 
         if (resp.IsException)
         {
-            var exceptionMsg = GetException(resp.Value.Object);
-            ObjPointers.Remove(resp.Value.Object);
-            MudInterface.release_obj(Instance.Env, resp.Value.Object);
-            var firstLine = exceptionMsg.IndexOf('\n');
-            Console.WriteLine(exceptionMsg);
-            if (firstLine == -1)
-            {
-                throw new JavaException(exceptionMsg, "");
-            }
-            throw new JavaException(exceptionMsg[..firstLine], exceptionMsg[(firstLine + 1)..]);
+            ThrowException(resp.Value.Object);
         }
 
         return TypeMap.MapJValue(returnType, resp.Value);
@@ -243,57 +807,238 @@ public static class Jvm
         var pointers = new List<IntPtr>();
         for (var i = 0; i < args.Length; i++)
         {
-            var a = args[i].Val;
-            if (a == null)
+            mapped[i] = MapArg(args[i], pointers);
+        }
+        return (mapped, pointers);
+    }
+
+    /// <summary>
+    /// Loops through the provided argument values and maps them to matching JavaVal, allocates required backing objects for strings and arrays
+    /// </summary>
+    /// <param name="args">Arg values to be mapped</param>
+    /// <returns>A tuple of the mapped args and any allocated pointers that must be freed</returns>
+    private static (JavaVal[] Args, List <IntPtr> Pointers) MapArgs(object?[] args)
+    {
+        var mapped = new JavaVal[args.Length];
+        var pointers = new List<IntPtr>();
+        for (var i = 0; i < args.Length; i++)
+        {
+            mapped[i] = MapArg(args[i], pointers);
+        }
+        return (mapped, pointers);
+    }
+
+    /// <summary>
+    /// Maps the provided argument value to its matching JavaVal, allocates required backing objects for strings and arrays
+    /// </summary>
+    /// <param name="a">Arg value to be mapped</param>
+    /// <param name="pointers">Any allocated pointers that must be freed are added to this</param>
+    /// <returns>The mapped arg</returns>
+    internal static JavaVal MapArg(object? a, List<IntPtr> pointers)
+    {
+        if (a is TypedArg typedArg)
+        {
+            a = typedArg.Val;
+            // a primitive passed for a boxing class, e.g. an int? for a java.lang.Integer parameter, is boxed natively
+            if (a != null && a is not IBoundObject && TypeMap.TryGetBoxedPrimitive(typedArg.Type, out var boxedType))
             {
-                mapped[i] = new()
+                var boxed = BoxedPrimitives.Box(a, boxedType);
+                pointers.Add(boxed);
+                return new()
                 {
-                    Object = IntPtr.Zero
+                    Object = boxed
                 };
-                continue;
             }
-            if (a is string str)
+            // any list of primitives passed for a java.util.List, e.g. a double[] as an IList<double>, is boxed natively
+            if (a != null && typedArg.Type.ClassPath == "java/util/List" &&
+                TypeMap.TryGetImplementedPrimitiveList(a.GetType(), out var elemType, out var elemPrimType))
             {
-                var strResp = JavaString(str);
-                pointers.Add(strResp);
-                mapped[i] = new()
+                var boxedList = BoxedPrimitives.BoxList((IEnumerable)a, elemType, elemPrimType);
+                pointers.Add(boxedList);
+                return new()
                 {
-                    Object = strResp
+                    Object = boxedList
                 };
-                continue;
             }
-            if (a.GetType().IsArray)
+        }
+        if (a == null)
+        {
+            return new()
             {
-                var type = TypeMap.MapToType(a.GetType().GetElementType()!, null);
-                ClassInfo? arrCls = null;
-                if (type.ClassPath != null)
-                {
-                    arrCls = GetClassInfo(type.ClassPath);
-                }
-
-                var arrObjItems = new TypedArg[((Array)a).Length];
-                var j = 0;
-                foreach (var arrItem in (Array) a)
-                {
-                    arrObjItems[j++] = arrItem as TypedArg ?? new(arrItem);
-                }
-
-                var arrayPointers = MapArgs(arrObjItems);
-                pointers.AddRange(arrayPointers.Pointers);
-                
-                mapped[i] = new()
-                {
-                    Object = MudInterface.array_new(Instance.Env, arrObjItems.Length, arrayPointers.Args, type.Type, arrCls?.Cls ?? IntPtr.Zero)
-                };
-                continue;
+                Object = IntPtr.Zero
+            };
+        }
+        if (a is string str)
+        {
+            var strResp = JavaArgString(str, out var owned);
+            if (owned)
+            {
+                pointers.Add(strResp);
             }
-            mapped[i] = JavaVal.MapFrom(a);
+            return new()
+            {
+                Object = strResp
+            };
+        }
+        if (a.GetType().IsSZArray && TypeMap.TryGetBlittablePrimitive(a.GetType().GetElementType()!, out var primType))
+        {
+            var primArr = NewPrimitiveArray((Array)a, primType);
+            pointers.Add(primArr);
+            return new()
+            {
+                Object = primArr
+            };
+        }
+        if (NestedArrays.IsJagged(a.GetType(), out _, out primType))
+        {
+            var jagged = NestedArrays.NewJagged((Array)a, primType);
+            pointers.Add(jagged);
+            return new()
+            {
+                Object = jagged
+            };
+        }
+        if (NestedArrays.IsShaped(a.GetType(), out primType))
+        {
+            var shaped = NestedArrays.NewShaped((Array)a, primType);
+            pointers.Add(shaped);
+            return new()
+            {
+                Object = shaped
+            };
+        }
+        if (TypeMap.TryGetImplementedPrimitiveList(a.GetType(), out var listElemType, out primType))
+        {
+            var list = BoxedPrimitives.BoxList((IEnumerable)a, listElemType, primType);
+            pointers.Add(list);
+            return new()
+            {
+                Object = list
+            };
         }
+        if (a.GetType().IsArray)
+        {
+            var type = TypeMap.MapToType(a.GetType().GetElementType()!, null);
+            ClassInfo? arrCls = null;
+            if (type.ClassPath != null)
+            {
+                arrCls = GetClassInfo(type.ClassPath);
+            }
 
+            var arrItems = new JavaVal[((Array)a).Length];
+            var j = 0;
+            foreach (var arrItem in (Array) a)
+            {
+                arrItems[j++] = MapArg(arrItem, pointers);
+            }
 
-        return (mapped, pointers);
+            var arr = MudInterface.array_new(Env, arrItems.Length, arrItems, type.Type, arrCls?.Cls ?? IntPtr.Zero);
+            pointers.Add(arr);
+            return new()
+            {
+                Object = arr
+            };
+        }
+        return JavaVal.MapFrom(a);
     }
     
+    /// <summary>
+    /// Creates a java primitive array from the provided .NET array in a single native call
+    /// </summary>
+    /// <param name="values">Array whose element type shares the java primitive's memory layout</param>
+    /// <param name="type">The java primitive type of the elements</param>
+    /// <returns>The java array pointer</returns>
+    internal static IntPtr NewPrimitiveArray(Array values, JavaType type)
+    {
+        return MudInterface.array_new_primitive(Env, (nuint)values.Length,
+            ref MemoryMarshal.GetArrayDataReference(values), type);
+    }
+
+    /// <summary>
+    /// Creates a java primitive array from the provided values in a single native call
+    /// </summary>
+    /// <param name="values">Values to copy into the new java array</param>
+    /// <typeparam name="T">Element type, must share the memory layout of a java primitive</typeparam>
+    /// <returns>The java array pointer</returns>
+    internal static IntPtr NewPrimitiveArray<T>(ReadOnlySpan<T> values) where T : unmanaged
+    {
+        return MudInterface.array_new_primitive(Env, (nuint)values.Length,
+            ref MemoryMarshal.GetReference(MemoryMarshal.AsBytes(values)), TypeMap.GetBlittablePrimitive(typeof(T)));
+    }
+
+    /// <summary>
+    /// Creates a new java primitive array containing the provided values
+    /// </summary>
+    /// <param name="values">Values to copy into the new java array</param>
+    /// <typeparam name="T">Element type, must share the memory layout of a java primitive</typeparam>
+    /// <returns>A bound object of the java array</returns>
+    public static IBoundObject NewArray<T>(ReadOnlySpan<T> values) where T : unmanaged
+    {
+        EnsureInit();
+        var arrPtr = NewPrimitiveArray(values);
+        var obj = NewUnboundObj(typeof(BoundObject));
+        obj.Info = GetClassInfo(new CustomType(TypeMap.MapToType(typeof(T), null)).TypeSignature);
+        obj.Env = Env;
+        obj.Jobj = arrPtr;
+        Hold(obj);
+        return obj;
+    }
+
+    /// <summary>
+    /// Creates a new nested java primitive array, e.g. a double[][] for a shape of two dimensions, in a single native call
+    /// </summary>
+    /// <param name="values">Values of the innermost arrays back to back, in row major order</param>
+    /// <param name="shape">Length of each dimension, the outermost first</param>
+    /// <typeparam name="T">Element type, must share the memory layout of a java primitive</typeparam>
+    /// <returns>A bound object of the java array</returns>
+    /// <exception cref="ArgumentException">Throws if the shape does not match the amount of values</exception>
+    public static IBoundObject NewArray<T>(ReadOnlySpan<T> values, ReadOnlySpan<int> shape) where T : unmanaged
+    {
+        EnsureInit();
+        // the class is resolved first so a failed lookup can't leak the native array
+        var type = TypeMap.MapToType(typeof(T), null);
+        for (var i = 0; i < shape.Length; i++)
+        {
+            type = new CustomType(type);
+        }
+        var obj = NewUnboundObj(typeof(BoundObject));
+        obj.Info = GetClassInfo(type.TypeSignature);
+        obj.Env = Env;
+        obj.Jobj = NestedArrays.NewShaped(values, shape);
+        Hold(obj);
+        return obj;
+    }
+
+    /// <summary>
+    /// Copies a region of a java primitive array into the provided buffer in a single native call
+    /// </summary>
+    /// <param name="arr">The java array pointer</param>
+    /// <param name="type">The java primitive type of the elements</param>
+    /// <param name="start">Index of the first element to copy</param>
+    /// <param name="length">Amount of elements to copy</param>
+    /// <param name="dest">Start of the buffer to copy into</param>
+    /// <exception cref="JavaException">Will throw if the region is out of the arrays bounds</exception>
+    internal static void ReadPrimitiveArray(IntPtr arr, JavaType type, int start, int length, ref byte dest)
+    {
+        EnsureInit();
+        ThrowException(MudInterface.array_get_region(Env, arr, (nuint)start, (nuint)length, ref dest, type));
+    }
+
+    /// <summary>
+    /// Copies the provided values into a region of a java primitive array in a single native call
+    /// </summary>
+    /// <param name="arr">The java array pointer</param>
+    /// <param name="type">The java primitive type of the elements</param>
+    /// <param name="start">Index of the first element to overwrite</param>
+    /// <param name="length">Amount of elements to copy</param>
+    /// <param name="values">Start of the buffer to copy from</param>
+    /// <exception cref="JavaException">Will throw if the region is out of the arrays bounds</exception>
+    internal static void WritePrimitiveArray(IntPtr arr, JavaType type, int start, int length, ref byte values)
+    {
+        EnsureInit();
+        ThrowException(MudInterface.array_set_region(Env, arr, (nuint)start, (nuint)length, ref values, type));
+    }
+
     /// <summary>
     /// Maps the args provided into respective JavaVal union, then call the action with mapped values.
     /// Will automatically allocate/deallocate strings & arrays
@@ -303,28 +1048,83 @@ public static class Jvm
     internal static void UsingArgs(TypedArg[] args, Action<JavaVal[]> action)
     {
         EnsureInit();
-        var (jArgs, pointers) = MapArgs(args);
+        UsingMappedArgs(MapArgs(args), action);
+    }
+
+    /// <summary>
+    /// Maps the arg values provided into respective JavaVal union, then call the action with mapped values.
+    /// Will automatically allocate/deallocate strings & arrays
+    /// </summary>
+    /// <param name="args">Arg values to be mapped</param>
+    /// <param name="action">Action to run with mapped args</param>
+    internal static void UsingArgs(object?[] args, Action<JavaVal[]> action)
+    {
+        EnsureInit();
+        UsingMappedArgs(MapArgs(args), action);
+    }
+
+    /// <summary>
+    /// Maps the arg values provided into respective JavaVal union, then call the action with mapped values
+    /// </summary>
+    /// <param name="returnType">Java type of the returned value</param>
+    /// <param name="returnClrType">The .NET type the returned value is to be mapped to</param>
+    /// <param name="args">Args to be mapped against their declared java types</param>
+    /// <param name="action">Action to be run with mapped args that returns a value</param>
+    /// <returns>The mapped return value</returns>
+    /// <exception cref="JavaException">Will throw if there is an exception in the JVM</exception>
+    internal static object UsingArgs(JavaType returnType, Type returnClrType, TypedArg[] args, Func<JavaVal[], JavaCallResp> action)
+    {
+        JavaCallResp resp = new();
+        UsingArgs(args, jArgs => { resp = action(jArgs); });
+
+        if (resp.IsException)
+        {
+            ThrowException(resp.Value.Object);
+        }
+
+        return TypeMap.MapJValue(returnType, returnClrType, resp.Value);
+    }
 
+    private static void UsingMappedArgs((JavaVal[] Args, List<IntPtr> Pointers) mapped, Action<JavaVal[]> action)
+    {
+        var (jArgs, pointers) = mapped;
         try
         {
             action(jArgs);
         }
         finally
         {
-            foreach (var ptr in pointers)
+            ReleaseArgs(pointers);
+        }
+    }
+
+    /// <summary>
+    /// Releases the objects MapArg allocated for the arguments
+    /// </summary>
+    internal static void ReleaseArgs(List<IntPtr>? pointers)
+    {
+        if (pointers == null)
+        {
+            return;
+        }
+        foreach (var ptr in pointers)
+        {
+            try
             {
-                try
-                {
-                    MudInterface.release_obj(Instance.Env, ptr);
-                }
-                catch
-                {
-                    // ignored
-                }
+                MudInterface.release_obj(Env, ptr);
+            }
+            catch
+            {
+                // ignored
             }
         }
     }
 
+    /// <summary>
+    /// Adds the jar to the system class loader. Since Java 9 the system class loader can not be extended, the jar is
+    /// then memory mapped into a JavaClassLoader shared by every jar added here, which GetClassInfo resolves through
+    /// </summary>
+    /// <param name="path">Path or file url of the jar</param>
     public static void AddClassPath(string path)
     {
         if (string.IsNullOrWhiteSpace(path)) return;
@@ -337,7 +1137,19 @@ public static class Jvm
             path = $"{filePrefix}{Path.GetFullPath(path)}";
         }
         
-        MudInterface.add_class_path(Instance.Env, path);
+        if (MudInterface.add_class_path(Env, path))
+        {
+            return;
+        }
+        lock (ClassLoaderLock)
+        {
+            if (_classPathLoader == null)
+            {
+                _classPathLoader = JavaClassLoader.Create();
+                AddClassLoader(_classPathLoader);
+            }
+            _classPathLoader.AddJar(new Uri(path).LocalPath);
+        }
     }
 
     /// <summary>
@@ -347,12 +1159,28 @@ public static class Jvm
     /// <returns></returns>
     internal static ClassInfo GetObjClass(IntPtr obj)
     {
-        var classInfo = GetClassInfo("java/lang/Class");
-        // var getNameMethod = classInfo.GetMethodPtrBySig("getName", "()Ljava/lang/String;", false);
-        var cls = MudInterface.get_class_of_obj(Instance.Env, obj);
-        ObjPointers.Add(cls);
-        var classPath = classInfo.Call<string>(cls, "getName", new TypedArg[]{}, false);
-        return GetClassInfo(classPath);
+        var id = MudInterface.class_cache_get(Env, obj, out var cls);
+        if (id != 0 && ClassInfoIds.TryGetValue(id, out var cached))
+        {
+            return cached;
+        }
+
+        // first time this class has been seen, resolve it by name and register it so later lookups skip getName
+        try
+        {
+            var classInfo = GetClassInfo("java/lang/Class");
+            var classPath = classInfo.Call<string>(cls, "getName", new TypedArg[]{}, false).Replace('.', '/');
+            // classes of an isolated JavaClassLoader are not found by name, nor are those shadowed by a class of the same name
+            var objCls = TryGetClassInfo(classPath, out var named) && MudInterface.is_same_object(Env, named.Cls, cls)
+                ? named
+                : ClassInfoOf(cls, classPath);
+            MudInterface.class_cache_put(Env, cls, objCls.Id);
+            return objCls;
+        }
+        finally
+        {
+            MudInterface.release_obj(Env, cls);
+        }
     }
 
     
@@ -366,10 +1194,10 @@ public static class Jvm
     {
         // ReSharper disable once NullCoalescingConditionIsAlwaysNotNullAccordingToAPIContract
         obj.Info ??= GetClassInfo(classPath);
-        obj.Env = Instance.Env;
+        obj.Env = Env;
 
         obj.Bind(args);
-        ObjPointers.Add(obj.Jobj);
+        Hold(obj);
     }
     
     private static IBoundObject NewObj(Type type, string? classPath, params TypedArg[] args)
@@ -407,6 +1235,10 @@ public static class Jvm
     {
         if (!type.IsAssignableTo(typeof(BoundObject)))
         {
+            if (BoundTypes.TryCreate(type, out var generated))
+            {
+                return generated;
+            }
             type = TypeGen.Build(type)!;    
         }
         return (BoundObject)Activator.CreateInstance(type)!;
@@ -422,6 +1254,18 @@ public static class Jvm
     {
       return NewObj(typeof(BoundObject), classPath, args);  
     } 
+
+    /// <summary>
+    /// Creates a new object of the class, which may belong to a JavaClassLoader and not be found by its class path
+    /// </summary>
+    internal static IBoundObject NewObj(ClassInfo classInfo, params TypedArg[] args)
+    {
+        EnsureInit();
+        var obj = NewUnboundObj(typeof(BoundObject));
+        obj.Info = classInfo;
+        LoadObj(obj, classInfo.ClassPath, args);
+        return obj;
+    }
     
 
     /// <summary>
@@ -446,8 +1290,7 @@ public static class Jvm
         try
         {
             EnsureInit();
-            ObjPointers.Remove(obj);
-            MudInterface.release_obj(Instance.Env, obj);
+            MudInterface.release_obj(Env, obj);
         }
         catch (Exception e)
         {
@@ -472,7 +1315,7 @@ public static class Jvm
     //     
     //     pointers.ForEach(ptr =>
     //     {
-    //         MudInterface.release_obj(Instance.Env, ptr);
+    //         MudInterface.release_obj(Env, ptr);
     //     });
     //     ObjPointers.Clear();
     //     MudInterface.destroy_instance(Instance.Jvm);
@@ -492,6 +1335,122 @@ internal static class MudInterface
     [DllImport("libMud", CharSet = CharSet.Ansi, EntryPoint = "mud_jvm_create_instance")]
     internal static extern JvmInstance create_instance(IntPtr options, int optionsAmnt);
 
+    [DllImport("libMud", CharSet = CharSet.Ansi, EntryPoint = "mud_jvm_attach_thread")]
+    internal static extern IntPtr attach_thread(IntPtr jvm, [MarshalAs(UnmanagedType.U1)] bool daemon);
+
+    [DllImport("libMud", CharSet = CharSet.Ansi, EntryPoint = "mud_jvm_detach_thread")]
+    [return: MarshalAs(UnmanagedType.U1)]
+    internal static extern bool detach_thread(IntPtr jvm);
+
+    [DllImport("libMud", CharSet = CharSet.Ansi, EntryPoint = "mud_new_global_ref")]
+    internal static extern IntPtr new_global_ref(IntPtr env, IntPtr obj);
+
+    [DllImport("libMud", CharSet = CharSet.Ansi, EntryPoint = "mud_release_global_ref")]
+    internal static extern void release_global_ref(IntPtr env, IntPtr obj);
+
+    [DllImport("libMud", CharSet = CharSet.Ansi, EntryPoint = "mud_handle_promote")]
+    internal static extern JavaHandle handle_promote(IntPtr env, IntPtr local);
+
+    [DllImport("libMud", CharSet = CharSet.Ansi, EntryPoint = "mud_handle_get")]
+    internal static extern IntPtr handle_get(ulong id);
+
+    [DllImport("libMud", CharSet = CharSet.Ansi, EntryPoint = "mud_handle_release")]
+    [return: MarshalAs(UnmanagedType.U1)]
+    internal static extern bool handle_release(IntPtr env, ulong id);
+
+    [DllImport("libMud", CharSet = CharSet.Ansi, EntryPoint = "mud_handle_count")]
+    internal static extern nuint handle_count();
+
+    [DllImport("libMud", CharSet = CharSet.Ansi, EntryPoint = "mud_class_cache_get")]
+    internal static extern ulong class_cache_get(IntPtr env, IntPtr obj, out IntPtr cls);
+
+    [DllImport("libMud", CharSet = CharSet.Ansi, EntryPoint = "mud_class_cache_put")]
+    internal static extern void class_cache_put(IntPtr env, IntPtr cls, ulong token);
+
+    [DllImport("libMud", CharSet = CharSet.Ansi, EntryPoint = "mud_class_cache_count")]
+    internal static extern nuint class_cache_count();
+
+    [DllImport("libMud", CharSet = CharSet.Ansi, EntryPoint = "mud_identity_put")]
+    internal static extern void identity_put(IntPtr env, IntPtr obj, int hash, ulong token);
+
+    [DllImport("libMud", CharSet = CharSet.Ansi, EntryPoint = "mud_identity_remove")]
+    internal static extern void identity_remove(IntPtr env, int hash, ulong token);
+
+    [DllImport("libMud", CharSet = CharSet.Ansi, EntryPoint = "mud_identity_count")]
+    internal static extern nuint identity_count();
+
+    [DllImport("libMud", CharSet = CharSet.Ansi, EntryPoint = "mud_is_same_object")]
+    [return: MarshalAs(UnmanagedType.U1)]
+    internal static extern bool is_same_object(IntPtr env, IntPtr a, IntPtr b);
+
+    [DllImport("libMud", CharSet = CharSet.Ansi, EntryPoint = "mud_upcall_init")]
+    [return: MarshalAs(UnmanagedType.U1)]
+    internal static extern bool upcall_init(IntPtr env, IntPtr dispatcher);
+
+    [DllImport("libMud", CharSet = CharSet.Ansi, EntryPoint = "mud_upcall_proxy")]
+    internal static extern IntPtr upcall_proxy(IntPtr env, IntPtr iface, ulong handle);
+
+    [DllImport("libMud", CharSet = CharSet.Ansi, EntryPoint = "mud_upcall_throw")]
+    internal static extern void upcall_throw(IntPtr env, IntPtr ex, string? msg);
+
+    [DllImport("libMud", CharSet = CharSet.Ansi, EntryPoint = "mud_ring_create")]
+    internal static extern IntPtr ring_create(ulong capacity);
+
+    [DllImport("libMud", CharSet = CharSet.Ansi, EntryPoint = "mud_ring_destroy")]
+    internal static extern void ring_destroy(IntPtr ring);
+
+    [DllImport("libMud", CharSet = CharSet.Ansi, EntryPoint = "mud_ring_memory")]
+    internal static extern IntPtr ring_memory(IntPtr ring);
+
+    [DllImport("libMud", CharSet = CharSet.Ansi, EntryPoint = "mud_ring_buffer")]
+    internal static extern IntPtr ring_buffer(IntPtr env, IntPtr ring);
+
+    [DllImport("libMud", CharSet = CharSet.Ansi, EntryPoint = "mud_ring_await_readable")]
+    internal static extern ulong ring_await_readable(IntPtr ring, long timeoutNs);
+
+    [DllImport("libMud", CharSet = CharSet.Ansi, EntryPoint = "mud_ring_await_writable")]
+    internal static extern ulong ring_await_writable(IntPtr ring, ulong bytes, long timeoutNs);
+
+    [DllImport("libMud", CharSet = CharSet.Ansi, EntryPoint = "mud_ring_signal")]
+    internal static extern void ring_signal(IntPtr ring);
+
+    [DllImport("libMud", CharSet = CharSet.Ansi, EntryPoint = "mud_ring_init")]
+    [return: MarshalAs(UnmanagedType.U1)]
+    internal static extern bool ring_init(IntPtr env);
+
+    [DllImport("libMud", CharSet = CharSet.Ansi, EntryPoint = "mud_loader_create")]
+    internal static extern IntPtr loader_create(IntPtr env, IntPtr parent);
+
+    [DllImport("libMud", CharSet = CharSet.Ansi, EntryPoint = "mud_loader_add_jar")]
+    [return: MarshalAs(UnmanagedType.U1)]
+    internal static extern bool loader_add_jar(IntPtr loader, string path);
+
+    [DllImport("libMud", CharSet = CharSet.Ansi, EntryPoint = "mud_loader_add_jar_bytes")]
+    [return: MarshalAs(UnmanagedType.U1)]
+    internal static extern bool loader_add_jar_bytes(IntPtr loader, ref byte bytes, nuint len);
+
+    [DllImport("libMud", CharSet = CharSet.Ansi, EntryPoint = "mud_loader_object")]
+    internal static extern IntPtr loader_object(IntPtr env, IntPtr loader);
+
+    [DllImport("libMud", CharSet = CharSet.Ansi, EntryPoint = "mud_loader_class_count")]
+    internal static extern nuint loader_class_count(IntPtr loader);
+
+    [DllImport("libMud", CharSet = CharSet.Ansi, EntryPoint = "mud_loader_load_class")]
+    internal static extern IntPtr loader_load_class(IntPtr env, IntPtr loader, string className);
+
+    [DllImport("libMud", CharSet = CharSet.Ansi, EntryPoint = "mud_loader_close")]
+    internal static extern void loader_close(IntPtr env, IntPtr loader);
+
+    [DllImport("libMud", CharSet = CharSet.Ansi, EntryPoint = "mud_register_native")]
+    [return: MarshalAs(UnmanagedType.U1)]
+    internal static extern bool register_native(IntPtr env, IntPtr cls, string method, string signature, IntPtr fn);
+
+    [DllImport("libMud", CharSet = CharSet.Ansi, EntryPoint = "mud_stats_snapshot")]
+    internal static extern void stats_snapshot(out JvmStats.Native stats);
+
+    [DllImport("libMud", CharSet = CharSet.Ansi, EntryPoint = "mud_stats_set_timing")]
+    internal static extern void stats_set_timing([MarshalAs(UnmanagedType.U1)] bool enabled);
+
     [DllImport("libMud", CharSet = CharSet.Ansi, EntryPoint = "mud_jvm_options_str_arr",
         CallingConvention = CallingConvention.Cdecl)]
     internal static extern IntPtr gen_options_arr(int amnt, string[] options);
@@ -508,9 +1467,6 @@ internal static class MudInterface
     [DllImport("libMud", CharSet = CharSet.Ansi, EntryPoint = "interop_free")]
     internal static extern void interop_free(IntPtr ptr);
 
-    [DllImport("libMud", CharSet = CharSet.Ansi, EntryPoint = "mud_get_exception_msg")]
-    internal static extern IntPtr get_exception_msg(IntPtr env, IntPtr ex, IntPtr getCauseMethod, IntPtr getStackMethod,
-        IntPtr exToStringMethod, IntPtr frameToStringMethod, bool isTop);
     
     [DllImport("libMud", CharSet = CharSet.Ansi, EntryPoint = "mud_jvm_check_exception")]
     internal static extern IntPtr check_exception(IntPtr env);
@@ -518,6 +1474,12 @@ internal static class MudInterface
     [DllImport("libMud", CharSet = CharSet.Ansi, EntryPoint = "mud_string_new")]
     internal static extern IntPtr string_new(IntPtr env, string str);
 
+    [DllImport("libMud", CharSet = CharSet.Ansi, EntryPoint = "mud_string_new_utf16")]
+    internal static extern unsafe IntPtr string_new_utf16(IntPtr env, char* chars, int len);
+
+    [DllImport("libMud", CharSet = CharSet.Ansi, EntryPoint = "mud_string_copy_utf16")]
+    internal static extern unsafe int string_copy_utf16(IntPtr env, IntPtr jString, char* buf, int capacity);
+
     [DllImport("libMud", CharSet = CharSet.Ansi, EntryPoint = "mud_string_release")]
     internal static extern void string_release(IntPtr env, IntPtr jString, IntPtr charStr);
 
@@ -594,11 +1556,51 @@ internal static class MudInterface
     internal static extern void release_obj(IntPtr env, IntPtr obj);
 
     [DllImport("libMud", CharSet = CharSet.Ansi, EntryPoint = "mud_instance_of")]
+    [return: MarshalAs(UnmanagedType.U1)]
     internal static extern bool instance_of(IntPtr env, IntPtr obj, IntPtr cls);
 
+    [DllImport("libMud", CharSet = CharSet.Ansi, EntryPoint = "mud_is_assignable_from")]
+    [return: MarshalAs(UnmanagedType.U1)]
+    internal static extern bool is_assignable_from(IntPtr env, IntPtr sub, IntPtr sup);
+
     [DllImport("libMud", CharSet = CharSet.Ansi, EntryPoint = "mud_array_new")]
     internal static extern IntPtr array_new(IntPtr env, int size, JavaVal[] values, JavaType type, IntPtr objCls);
     
+    [DllImport("libMud", CharSet = CharSet.Ansi, EntryPoint = "mud_array_new_primitive")]
+    internal static extern IntPtr array_new_primitive(IntPtr env, nuint size, ref byte values, JavaType type);
+
+    [DllImport("libMud", CharSet = CharSet.Ansi, EntryPoint = "mud_array_set_region")]
+    internal static extern IntPtr array_set_region(IntPtr env, IntPtr arr, nuint start, nuint len, ref byte values, JavaType type);
+
+    [DllImport("libMud", CharSet = CharSet.Ansi, EntryPoint = "mud_array_get_region")]
+    internal static extern IntPtr array_get_region(IntPtr env, IntPtr arr, nuint start, nuint len, ref byte values, JavaType type);
+    
+    [DllImport("libMud", CharSet = CharSet.Ansi, EntryPoint = "mud_array_new_shaped")]
+    internal static extern IntPtr array_new_shaped(IntPtr env, nuint rank, nuint[] dims, ref byte values, JavaType type);
+
+    [DllImport("libMud", CharSet = CharSet.Ansi, EntryPoint = "mud_array_shape")]
+    internal static extern IntPtr array_shape(IntPtr env, IntPtr arr, nuint rank, [Out] nuint[] dims);
+
+    [DllImport("libMud", CharSet = CharSet.Ansi, EntryPoint = "mud_array_get_shaped")]
+    internal static extern IntPtr array_get_shaped(IntPtr env, IntPtr arr, nuint rank, nuint[] dims, ref byte values, JavaType type);
+
+    [DllImport("libMud", CharSet = CharSet.Ansi, EntryPoint = "mud_array_new_jagged")]
+    internal static extern IntPtr array_new_jagged(IntPtr env, nuint rows, long[] lengths, ref byte values, JavaType type);
+
+    [DllImport("libMud", CharSet = CharSet.Ansi, EntryPoint = "mud_array_jagged_lengths")]
+    internal static extern IntPtr array_jagged_lengths(IntPtr env, IntPtr arr, nuint rows, [Out] long[] lengths);
+
+    [DllImport("libMud", CharSet = CharSet.Ansi, EntryPoint = "mud_array_get_jagged")]
+    internal static extern IntPtr array_get_jagged(IntPtr env, IntPtr arr, nuint rows, long[] lengths, ref byte values, JavaType type);
+
+    [DllImport("libMud", CharSet = CharSet.Ansi, EntryPoint = "mud_array_pin")]
+    internal static extern IntPtr array_pin(IntPtr env, IntPtr arr, JavaType type, [MarshalAs(UnmanagedType.U1)] bool critical,
+        [MarshalAs(UnmanagedType.U1)] out bool isCopy);
+
+    [DllImport("libMud", CharSet = CharSet.Ansi, EntryPoint = "mud_array_unpin")]
+    internal static extern void array_unpin(IntPtr env, IntPtr arr, IntPtr elems, JavaType type,
+        [MarshalAs(UnmanagedType.U1)] bool critical, JavaReleaseMode mode);
+    
     [DllImport("libMud", CharSet = CharSet.Ansi, EntryPoint = "mud_array_length")]
     internal static extern int array_length(IntPtr env, IntPtr obj);
 
@@ -609,7 +1611,8 @@ internal static class MudInterface
     internal static extern void destroy_instance(IntPtr jvm);
     
     [DllImport("libMud", CharSet = CharSet.Ansi, EntryPoint = "mud_add_class_path")]
-    internal static extern void add_class_path(IntPtr env, string path);
+    [return: MarshalAs(UnmanagedType.U1)]
+    internal static extern bool add_class_path(IntPtr env, string path);
     
     
 }
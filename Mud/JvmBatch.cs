@@ -0,0 +1,160 @@
+using System.Runtime.InteropServices;
+using Mud.Exceptions;
+using Mud.Types;
+
+namespace Mud;
+
+/// <summary>
+/// Collects a series of java calls that are then all run in a single native transition.
+/// Calls run in the order they were added and the batch stops at the first call that throws
+/// </summary>
+public sealed class JvmBatch
+{
+    private readonly record struct Entry(ClassInfo Info, IBoundObject? Target, string Method, CustomType ReturnType, Type? ClrReturnType,
+        object?[] Args);
+
+    private readonly List<Entry> _entries = new();
+
+    /// <summary>
+    /// Number of calls that have been added to the batch
+    /// </summary>
+    public int Count => _entries.Count;
+
+    /// <summary>
+    /// Number of calls that were run by the last Execute, includes the call that threw if there was one
+    /// </summary>
+    public int Executed { get; private set; }
+
+    /// <summary>
+    /// Adds a call to a void method on the backing java object
+    /// </summary>
+    /// <param name="target">Object the method is to be called on</param>
+    /// <param name="method">Method to be called</param>
+    /// <param name="args">Arguments to be passed into the method</param>
+    public JvmBatch Call(IBoundObject target, string method, params object?[] args) =>
+        Add(target.Info, target, method, null, args);
+
+    /// <summary>
+    /// Adds a call to a method on the backing java object, its mapped result is returned by Execute at the call's index
+    /// </summary>
+    /// <param name="target">Object the method is to be called on</param>
+    /// <param name="method">Method to be called</param>
+    /// <param name="args">Arguments to be passed into the method</param>
+    /// <typeparam name="T">Return type of the method</typeparam>
+    public JvmBatch Call<T>(IBoundObject target, string method, params object?[] args) =>
+        Add(target.Info, target, method, typeof(T), args);
+
+    /// <summary>
+    /// Adds a call to a static void method of the class
+    /// </summary>
+    /// <param name="cls">Class the method belongs to</param>
+    /// <param name="method">Method to be called</param>
+    /// <param name="args">Arguments to be passed into the method</param>
+    public JvmBatch CallStatic(ClassInfo cls, string method, params object?[] args) =>
+        Add(cls, null, method, null, args);
+
+    /// <summary>
+    /// Adds a call to a static method of the class, its mapped result is returned by Execute at the call's index
+    /// </summary>
+    /// <param name="cls">Class the method belongs to</param>
+    /// <param name="method">Method to be called</param>
+    /// <param name="args">Arguments to be passed into the method</param>
+    /// <typeparam name="T">Return type of the method</typeparam>
+    public JvmBatch CallStatic<T>(ClassInfo cls, string method, params object?[] args) =>
+        Add(cls, null, method, typeof(T), args);
+
+    private JvmBatch Add(ClassInfo info, IBoundObject? target, string method, Type? returnType, object?[] args)
+    {
+        if (target is { IsStatic: true })
+        {
+            throw new InstanceMemberOnStaticException(method, info);
+        }
+        var customType = TypeMap.MapToType(returnType ?? typeof(void), null);
+        _entries.Add(new Entry(info, target, method, customType, returnType, args));
+        return this;
+    }
+
+    /// <summary>
+    /// Removes all of the added calls
+    /// </summary>
+    public void Clear()
+    {
+        _entries.Clear();
+        Executed = 0;
+    }
+
+    /// <summary>
+    /// Runs all of the added calls in a single native call
+    /// </summary>
+    /// <returns>The mapped result of each call by index, void calls are null</returns>
+    /// <exception cref="JavaException">Will throw the first exception raised in the JVM, later calls are not run</exception>
+    public unsafe object?[] Execute()
+    {
+        Jvm.EnsureInit();
+        Executed = 0;
+        var calls = new JavaBatchCall[_entries.Count];
+        var results = new JavaCallResp[_entries.Count];
+        var args = new List<JavaVal>();
+        var pointers = new List<IntPtr>();
+        try
+        {
+            for (var i = 0; i < _entries.Count; i++)
+            {
+                var entry = _entries[i];
+                var typedArgs = entry.Args.Select(a => a as TypedArg ?? new TypedArg(a!)).ToArray();
+                var isStatic = entry.Target == null;
+                var signature = TypeMap.GenMethodSignature(entry.ReturnType, typedArgs);
+                calls[i] = new JavaBatchCall
+                {
+                    ObjOrCls = isStatic ? entry.Info.Cls : entry.Target!.Jobj,
+                    Method = entry.Info.GetMethodPtr(entry.Method, signature, isStatic),
+                    Type = entry.ReturnType.Type,
+                    IsStatic = isStatic ? (byte)1 : (byte)0,
+                    ArgOffset = (uint)args.Count,
+                };
+                foreach (var arg in typedArgs)
+                {
+                    args.Add(Jvm.MapArg(arg, pointers));
+                }
+            }
+
+            var argsSpan = CollectionsMarshal.AsSpan(args);
+            nuint executed;
+            fixed (JavaBatchCall* callsPtr = calls)
+            fixed (JavaVal* argsPtr = argsSpan)
+            fixed (JavaCallResp* resultsPtr = results)
+            {
+                executed = MudNative.CallBatch(Jvm.Env, callsPtr, (nuint)calls.Length, argsPtr, resultsPtr);
+            }
+            Executed = (int)executed;
+        }
+        finally
+        {
+            foreach (var ptr in pointers)
+            {
+                MudInterface.release_obj(Jvm.Env, ptr);
+            }
+            GC.KeepAlive(_entries);
+        }
+
+        if (Executed > 0 && results[Executed - 1].IsException)
+        {
+            for (var i = 0; i < Executed - 1; i++)
+            {
+                if (_entries[i].ReturnType.Type == JavaType.Object)
+                {
+                    MudInterface.release_obj(Jvm.Env, results[i].Value.Object);
+                }
+            }
+            Jvm.ThrowException(results[Executed - 1].Value.Object);
+        }
+
+        var mapped = new object?[Executed];
+        for (var i = 0; i < Executed; i++)
+        {
+            var clrType = _entries[i].ClrReturnType;
+            mapped[i] = clrType == null ? null : TypeMap.MapJValue(_entries[i].ReturnType.Type, clrType, results[i].Value);
+        }
+        return mapped;
+    }
+}
@@ -0,0 +1,53 @@
+using System.Diagnostics.Metrics;
+using Mud.Types;
+
+namespace Mud;
+
+/// <summary>
+/// Publishes the clib's interop counters as System.Diagnostics.Metrics instruments under the "Mud" meter
+/// </summary>
+internal static class JvmMetrics
+{
+    internal static readonly Meter Meter = new("Mud");
+
+    static JvmMetrics()
+    {
+        Meter.CreateObservableCounter("mud.transitions", () => JvmStats.Snapshot().Transitions,
+            description: "Calls from .NET into the mud clib");
+        Meter.CreateObservableCounter("mud.lookups", () =>
+        {
+            var stats = JvmStats.Snapshot();
+            return new[]
+            {
+                new Measurement<long>(stats.MethodLookups, new KeyValuePair<string, object?>("kind", "method")),
+                new Measurement<long>(stats.FieldLookups, new KeyValuePair<string, object?>("kind", "field")),
+            };
+        }, description: "Method and field id lookups, each one is a ClassInfo cache miss");
+        Meter.CreateObservableCounter("mud.calls", () => JvmStats.Snapshot().CallsByType
+                .Select(c => new Measurement<long>(c.Value, new KeyValuePair<string, object?>("return_type", c.Key.ToString()))),
+            description: "Java method calls by return type");
+        Meter.CreateObservableCounter("mud.exceptions", () => JvmStats.Snapshot().Exceptions,
+            description: "Exceptions raised in the JVM");
+        Meter.CreateObservableUpDownCounter("mud.refs", () =>
+        {
+            var stats = JvmStats.Snapshot();
+            return new[]
+            {
+                new Measurement<long>(stats.LiveLocalRefs, new KeyValuePair<string, object?>("kind", "local")),
+                new Measurement<long>(stats.LiveGlobalRefs, new KeyValuePair<string, object?>("kind", "global")),
+            };
+        }, description: "Live java object references");
+        Meter.CreateObservableCounter("mud.marshaled", () =>
+        {
+            var stats = JvmStats.Snapshot();
+            return new[]
+            {
+                new Measurement<long>(stats.StringBytes, new KeyValuePair<string, object?>("kind", "string")),
+                new Measurement<long>(stats.ArrayBytes, new KeyValuePair<string, object?>("kind", "array")),
+            };
+        }, unit: "By", description: "Bytes copied into or out of the JVM");
+        Meter.CreateObservableCounter("mud.call_latency", () => JvmStats.Snapshot().CallLatency
+                .Select((count, i) => new Measurement<long>(count, new KeyValuePair<string, object?>("le", 1L << (i + 1)))),
+            unit: "ns", description: "Java method calls by latency bucket, only recorded while Jvm.StatsTiming is enabled");
+    }
+}
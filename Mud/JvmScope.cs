@@ -0,0 +1,130 @@
+using Mud.Exceptions;
+using Mud.Types;
+
+namespace Mud;
+
+/// <summary>
+/// A JNI local frame on the current thread. Java objects bound while the scope is the thread's innermost one are kept as
+/// local refs rather than being promoted into the handle table, and are all released by a single native call when the
+/// scope is disposed. Objects that must outlive the scope are handed to Promote.
+///
+/// Objects bound in a scope are only valid on its thread and until it is disposed, after which they behave as released.
+/// Scopes nest and must be disposed on their thread in the reverse order they were created
+/// </summary>
+public sealed class JvmScope : IDisposable
+{
+    [ThreadStatic]
+    private static JvmScope? _current;
+
+    private readonly IntPtr _env;
+    private readonly JvmScope? _previous;
+    private readonly List<IBoundObject> _bound;
+    private bool _disposed;
+
+    /// <summary>
+    /// The innermost scope of the current thread, null outside any scope or while mud runs code in a frame of its own
+    /// </summary>
+    internal static JvmScope? Current => _current;
+
+    /// <summary>
+    /// Amount of objects bound in the scope so far
+    /// </summary>
+    public int Count => _bound.Count;
+
+    private JvmScope(IntPtr env, int capacity)
+    {
+        _env = env;
+        _previous = _current;
+        _bound = new List<IBoundObject>(capacity);
+        _current = this;
+    }
+
+    /// <summary>
+    /// Pushes a local frame with room for at least the provided amount of local refs, the JVM grows it as needed
+    /// </summary>
+    /// <param name="capacity">Amount of objects expected to be bound in the scope</param>
+    /// <exception cref="JavaException">Throws if the JVM is out of memory for the frame</exception>
+    /// <exception cref="OutOfMemoryException">Throws if the frame could not be pushed without a pending java exception</exception>
+    internal static unsafe JvmScope Push(int capacity)
+    {
+        var env = Jvm.Env;
+        if (MudNative.PushLocalFrame(env, Math.Max(capacity, 1)) == 0)
+        {
+            Jvm.ThrowException(MudInterface.check_exception(env));
+            // without a frame the scope's pop would release the caller's locals
+            throw new OutOfMemoryException($"Unable to push a local frame for {capacity} objects");
+        }
+        return new JvmScope(env, capacity);
+    }
+
+    /// <summary>
+    /// Keeps the bound object past the end of the scope by promoting it into the handle table,
+    /// it is then released like any object bound outside a scope
+    /// </summary>
+    /// <param name="obj">Object bound in this scope or one of the scopes it is nested in, as any object bound in a live
+    /// scope of the thread can be promoted. Objects that already outlive it, or were released, are returned as is</param>
+    /// <returns>The provided object</returns>
+    /// <exception cref="ObjectDisposedException">Throws if the scope has been disposed</exception>
+    public T Promote<T>(T obj) where T : IBoundObject
+    {
+        ObjectDisposedException.ThrowIf(_disposed, this);
+        if (obj.Handle == 0 && obj.Jobj != IntPtr.Zero)
+        {
+            // it stays in the bound list but is skipped when the scope ends as it now has a handle
+            Jvm.Promote(obj);
+        }
+        return obj;
+    }
+
+    /// <summary>
+    /// Tracks an object bound while the scope is current, its local ref belongs to the scope's frame
+    /// </summary>
+    internal void Add(IBoundObject obj) => _bound.Add(obj);
+
+    /// <summary>
+    /// Runs mud code that pushes frames of its own, or must always bind global objects, outside the current scope
+    /// </summary>
+    /// <returns>Restores the scope when disposed</returns>
+    internal static Suspension Suspend()
+    {
+        var suspended = new Suspension(_current);
+        _current = null;
+        return suspended;
+    }
+
+    internal readonly struct Suspension : IDisposable
+    {
+        private readonly JvmScope? _scope;
+
+        internal Suspension(JvmScope? scope) => _scope = scope;
+
+        public void Dispose() => _current = _scope;
+    }
+
+    /// <summary>
+    /// Pops the scope's frame, releasing every object bound in it that has not been promoted
+    /// </summary>
+    /// <exception cref="InvalidOperationException">Throws if disposed on another thread or before a scope nested in it</exception>
+    public unsafe void Dispose()
+    {
+        if (_disposed)
+        {
+            return;
+        }
+        if (_current != this)
+        {
+            throw new InvalidOperationException("Scopes must be disposed on their own thread in the reverse order they were created");
+        }
+        _disposed = true;
+        _current = _previous;
+        MudNative.PopLocalFrame(_env, IntPtr.Zero);
+        foreach (var obj in _bound)
+        {
+            if (obj.Handle == 0)
+            {
+                obj.Jobj = IntPtr.Zero;
+            }
+        }
+        _bound.Clear();
+    }
+}
@@ -0,0 +1,77 @@
+namespace Mud;
+
+/// <summary>
+/// How the JVM uses class data sharing, matches the -Xshare modes
+/// </summary>
+public enum ClassDataSharing
+{
+    /// <summary>
+    /// Map the archive when it can be, otherwise load classes normally
+    /// </summary>
+    Auto,
+    /// <summary>
+    /// Fail to start the JVM when the archive cannot be mapped, keeps cold start latency predictable
+    /// </summary>
+    On,
+    /// <summary>
+    /// Never use class data sharing
+    /// </summary>
+    Off
+}
+
+/// <summary>
+/// Startup behaviour of the JVM beyond its raw arguments
+/// </summary>
+public sealed class JvmStartupOptions
+{
+    /// <summary>
+    /// Class data sharing (CDS/AppCDS) archive to map at startup, either a static archive made with -Xshare:dump
+    /// or a dynamic one recorded with RecordClassDataArchive
+    /// </summary>
+    public string? ClassDataArchive { get; init; }
+
+    /// <summary>
+    /// When ClassDataArchive does not exist yet, record the classes loaded during this run into it instead.
+    /// The JVM writes the archive when it exits, e.g. through java.lang.System.exit at the end of a training run
+    /// </summary>
+    public bool RecordClassDataArchive { get; init; }
+
+    /// <summary>
+    /// Class data sharing mode
+    /// </summary>
+    public ClassDataSharing Sharing { get; init; } = ClassDataSharing.Auto;
+
+    /// <summary>
+    /// Classes, members and bound interfaces to resolve right after the JVM is created
+    /// </summary>
+    public PreloadManifest? Preload { get; init; }
+
+    /// <summary>
+    /// Number of threads resolving the preload manifest
+    /// </summary>
+    public int PreloadParallelism { get; init; } = Environment.ProcessorCount;
+
+    /// <summary>
+    /// The JVM arguments for the class data sharing options
+    /// </summary>
+    internal IEnumerable<string> JvmArgs()
+    {
+        var recording = ClassDataArchive != null && RecordClassDataArchive && !File.Exists(ClassDataArchive);
+        if (recording)
+        {
+            // a dynamic archive is dumped on top of the JDK's base archive, so sharing has to stay enabled
+            yield return $"-XX:ArchiveClassesAtExit={Path.GetFullPath(ClassDataArchive!)}";
+            yield break;
+        }
+        if (ClassDataArchive != null && Sharing != ClassDataSharing.Off)
+        {
+            yield return $"-XX:SharedArchiveFile={Path.GetFullPath(ClassDataArchive)}";
+        }
+        yield return Sharing switch
+        {
+            ClassDataSharing.On => "-Xshare:on",
+            ClassDataSharing.Off => "-Xshare:off",
+            _ => "-Xshare:auto"
+        };
+    }
+}
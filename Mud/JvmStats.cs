@@ -0,0 +1,124 @@
+using System.Runtime.InteropServices;
+using Mud.Types;
+
+namespace Mud;
+
+/// <summary>
+/// Interop counters kept by the mud clib, summed across every thread that has called into it
+/// </summary>
+public sealed class JvmStats
+{
+    /// <summary>
+    /// Amount of buckets in the call latency histogram
+    /// </summary>
+    public const int LatencyBuckets = 32;
+
+    /// <summary>
+    /// Matches the mud clib stats struct
+    /// </summary>
+    [StructLayout(LayoutKind.Sequential)]
+    internal unsafe struct Native
+    {
+        public ulong Transitions;
+        public ulong MethodLookups;
+        public ulong FieldLookups;
+        public fixed ulong CallsByType[(int)JavaType.Void + 1];
+        public ulong Exceptions;
+        public ulong LocalRefsCreated;
+        public ulong LocalRefsReleased;
+        public ulong GlobalRefsCreated;
+        public ulong GlobalRefsReleased;
+        public ulong StringBytes;
+        public ulong ArrayBytes;
+        public fixed ulong CallLatency[LatencyBuckets];
+    }
+
+    /// <summary>
+    /// Calls from .NET into the mud clib
+    /// </summary>
+    public long Transitions { get; }
+
+    /// <summary>
+    /// Method id lookups, method ids are cached by ClassInfo so each one is a cache miss
+    /// </summary>
+    public long MethodLookups { get; }
+
+    /// <summary>
+    /// Field id lookups, field ids are cached by ClassInfo so each one is a cache miss
+    /// </summary>
+    public long FieldLookups { get; }
+
+    /// <summary>
+    /// Java method calls by the type they return
+    /// </summary>
+    public IReadOnlyDictionary<JavaType, long> CallsByType { get; }
+
+    /// <summary>
+    /// Total java method calls
+    /// </summary>
+    public long Calls => CallsByType.Values.Sum();
+
+    /// <summary>
+    /// Exceptions raised in the JVM
+    /// </summary>
+    public long Exceptions { get; }
+
+    /// <summary>
+    /// Local refs handed out by the clib that have not been released, locals freed by the JVM when a native frame ends are not seen
+    /// </summary>
+    public long LiveLocalRefs { get; }
+
+    /// <summary>
+    /// Global refs created by the clib that have not been released
+    /// </summary>
+    public long LiveGlobalRefs { get; }
+
+    /// <summary>
+    /// Bytes of string data copied into or out of the JVM
+    /// </summary>
+    public long StringBytes { get; }
+
+    /// <summary>
+    /// Bytes of primitive array data copied into or out of the JVM
+    /// </summary>
+    public long ArrayBytes { get; }
+
+    /// <summary>
+    /// Call latency histogram, bucket i counts calls taking between 2^i and 2^(i+1) nanoseconds.
+    /// Only recorded while Jvm.StatsTiming is enabled
+    /// </summary>
+    public IReadOnlyList<long> CallLatency { get; }
+
+    private unsafe JvmStats(Native native)
+    {
+        Transitions = (long)native.Transitions;
+        MethodLookups = (long)native.MethodLookups;
+        FieldLookups = (long)native.FieldLookups;
+        var calls = new Dictionary<JavaType, long>();
+        foreach (var type in Enum.GetValues<JavaType>())
+        {
+            calls[type] = (long)native.CallsByType[(int)type];
+        }
+        CallsByType = calls;
+        Exceptions = (long)native.Exceptions;
+        LiveLocalRefs = (long)native.LocalRefsCreated - (long)native.LocalRefsReleased;
+        LiveGlobalRefs = (long)native.GlobalRefsCreated - (long)native.GlobalRefsReleased;
+        StringBytes = (long)native.StringBytes;
+        ArrayBytes = (long)native.ArrayBytes;
+        var latency = new long[LatencyBuckets];
+        for (var i = 0; i < LatencyBuckets; i++)
+        {
+            latency[i] = (long)native.CallLatency[i];
+        }
+        CallLatency = latency;
+    }
+
+    /// <summary>
+    /// Takes a snapshot of the clib's counters
+    /// </summary>
+    public static JvmStats Snapshot()
+    {
+        MudInterface.stats_snapshot(out var native);
+        return new JvmStats(native);
+    }
+}
@@ -0,0 +1,236 @@
+using System.Threading.Channels;
+
+namespace Mud;
+
+/// <summary>
+/// A pool of dedicated threads that attach to the JVM on their first call and stay attached, used to run java calls off
+/// of the .NET thread pool.
+/// Work is fed through a bounded queue, callers awaiting a full queue are the backpressure
+/// </summary>
+public sealed class JvmWorkerPool : IDisposable
+{
+    private abstract class WorkItem
+    {
+        internal abstract void Execute();
+
+        /// <summary>
+        /// Completes the item with an error without running it
+        /// </summary>
+        internal abstract void Fail(Exception exception);
+
+        /// <summary>
+        /// Releases the item's cancellation registration when it never made it into the queue
+        /// </summary>
+        internal abstract void Discard();
+    }
+
+    private sealed class WorkItem<T> : WorkItem
+    {
+        private readonly Func<T> _func;
+        private readonly CancellationToken _cancellationToken;
+        private readonly CancellationTokenRegistration _registration;
+        // continuations are run on the thread pool so awaiting code never runs on a JVM worker
+        internal readonly TaskCompletionSource<T> Completion = new(TaskCreationOptions.RunContinuationsAsynchronously);
+
+        internal WorkItem(Func<T> func, CancellationToken cancellationToken)
+        {
+            _func = func;
+            _cancellationToken = cancellationToken;
+            if (cancellationToken.CanBeCanceled)
+            {
+                _registration = cancellationToken.Register(static s =>
+                {
+                    var item = (WorkItem<T>)s!;
+                    item.Completion.TrySetCanceled(item._cancellationToken);
+                }, this);
+            }
+        }
+
+        internal override void Execute()
+        {
+            _registration.Dispose();
+            if (Completion.Task.IsCompleted)
+            {
+                return;
+            }
+            try
+            {
+                Completion.TrySetResult(_func());
+            }
+            catch (Exception e)
+            {
+                Completion.TrySetException(e);
+            }
+        }
+
+        internal override void Fail(Exception exception)
+        {
+            _registration.Dispose();
+            Completion.TrySetException(exception);
+        }
+
+        internal override void Discard() => _registration.Dispose();
+    }
+
+    private readonly Channel<WorkItem> _queue;
+    private readonly Thread[] _threads;
+
+    /// <summary>
+    /// Amount of worker threads
+    /// </summary>
+    public int Workers => _threads.Length;
+
+    /// <summary>
+    /// Maximum amount of queued calls before callers have to wait
+    /// </summary>
+    public int Capacity { get; }
+
+    /// <summary>
+    /// Amount of calls waiting for a worker
+    /// </summary>
+    public int Pending => _queue.Reader.Count;
+
+    /// <param name="workers">Amount of worker threads</param>
+    /// <param name="capacity">Maximum amount of queued calls before callers have to wait</param>
+    public JvmWorkerPool(int workers, int capacity = 1024)
+    {
+        if (workers < 1)
+        {
+            throw new ArgumentOutOfRangeException(nameof(workers), workers, "At least one worker is required");
+        }
+        if (capacity < 1)
+        {
+            throw new ArgumentOutOfRangeException(nameof(capacity), capacity, "Capacity must be at least one");
+        }
+
+        Capacity = capacity;
+        _queue = Channel.CreateBounded<WorkItem>(new BoundedChannelOptions(capacity)
+        {
+            FullMode = BoundedChannelFullMode.Wait,
+            SingleReader = false,
+            SingleWriter = false,
+        });
+        _threads = new Thread[workers];
+        for (var i = 0; i < workers; i++)
+        {
+            _threads[i] = new Thread(Work)
+            {
+                IsBackground = true,
+                Name = $"Mud JVM Worker {i}"
+            };
+            _threads[i].Start();
+        }
+    }
+
+    private void Work()
+    {
+        var attached = false;
+        try
+        {
+            var reader = _queue.Reader;
+            while (reader.WaitToReadAsync().AsTask().GetAwaiter().GetResult())
+            {
+                while (reader.TryRead(out var item))
+                {
+                    if (!attached)
+                    {
+                        // retried per item, a failed attach fails the item rather than the worker
+                        try
+                        {
+                            Jvm.AttachCurrentThread();
+                            attached = true;
+                        }
+                        catch (Exception e)
+                        {
+                            item.Fail(e);
+                            continue;
+                        }
+                    }
+                    item.Execute();
+                }
+            }
+        }
+        finally
+        {
+            if (attached)
+            {
+                Jvm.DetachCurrentThread();
+            }
+        }
+    }
+
+    /// <summary>
+    /// Queues the function to be run on one of the workers, waits for room in the queue if it is full
+    /// </summary>
+    /// <param name="func">Function making the java calls</param>
+    /// <param name="cancellationToken">Cancels waiting for room in the queue or the call itself if it has not started yet</param>
+    /// <typeparam name="T">Return type of the function</typeparam>
+    /// <returns>The function's result</returns>
+    public async ValueTask<T> Run<T>(Func<T> func, CancellationToken cancellationToken = default)
+    {
+        var item = new WorkItem<T>(func, cancellationToken);
+        try
+        {
+            await _queue.Writer.WriteAsync(item, cancellationToken);
+        }
+        catch
+        {
+            item.Discard();
+            throw;
+        }
+        return await item.Completion.Task;
+    }
+
+    /// <summary>
+    /// Queues the action to be run on one of the workers, waits for room in the queue if it is full
+    /// </summary>
+    /// <param name="action">Action making the java calls</param>
+    /// <param name="cancellationToken">Cancels waiting for room in the queue or the call itself if it has not started yet</param>
+    public async ValueTask Run(Action action, CancellationToken cancellationToken = default)
+    {
+        await Run(() =>
+        {
+            action();
+            return true;
+        }, cancellationToken);
+    }
+
+    /// <summary>
+    /// Queues the function to be run on one of the workers without waiting for room in the queue
+    /// </summary>
+    /// <param name="func">Function making the java calls</param>
+    /// <param name="result">The function's result once it has run</param>
+    /// <param name="cancellationToken">Cancels the call if it has not started yet</param>
+    /// <typeparam name="T">Return type of the function</typeparam>
+    /// <returns>False if the queue is full</returns>
+    public bool TryRun<T>(Func<T> func, out ValueTask<T> result, CancellationToken cancellationToken = default)
+    {
+        var item = new WorkItem<T>(func, cancellationToken);
+        if (!_queue.Writer.TryWrite(item))
+        {
+            item.Discard();
+            result = default;
+            return false;
+        }
+        result = new ValueTask<T>(item.Completion.Task);
+        return true;
+    }
+
+    /// <summary>
+    /// Stops accepting calls, lets the workers finish what is queued and detaches them from the JVM
+    /// </summary>
+    public void Dispose()
+    {
+        if (!_queue.Writer.TryComplete())
+        {
+            return;
+        }
+        foreach (var thread in _threads)
+        {
+            if (thread != Thread.CurrentThread)
+            {
+                thread.Join();
+            }
+        }
+    }
+}
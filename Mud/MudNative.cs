@@ -0,0 +1,64 @@
+using System.Runtime.InteropServices;
+using Mud.Types;
+
+namespace Mud;
+
+/// <summary>
+/// Unmanaged function pointers into the mud clib for the hot call paths,
+/// these skip the DllImport marshalling stubs so arguments can be passed straight from stack memory
+/// </summary>
+internal static unsafe class MudNative
+{
+    private static readonly IntPtr Lib = NativeLibrary.Load("libMud", typeof(MudNative).Assembly, null);
+
+    internal static readonly delegate* unmanaged[Cdecl]<IntPtr, IntPtr, IntPtr, JavaType, JavaVal*, JavaCallResp> CallMethod =
+        (delegate* unmanaged[Cdecl]<IntPtr, IntPtr, IntPtr, JavaType, JavaVal*, JavaCallResp>)NativeLibrary.GetExport(Lib, "mud_call_method");
+
+    internal static readonly delegate* unmanaged[Cdecl]<IntPtr, IntPtr, IntPtr, JavaType, JavaVal*, JavaCallResp> CallStaticMethod =
+        (delegate* unmanaged[Cdecl]<IntPtr, IntPtr, IntPtr, JavaType, JavaVal*, JavaCallResp>)NativeLibrary.GetExport(Lib, "mud_call_static_method");
+
+    internal static readonly delegate* unmanaged[Cdecl]<IntPtr, JavaBatchCall*, nuint, JavaVal*, JavaCallResp*, nuint> CallBatch =
+        (delegate* unmanaged[Cdecl]<IntPtr, JavaBatchCall*, nuint, JavaVal*, JavaCallResp*, nuint>)NativeLibrary.GetExport(Lib, "mud_call_batch");
+
+    internal static readonly delegate* unmanaged[Cdecl]<IntPtr, IntPtr*, nuint, JavaFieldLayout*, nuint, void*, nuint, IntPtr> GetFieldsBulk =
+        (delegate* unmanaged[Cdecl]<IntPtr, IntPtr*, nuint, JavaFieldLayout*, nuint, void*, nuint, IntPtr>)NativeLibrary.GetExport(Lib, "mud_get_fields_bulk");
+
+    internal static readonly delegate* unmanaged[Cdecl]<IntPtr, IntPtr*, nuint, JavaFieldLayout*, nuint, void*, nuint, IntPtr> SetFieldsBulk =
+        (delegate* unmanaged[Cdecl]<IntPtr, IntPtr*, nuint, JavaFieldLayout*, nuint, void*, nuint, IntPtr>)NativeLibrary.GetExport(Lib, "mud_set_fields_bulk");
+
+    internal static readonly delegate* unmanaged[Cdecl]<IntPtr, IntPtr, JavaType, nuint, void*, JavaChunk> IteratorNextChunk =
+        (delegate* unmanaged[Cdecl]<IntPtr, IntPtr, JavaType, nuint, void*, JavaChunk>)NativeLibrary.GetExport(Lib, "mud_iterator_next_chunk");
+
+    internal static readonly delegate* unmanaged[Cdecl]<IntPtr, IntPtr, int*, ulong> IdentityGet =
+        (delegate* unmanaged[Cdecl]<IntPtr, IntPtr, int*, ulong>)NativeLibrary.GetExport(Lib, "mud_identity_get");
+
+    internal static readonly delegate* unmanaged[Cdecl]<IntPtr, JavaVal, JavaType, IntPtr> Box =
+        (delegate* unmanaged[Cdecl]<IntPtr, JavaVal, JavaType, IntPtr>)NativeLibrary.GetExport(Lib, "mud_box");
+
+    internal static readonly delegate* unmanaged[Cdecl]<IntPtr, IntPtr, JavaType, JavaCallResp> Unbox =
+        (delegate* unmanaged[Cdecl]<IntPtr, IntPtr, JavaType, JavaCallResp>)NativeLibrary.GetExport(Lib, "mud_unbox");
+
+    internal static readonly delegate* unmanaged[Cdecl]<IntPtr, IntPtr, JavaType, IntPtr*, long> BoxedLength =
+        (delegate* unmanaged[Cdecl]<IntPtr, IntPtr, JavaType, IntPtr*, long>)NativeLibrary.GetExport(Lib, "mud_boxed_length");
+
+    internal static readonly delegate* unmanaged[Cdecl]<IntPtr, IntPtr, nuint, void*, JavaType, IntPtr> UnboxArray =
+        (delegate* unmanaged[Cdecl]<IntPtr, IntPtr, nuint, void*, JavaType, IntPtr>)NativeLibrary.GetExport(Lib, "mud_unbox_array");
+
+    internal static readonly delegate* unmanaged[Cdecl]<IntPtr, nuint, void*, JavaType, IntPtr> BoxList =
+        (delegate* unmanaged[Cdecl]<IntPtr, nuint, void*, JavaType, IntPtr>)NativeLibrary.GetExport(Lib, "mud_box_list");
+
+    internal static readonly delegate* unmanaged[Cdecl]<IntPtr, IntPtr*, nuint, char*, nuint, int*, nuint> StringsCopyUtf16 =
+        (delegate* unmanaged[Cdecl]<IntPtr, IntPtr*, nuint, char*, nuint, int*, nuint>)NativeLibrary.GetExport(Lib, "mud_strings_copy_utf16");
+
+    internal static readonly delegate* unmanaged[Cdecl]<IntPtr, int, byte> PushLocalFrame =
+        (delegate* unmanaged[Cdecl]<IntPtr, int, byte>)NativeLibrary.GetExport(Lib, "mud_push_local_frame");
+
+    internal static readonly delegate* unmanaged[Cdecl]<IntPtr, IntPtr, IntPtr> PopLocalFrame =
+        (delegate* unmanaged[Cdecl]<IntPtr, IntPtr, IntPtr>)NativeLibrary.GetExport(Lib, "mud_pop_local_frame");
+
+    internal static readonly delegate* unmanaged[Cdecl]<IntPtr, char*, int, IntPtr> StringNewUtf16 =
+        (delegate* unmanaged[Cdecl]<IntPtr, char*, int, IntPtr>)NativeLibrary.GetExport(Lib, "mud_string_new_utf16");
+
+    internal static readonly delegate* unmanaged[Cdecl]<IntPtr, IntPtr, void> ReleaseObj =
+        (delegate* unmanaged[Cdecl]<IntPtr, IntPtr, void>)NativeLibrary.GetExport(Lib, "mud_release_object");
+}
@@ -0,0 +1,210 @@
+using System.Buffers;
+using System.Runtime.InteropServices;
+using Mud.Exceptions;
+using Mud.Types;
+
+namespace Mud;
+
+/// <summary>
+/// Marshals nested primitive arrays, jagged T[][] and rectangular T[,], as one packed buffer of elements in a single native
+/// call rather than a call per row and element. A T[,] becomes a java T[][] and a T[][][] falls back to mapping row by row
+/// </summary>
+internal static class NestedArrays
+{
+    // matches MUD_ARRAY_MAX_RANK
+    private const int MaxRank = 32;
+
+    /// <summary>
+    /// Whether the type is an array of arrays of a java primitive, e.g. double[][]
+    /// </summary>
+    /// <param name="type">The .NET array type</param>
+    /// <param name="rowElemType">Element type of the rows</param>
+    /// <param name="primType">The java primitive type of the row elements</param>
+    internal static bool IsJagged(Type type, out Type rowElemType, out JavaType primType)
+    {
+        rowElemType = type.IsSZArray && type.GetElementType() is { IsSZArray: true } rowType ? rowType.GetElementType()! : typeof(void);
+        primType = JavaType.Object;
+        return rowElemType != typeof(void) && TypeMap.TryGetBlittablePrimitive(rowElemType, out primType);
+    }
+
+    /// <summary>
+    /// Whether the type is a multi-dimensional array of a java primitive, e.g. double[,]
+    /// </summary>
+    /// <param name="type">The .NET array type</param>
+    /// <param name="primType">The java primitive type of the elements</param>
+    internal static bool IsShaped(Type type, out JavaType primType)
+    {
+        primType = JavaType.Object;
+        return type.IsArray && type.GetArrayRank() > 1 && TypeMap.TryGetBlittablePrimitive(type.GetElementType()!, out primType);
+    }
+
+    /// <summary>
+    /// Creates a java array of primitive arrays from the rows of a jagged array, null rows stay null
+    /// </summary>
+    /// <param name="rows">The jagged array</param>
+    /// <param name="type">The java primitive type of the row elements</param>
+    /// <returns>The java array pointer</returns>
+    internal static IntPtr NewJagged(Array rows, JavaType type)
+    {
+        var rowArrs = (Array?[])rows;
+        var lengths = new long[rowArrs.Length];
+        var size = 0;
+        for (var i = 0; i < rowArrs.Length; i++)
+        {
+            lengths[i] = rowArrs[i]?.Length ?? -1;
+            size += rowArrs[i] is { } row ? Buffer.ByteLength(row) : 0;
+        }
+
+        var packed = ArrayPool<byte>.Shared.Rent(Math.Max(size, 1));
+        try
+        {
+            var offset = 0;
+            foreach (var row in rowArrs)
+            {
+                if (row == null)
+                {
+                    continue;
+                }
+                var rowSize = Buffer.ByteLength(row);
+                Buffer.BlockCopy(row, 0, packed, offset, rowSize);
+                offset += rowSize;
+            }
+            return Created(MudInterface.array_new_jagged(Jvm.Env, (nuint)rowArrs.Length, lengths,
+                ref MemoryMarshal.GetArrayDataReference(packed), type));
+        }
+        finally
+        {
+            ArrayPool<byte>.Shared.Return(packed);
+        }
+    }
+
+    /// <summary>
+    /// Creates a nested java array from a multi-dimensional array, whose elements are already laid out in row major order
+    /// </summary>
+    /// <param name="values">The multi-dimensional array</param>
+    /// <param name="type">The java primitive type of the elements</param>
+    /// <returns>The java array pointer</returns>
+    internal static IntPtr NewShaped(Array values, JavaType type)
+    {
+        var dims = new nuint[values.Rank];
+        for (var i = 0; i < dims.Length; i++)
+        {
+            dims[i] = (nuint)values.GetLength(i);
+        }
+        return Created(MudInterface.array_new_shaped(Jvm.Env, (nuint)dims.Length, dims,
+            ref MemoryMarshal.GetArrayDataReference(values), type));
+    }
+
+    /// <summary>
+    /// Creates a nested java array from packed row major values
+    /// </summary>
+    /// <param name="values">Values of the innermost arrays back to back</param>
+    /// <param name="shape">Length of each dimension, the outermost first</param>
+    /// <typeparam name="T">Element type, must share the memory layout of a java primitive</typeparam>
+    /// <returns>The java array pointer</returns>
+    /// <exception cref="ArgumentException">Throws if the shape does not match the amount of values</exception>
+    internal static IntPtr NewShaped<T>(ReadOnlySpan<T> values, ReadOnlySpan<int> shape) where T : unmanaged
+    {
+        if (shape.Length is 0 or > MaxRank)
+        {
+            throw new ArgumentOutOfRangeException(nameof(shape), $"Arrays must have between 1 and {MaxRank} dimensions");
+        }
+        var dims = new nuint[shape.Length];
+        long count = 1;
+        for (var i = 0; i < shape.Length; i++)
+        {
+            if (shape[i] < 0)
+            {
+                throw new ArgumentOutOfRangeException(nameof(shape), "Dimensions cannot be negative");
+            }
+            dims[i] = (nuint)shape[i];
+            count *= shape[i];
+        }
+        if (count != values.Length)
+        {
+            throw new ArgumentException($"Shape holds {count} elements but {values.Length} values were provided", nameof(values));
+        }
+        return Created(MudInterface.array_new_shaped(Jvm.Env, (nuint)dims.Length, dims,
+            ref MemoryMarshal.GetReference(MemoryMarshal.AsBytes(values)), TypeMap.GetBlittablePrimitive(typeof(T))));
+    }
+
+    /// <summary>
+    /// Copies a java array of primitive arrays into a jagged array
+    /// </summary>
+    /// <param name="arr">The java array pointer</param>
+    /// <param name="rowElemType">Element type of the rows</param>
+    /// <param name="type">The java primitive type of the row elements</param>
+    /// <returns>The jagged array</returns>
+    internal static Array ReadJagged(IntPtr arr, Type rowElemType, JavaType type)
+    {
+        var lengths = new long[MudInterface.array_length(Jvm.Env, arr)];
+        Jvm.ThrowException(MudInterface.array_jagged_lengths(Jvm.Env, arr, (nuint)lengths.Length, lengths));
+        var elemSize = ElementSize(type);
+        long size = 0;
+        foreach (var length in lengths)
+        {
+            size += Math.Max(length, 0) * elemSize;
+        }
+
+        var packed = ArrayPool<byte>.Shared.Rent((int)Math.Max(size, 1));
+        try
+        {
+            Jvm.ThrowException(MudInterface.array_get_jagged(Jvm.Env, arr, (nuint)lengths.Length, lengths,
+                ref MemoryMarshal.GetArrayDataReference(packed), type));
+            var rows = Array.CreateInstance(rowElemType.MakeArrayType(), lengths.Length);
+            var offset = 0;
+            for (var i = 0; i < lengths.Length; i++)
+            {
+                if (lengths[i] < 0)
+                {
+                    continue;
+                }
+                var row = Array.CreateInstance(rowElemType, (int)lengths[i]);
+                var rowSize = (int)lengths[i] * elemSize;
+                Buffer.BlockCopy(packed, offset, row, 0, rowSize);
+                offset += rowSize;
+                rows.SetValue(row, i);
+            }
+            return rows;
+        }
+        finally
+        {
+            ArrayPool<byte>.Shared.Return(packed);
+        }
+    }
+
+    /// <summary>
+    /// Copies a nested java array straight into a multi-dimensional array
+    /// </summary>
+    /// <param name="arr">The java array pointer</param>
+    /// <param name="arrayType">The multi-dimensional array type</param>
+    /// <param name="type">The java primitive type of the elements</param>
+    /// <returns>The multi-dimensional array</returns>
+    /// <exception cref="JavaException">Throws if the java array is not rectangular or has null rows</exception>
+    internal static Array ReadShaped(IntPtr arr, Type arrayType, JavaType type)
+    {
+        var dims = new nuint[arrayType.GetArrayRank()];
+        Jvm.ThrowException(MudInterface.array_shape(Jvm.Env, arr, (nuint)dims.Length, dims));
+        var values = Array.CreateInstance(arrayType.GetElementType()!, dims.Select(d => (int)d).ToArray());
+        Jvm.ThrowException(MudInterface.array_get_shaped(Jvm.Env, arr, (nuint)dims.Length, dims,
+            ref MemoryMarshal.GetArrayDataReference(values), type));
+        return values;
+    }
+
+    private static int ElementSize(JavaType type) => type switch
+    {
+        JavaType.Bool or JavaType.Byte => 1,
+        JavaType.Char or JavaType.Short => 2,
+        JavaType.Int or JavaType.Float => 4,
+        _ => 8
+    };
+
+    private static IntPtr Created(IntPtr arr)
+    {
+        if (arr == IntPtr.Zero)
+        {
+            Jvm.ThrowException(MudInterface.check_exception(Jvm.Env));
+        }
+        return arr;
+    }
+}
@@ -0,0 +1,306 @@
+using Mud.Exceptions;
+using Mud.Types;
+
+namespace Mud;
+
+/// <summary>
+/// How an argument is converted to the parameter type of the overload a by-name call resolved to
+/// </summary>
+internal enum ArgConversion : byte
+{
+    None,
+    /// <summary>
+    /// Primitive widened to a larger primitive, e.g. int to long
+    /// </summary>
+    Widen,
+    /// <summary>
+    /// Primitive boxed into its wrapper class, e.g. int to java.lang.Integer for an Object parameter
+    /// </summary>
+    Box
+}
+
+/// <summary>
+/// The method a by-name call with a given name and argument type vector binds to, cached by ClassInfo so repeated calls of
+/// the same shape skip resolution. A target without a method records that nothing matched, so the miss isn't retried
+/// </summary>
+internal sealed class DynamicTarget
+{
+    internal IntPtr Method { get; }
+
+    /// <summary>
+    /// The resolved method's java type signature
+    /// </summary>
+    internal string Signature { get; }
+
+    /// <summary>
+    /// The resolved method's return type, a void call may bind to a method whose result it discards
+    /// </summary>
+    internal JavaType ReturnType { get; }
+
+    private readonly CustomType[]? _paramTypes;
+    private readonly ArgConversion[]? _conversions;
+    private readonly string? _missing;
+
+    internal DynamicTarget(IntPtr method, string signature, JavaType returnType, CustomType[]? paramTypes = null,
+        ArgConversion[]? conversions = null)
+    {
+        Method = method;
+        Signature = signature;
+        ReturnType = returnType;
+        _paramTypes = paramTypes;
+        _conversions = conversions;
+    }
+
+    private DynamicTarget(string signature, string missing)
+    {
+        Signature = signature;
+        _missing = missing;
+    }
+
+    internal static DynamicTarget Missing(string signature, string message) => new(signature, message);
+
+    /// <exception cref="MemberNotFoundException">Thrown when no method matched the call</exception>
+    internal DynamicTarget ThrowIfMissing(ClassInfo cls, string method)
+    {
+        if (_missing != null)
+        {
+            throw new MemberNotFoundException(cls.ClassPath, method, Signature, _missing);
+        }
+        return this;
+    }
+
+    /// <summary>
+    /// Converts the arguments to the method's parameter types, boxed arguments are boxed natively when they are mapped
+    /// </summary>
+    /// <param name="args">The call's arguments</param>
+    /// <returns>The arguments as is when none need converting</returns>
+    internal TypedArg[] Convert(TypedArg[] args)
+    {
+        if (_conversions == null)
+        {
+            return args;
+        }
+        var converted = new TypedArg[args.Length];
+        for (var i = 0; i < args.Length; i++)
+        {
+            converted[i] = _conversions[i] switch
+            {
+                // char has no conversion to the floating point types, so it goes through int
+                ArgConversion.Widen => new TypedArg(System.Convert.ChangeType(args[i].Val is char c ? (int)c : args[i].Val,
+                    WidenedType(_paramTypes![i].Type)), _paramTypes[i]),
+                ArgConversion.Box => new TypedArg(args[i].Val, new CustomType(TypeMap.BoxClassPath(args[i].Type.Type))),
+                _ => args[i]
+            };
+        }
+        return converted;
+    }
+
+    private static Type WidenedType(JavaType type) => type switch
+    {
+        JavaType.Short => typeof(short),
+        JavaType.Int => typeof(int),
+        JavaType.Long => typeof(long),
+        JavaType.Float => typeof(float),
+        _ => typeof(double)
+    };
+}
+
+/// <summary>
+/// Finds the overload a by-name call binds to when no method matches its argument types exactly. Candidates come from
+/// java.lang.reflect and are picked in javac's phases: methods applicable without boxing over those that need boxing, then
+/// the most specific parameter types within the first phase that has any. Unboxing and varargs are not considered
+/// </summary>
+internal static class OverloadResolver
+{
+    private const int StaticModifier = 0x0008;
+    private static readonly CustomType ClassType = new("java/lang/Class");
+    private static readonly CustomType MethodArray = new(new CustomType("java/lang/reflect/Method"));
+    private static readonly CustomType ClassArray = new(ClassType);
+
+    /// <param name="Phase">0 when the method applies with widening alone, 1 when an argument must be boxed</param>
+    private sealed record Candidate(string Signature, CustomType[] ParamTypes, IntPtr[] ParamClasses, ArgConversion[] Conversions, int Phase);
+
+    /// <summary>
+    /// Resolves the method the call binds to, the exact signature is tried first so non public methods are still found
+    /// </summary>
+    /// <param name="cls">Class the method is called on</param>
+    /// <param name="method">Method name</param>
+    /// <param name="signature">Signature made from the requested return type and the argument types</param>
+    /// <param name="returnType">The requested return type</param>
+    /// <param name="args">The call's arguments</param>
+    /// <param name="isStatic">Whether the method is static</param>
+    internal static DynamicTarget Resolve(ClassInfo cls, string method, string signature, CustomType returnType, TypedArg[] args,
+        bool isStatic)
+    {
+        if (cls.TryGetMethodPtr(method, signature, isStatic, out var exact))
+        {
+            return new DynamicTarget(exact, signature, returnType.Type);
+        }
+
+        // the reflected methods and classes are only needed while ranking
+        using var scope = Jvm.Scope(64);
+        var argClasses = args.Select(a => a.Type.Type == JavaType.Object ? ClassOf(a.Type.TypeSignature) : IntPtr.Zero).ToArray();
+        var classCls = Jvm.GetClassInfo("java/lang/Class");
+        var candidates = new List<Candidate>();
+        foreach (var reflected in classCls.Call<BoundObject[]>(cls.Cls, "getMethods", MethodArray, Array.Empty<TypedArg>(), false))
+        {
+            if (reflected.Call<string>("getName") != method ||
+                (reflected.Call<int>("getModifiers") & StaticModifier) != 0 != isStatic ||
+                reflected.Call<int>("getParameterCount") != args.Length ||
+                reflected.Call<bool>("isBridge"))
+            {
+                continue;
+            }
+            var returnSig = TypeMap.NameSignature(reflected.Call<BoundObject>("getReturnType", ClassType, Array.Empty<TypedArg>())
+                .Call<string>("getName"));
+            // a void call discards whatever the method returns
+            if (returnType.Type switch
+                {
+                    JavaType.Void => false,
+                    JavaType.Object => returnSig.Length == 1,
+                    _ => returnSig != returnType.TypeSignature
+                })
+            {
+                continue;
+            }
+            var paramClasses = reflected.Call<BoundObject[]>("getParameterTypes", ClassArray, Array.Empty<TypedArg>());
+            if (Rank(args, argClasses, paramClasses, returnSig) is { } candidate)
+            {
+                candidates.Add(candidate);
+            }
+        }
+
+        var best = MostSpecific(candidates);
+        if (best == null)
+        {
+            return DynamicTarget.Missing(signature,
+                $"No method {method} on class {cls.ClassPath} accepts arguments of type signature {signature}");
+        }
+        var conversions = best.Conversions.Any(c => c != ArgConversion.None) ? best.Conversions : null;
+        return new DynamicTarget(cls.GetMethodPtr(method, best.Signature, isStatic), best.Signature,
+            TypeFromSignature(best.Signature[(best.Signature.IndexOf(')') + 1)..]).Type, best.ParamTypes, conversions);
+    }
+
+    private static Candidate? Rank(TypedArg[] args, IntPtr[] argClasses, BoundObject[] paramClasses, string returnSig)
+    {
+        var paramTypes = new CustomType[args.Length];
+        var paramPtrs = new IntPtr[args.Length];
+        var conversions = new ArgConversion[args.Length];
+        var phase = 0;
+        var signature = "(";
+        for (var i = 0; i < args.Length; i++)
+        {
+            var paramSig = TypeMap.NameSignature(paramClasses[i].Call<string>("getName"));
+            signature += paramSig;
+            paramPtrs[i] = ((IBoundObject)paramClasses[i]).Jobj;
+            paramTypes[i] = TypeFromSignature(paramSig);
+            var argType = args[i].Type;
+            if (argType.TypeSignature == paramSig)
+            {
+                continue;
+            }
+            if (argType.Type != JavaType.Object)
+            {
+                if (paramTypes[i].Type != JavaType.Object)
+                {
+                    if (!Widens(argType.Type, paramTypes[i].Type))
+                    {
+                        return null;
+                    }
+                    conversions[i] = ArgConversion.Widen;
+                    continue;
+                }
+                if (!Assignable(ClassOf(TypeMap.BoxClassPath(argType.Type)), paramPtrs[i]))
+                {
+                    return null;
+                }
+                conversions[i] = ArgConversion.Box;
+                phase = 1;
+                continue;
+            }
+            // a null can be passed to any reference type
+            if (paramTypes[i].Type != JavaType.Object || (args[i].Val != null && !Assignable(argClasses[i], paramPtrs[i])))
+            {
+                return null;
+            }
+        }
+        return new Candidate(signature + ")" + returnSig, paramTypes, paramPtrs, conversions, phase);
+    }
+
+    /// <summary>
+    /// The candidate of the earliest phase whose parameters all fit those of the phase's other candidates
+    /// </summary>
+    private static Candidate? MostSpecific(List<Candidate> candidates)
+    {
+        if (candidates.Count == 0)
+        {
+            return null;
+        }
+        var phase = candidates.Min(c => c.Phase);
+        Candidate? best = null;
+        foreach (var candidate in candidates.Where(c => c.Phase == phase).OrderBy(c => c.Signature, StringComparer.Ordinal))
+        {
+            if (best == null || MoreSpecific(candidate, best))
+            {
+                best = candidate;
+            }
+        }
+        return best;
+    }
+
+    private static bool MoreSpecific(Candidate a, Candidate b)
+    {
+        for (var i = 0; i < a.ParamTypes.Length; i++)
+        {
+            var (aType, bType) = (a.ParamTypes[i].Type, b.ParamTypes[i].Type);
+            var fits = aType == JavaType.Object
+                ? bType == JavaType.Object && Assignable(a.ParamClasses[i], b.ParamClasses[i])
+                : aType == bType || Widens(aType, bType);
+            if (!fits)
+            {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    private static bool Assignable(IntPtr sub, IntPtr sup) =>
+        sub != IntPtr.Zero && MudInterface.is_assignable_from(Jvm.Env, sub, sup);
+
+    /// <summary>
+    /// Primitive widening conversions allowed on method invocation
+    /// </summary>
+    private static bool Widens(JavaType from, JavaType to) => from switch
+    {
+        JavaType.Byte => to is JavaType.Short or JavaType.Int or JavaType.Long or JavaType.Float or JavaType.Double,
+        JavaType.Short or JavaType.Char => to is JavaType.Int or JavaType.Long or JavaType.Float or JavaType.Double,
+        JavaType.Int => to is JavaType.Long or JavaType.Float or JavaType.Double,
+        JavaType.Long => to is JavaType.Float or JavaType.Double,
+        JavaType.Float => to is JavaType.Double,
+        _ => false
+    };
+
+    /// <summary>
+    /// Class of an argument type, zero when it can't be found from the system class loader
+    /// </summary>
+    private static IntPtr ClassOf(string signature)
+    {
+        var classPath = signature.StartsWith('L') ? signature[1..^1] : signature;
+        return Jvm.TryGetClassInfo(classPath, out var info) ? info.Cls : IntPtr.Zero;
+    }
+
+    private static CustomType TypeFromSignature(string signature) => signature switch
+    {
+        "I" => new(JavaType.Int),
+        "Z" => new(JavaType.Bool),
+        "B" => new(JavaType.Byte),
+        "C" => new(JavaType.Char),
+        "S" => new(JavaType.Short),
+        "J" => new(JavaType.Long),
+        "F" => new(JavaType.Float),
+        "D" => new(JavaType.Double),
+        "V" => new(JavaType.Void),
+        _ when signature.StartsWith('L') => new(signature[1..^1]),
+        _ => new(signature)
+    };
+}
@@ -0,0 +1,83 @@
+using System.Text.Json;
+
+namespace Mud;
+
+/// <summary>
+/// A method or field to resolve ahead of its first use
+/// </summary>
+/// <param name="Name">Member name</param>
+/// <param name="Signature">The member's Java type signature</param>
+/// <param name="IsStatic">Whether the member is static</param>
+public record PreloadMember(string Name, string Signature, bool IsStatic);
+
+/// <summary>
+/// A class and the members of it to resolve ahead of their first use
+/// </summary>
+/// <param name="ClassPath">The java class path</param>
+/// <param name="Methods">Methods to resolve</param>
+/// <param name="Fields">Fields to resolve</param>
+public record PreloadClass(string ClassPath, IReadOnlyList<PreloadMember> Methods, IReadOnlyList<PreloadMember> Fields);
+
+/// <summary>
+/// Lists the classes, members and bound interfaces a process uses so they can be resolved in parallel when the JVM starts
+/// rather than on the first requests that need them. A manifest is recorded from a warmed up process with Record
+/// </summary>
+public sealed class PreloadManifest
+{
+    private static readonly JsonSerializerOptions JsonOptions = new()
+    {
+        PropertyNamingPolicy = JsonNamingPolicy.CamelCase,
+        WriteIndented = true
+    };
+
+    /// <summary>
+    /// Classes to resolve along with their members
+    /// </summary>
+    public IReadOnlyList<PreloadClass> Classes { get; init; } = Array.Empty<PreloadClass>();
+
+    /// <summary>
+    /// Assembly qualified names of the bound interfaces whose implementations are generated up front
+    /// </summary>
+    public IReadOnlyList<string> BoundInterfaces { get; init; } = Array.Empty<string>();
+
+    /// <summary>
+    /// Records every class, method and field resolved so far along with every bound interface generated so far
+    /// </summary>
+    public static PreloadManifest Record()
+    {
+        Jvm.EnsureInit();
+        return new PreloadManifest
+        {
+            Classes = Jvm.ClassInfos.Values
+                .Select(c => new PreloadClass(c.ClassPath,
+                    c.ResolvedMethods.Select(m => new PreloadMember(m.Key.Name, m.Key.Signature, m.Value)).ToList(),
+                    c.ResolvedFields.Select(f => new PreloadMember(f.Key.Name, f.Key.Signature, f.Value)).ToList()))
+                .OrderBy(c => c.ClassPath, StringComparer.Ordinal)
+                .ToList(),
+            BoundInterfaces = TypeGen.BuiltTargets()
+                .Select(t => t.AssemblyQualifiedName!)
+                .OrderBy(n => n, StringComparer.Ordinal)
+                .ToList()
+        };
+    }
+
+    /// <summary>
+    /// Writes the manifest as json
+    /// </summary>
+    /// <param name="path">File to write to</param>
+    public void Save(string path)
+    {
+        using var stream = File.Create(path);
+        JsonSerializer.Serialize(stream, this, JsonOptions);
+    }
+
+    /// <summary>
+    /// Reads a manifest written by Save
+    /// </summary>
+    /// <param name="path">File to read from</param>
+    public static PreloadManifest Load(string path)
+    {
+        using var stream = File.OpenRead(path);
+        return JsonSerializer.Deserialize<PreloadManifest>(stream, JsonOptions) ?? new PreloadManifest();
+    }
+}
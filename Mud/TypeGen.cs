@@ -13,6 +13,26 @@ internal class TypeGen
     private static Dictionary<Type, Type> CachedTypes { get; } = new();
 
     public static Type Build(Type target)
+    {
+        // types are built at most once even when first requested from multiple threads
+        lock (CachedTypes)
+        {
+            return BuildLocked(target);
+        }
+    }
+
+    /// <summary>
+    /// The bound interfaces an implementation has been generated for so far
+    /// </summary>
+    internal static Type[] BuiltTargets()
+    {
+        lock (CachedTypes)
+        {
+            return CachedTypes.Keys.ToArray();
+        }
+    }
+
+    private static Type BuildLocked(Type target)
     {
         if (CachedTypes.TryGetValue(target, out var builtType))
         {
@@ -35,79 +55,97 @@ internal class TypeGen
             GenProp(type, p, target);
         }
 
+        var callSites = new List<(string Field, CallSite Site)>();
         foreach (var m in target.GetMethods())
         {
+            if (m.IsSpecialName)
+            {
+                continue;
+            }
             var method = type.DefineMethod(
                 m.Name,
                 MethodAttributes.Public | MethodAttributes.Virtual,
                 m.ReturnType,
                 m.GetParameters().Select(p => p.ParameterType).ToArray());
-            GenMethod(method, m, target);
+            var site = CallSite.For(target, m, GetMemberName(m));
+            var siteField = type.DefineField($"<site>{callSites.Count}_{m.Name}", typeof(CallSite),
+                FieldAttributes.Private | FieldAttributes.Static);
+            callSites.Add((siteField.Name, site));
+            GenMethod(method, m, siteField, site);
         }
 
         builtType = type.CreateType()!;
+        foreach (var (field, site) in callSites)
+        {
+            builtType.GetField(field, BindingFlags.NonPublic | BindingFlags.Static)!.SetValue(null, site);
+        }
         CachedTypes[target] = builtType;
         return builtType;
     }
 
 
-    private static void GenMethod(MethodBuilder method, MethodInfo methodInfo, Type target)
+    /// <summary>
+    /// Emits a method body that forwards straight to its precompiled call site, up to CallSite.MaxTypedArgs arguments are
+    /// passed as they are rather than boxed into an array
+    /// </summary>
+    private static void GenMethod(MethodBuilder method, MethodInfo methodInfo, FieldInfo siteField, CallSite site)
     {
-        var returnType = methodInfo.ReturnType;
-        var returnCustom = TypeMap.MapToType(returnType, methodInfo.GetCustomAttributes<JavaTypeAttribute>().LastOrDefault()?.ClassPath);
-
         var isStatic = methodInfo.GetCustomAttributes<JavaStaticAttribute>().LastOrDefault() != null;
-        Type targetCls;
-        BindingFlags bindingFlags;
+        var isVoid = methodInfo.ReturnType == typeof(void);
+        var parameters = methodInfo.GetParameters();
+        var typed = !site.IsDynamic && parameters.Length <= CallSite.MaxTypedArgs;
+
         MethodInfo callMethod;
-        
-        if (isStatic)
-        {
-            targetCls = typeof(ClassInfo<>).MakeGenericType(target);
-            bindingFlags = BindingFlags.NonPublic | BindingFlags.Static;
-        }
-        else
+        if (typed)
         {
-            targetCls = typeof(BoundObject);
-            bindingFlags = BindingFlags.Public | BindingFlags.Instance;
-        }
-        
-        
-        if (returnCustom.Type is JavaType.Void)
-        {
-            callMethod = targetCls.GetMethod("Call", 0, bindingFlags,
-                null, new[] { typeof(string), typeof(TypedArg[]) }, null)!;
+            var name = (isStatic, isVoid) switch
+            {
+                (true, true) => nameof(CallSite.InvokeStaticVoid),
+                (true, false) => nameof(CallSite.InvokeStatic),
+                (false, true) => nameof(CallSite.InvokeVoid),
+                (false, false) => nameof(CallSite.Invoke)
+            };
+            var paramTypes = parameters.Select(p => p.ParameterType);
+            var typeArgs = (isVoid ? paramTypes : paramTypes.Prepend(methodInfo.ReturnType)).ToArray();
+            var paramCount = parameters.Length + (isStatic ? 0 : 1);
+            callMethod = typeof(CallSite).GetMethods(BindingFlags.Public | BindingFlags.Instance)
+                .Single(m => m.Name == name && m.GetGenericArguments().Length == typeArgs.Length && m.GetParameters().Length == paramCount);
+            if (typeArgs.Length != 0)
+            {
+                callMethod = callMethod.MakeGenericMethod(typeArgs);
+            }
         }
         else
         {
-
-            callMethod = targetCls
-                .GetMethod("Call", 1, bindingFlags, null,
-                    new[] { typeof(string), typeof(CustomType), typeof(TypedArg[]) }, null);
-            if (callMethod == null)
+            var argTypes = isStatic ? new[] { typeof(object[]) } : new[] { typeof(IBoundObject), typeof(object[]) };
+            callMethod = typeof(CallSite).GetMethod(isStatic ? nameof(CallSite.InvokeStatic) : nameof(CallSite.Invoke),
+                isVoid ? 0 : 1, BindingFlags.Public | BindingFlags.Instance, null, argTypes, null)!;
+            if (!isVoid)
             {
-                _ = 0;
+                callMethod = callMethod.MakeGenericMethod(methodInfo.ReturnType);
             }
-            callMethod = callMethod.MakeGenericMethod(returnType);
-        
         }
 
         var generator = method.GetILGenerator();
-
+        generator.Emit(OpCodes.Ldsfld, siteField);
         if (!isStatic)
         {
             generator.Emit(OpCodes.Ldarg_0);
         }
-        generator.Emit(OpCodes.Ldstr, GetMemberName(methodInfo));
 
-        if (returnCustom.Type is not JavaType.Void)
+        if (typed)
         {
-            EmitCustomType(generator, returnCustom);
+            for (var i = 0; i < parameters.Length; i++)
+            {
+                EmitLdarg(generator, i + 1);
+            }
+        }
+        else
+        {
+            EmitArgsArr(generator, methodInfo);
         }
 
-        EmitParamsArr(generator, methodInfo);
-
-        generator.Emit(OpCodes.Call, callMethod);
+        generator.Emit(OpCodes.Callvirt, callMethod);
         generator.Emit(OpCodes.Ret);
     }
 
@@ -215,49 +253,50 @@ internal class TypeGen
         generator.Emit(OpCodes.Newobj, ctor);
     } 
     
-    private static void EmitParamsArr(ILGenerator generator, MethodBase method)
+    /// <summary>
+    /// Emits an object array of the method's arguments, the java types are already known by the call site
+    /// </summary>
+    private static void EmitArgsArr(ILGenerator generator, MethodBase method)
     {
         var parameters = method.GetParameters();
         EmitInt(generator, parameters.Length);
-        generator.Emit(OpCodes.Newarr, typeof(TypedArg));
+        generator.Emit(OpCodes.Newarr, typeof(object));
 
         for (var i = 0; i < parameters.Length; i++)
         {
             generator.Emit(OpCodes.Dup);
-            var param = parameters[i];
-            // load param index onto stacks
             EmitInt(generator, i);
-
-            // load arg onto stack
-            switch (i)
+            EmitLdarg(generator, i + 1);
+            if (parameters[i].ParameterType.IsValueType)
             {
-                case 0:
-                    generator.Emit(OpCodes.Ldarg_1);
-                    break;
-                case 1:
-                    generator.Emit(OpCodes.Ldarg_2);
-                    break;
-                case 2:
-                    generator.Emit(OpCodes.Ldarg_3);
-                    break;
-                default:
-                    generator.Emit(OpCodes.Ldarg, i);
-                    break;
+                generator.Emit(OpCodes.Box, parameters[i].ParameterType);
             }
-
-            // box the value if the parameter is a value type
-            if (param.ParameterType.IsValueType)
-            {
-                generator.Emit(OpCodes.Box, param.ParameterType);
-            }
-            var paramCustom = TypeMap.MapToType(param.ParameterType, param.GetCustomAttribute<JavaTypeAttribute>()?.ClassPath);
-            EmitTypedArg(generator, paramCustom);
-
-            // set the value into the array
             generator.Emit(OpCodes.Stelem_Ref);
         }
     }
-    
+
+    private static void EmitLdarg(ILGenerator generator, int index)
+    {
+        switch (index)
+        {
+            case 0:
+                generator.Emit(OpCodes.Ldarg_0);
+                break;
+            case 1:
+                generator.Emit(OpCodes.Ldarg_1);
+                break;
+            case 2:
+                generator.Emit(OpCodes.Ldarg_2);
+                break;
+            case 3:
+                generator.Emit(OpCodes.Ldarg_3);
+                break;
+            default:
+                generator.Emit(OpCodes.Ldarg_S, (byte)index);
+                break;
+        }
+    }
+
     private static void EmitInt(ILGenerator generator, int val)
     {
         if (val > 8)
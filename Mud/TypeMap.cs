@@ -1,5 +1,6 @@
 using System.Data;
 using System.Reflection;
+using System.Runtime.InteropServices;
 using Mud.Exceptions;
 using Mud.Types;
 
@@ -42,6 +43,25 @@ internal static class TypeMap
         return GenSignature(val.Type);  
     } 
 
+    /// <summary>
+    /// Generates the Java Signature string of a class name as Class.getName returns it, e.g. int, java.lang.String or [D
+    /// </summary>
+    /// <param name="name">Primitive name, class path or array descriptor</param>
+    internal static string NameSignature(string name) => name switch
+    {
+        "int" => "I",
+        "long" => "J",
+        "boolean" => "Z",
+        "byte" => "B",
+        "short" => "S",
+        "char" => "C",
+        "float" => "F",
+        "double" => "D",
+        "void" or "Void" => "V",
+        _ when name.StartsWith('[') => name.Replace('.', '/'),
+        _ => $"L{name.Replace('.', '/')};"
+    };
+
     /// <summary>
     /// Generates the Java Signature string based off the return type and the type of the arguments
     /// </summary>
@@ -147,9 +167,24 @@ internal static class TypeMap
         }
 
 
+        if (TryGetBoxedPrimitive(type, out var boxedType))
+        {
+            return new CustomType(BoxClassPath(boxedType));
+        }
+        if (TryGetPrimitiveList(type, out _, out _))
+        {
+            return new CustomType("java/util/List");
+        }
+
         if (type.IsArray)
         {
-            return new CustomType(MapToType(type.GetElementType()!, null));
+            // multi-dimensional arrays are java arrays nested once per dimension
+            var arrType = new CustomType(MapToType(type.GetElementType()!, null));
+            for (var i = 1; i < type.GetArrayRank(); i++)
+            {
+                arrType = new CustomType(arrType);
+            }
+            return arrType;
         }
         
         if (type == typeof(string))
@@ -168,6 +203,140 @@ internal static class TypeMap
     }
     
     
+    /// <summary>
+    /// Class path of the java class boxing the primitive, e.g. java/lang/Integer for an int
+    /// </summary>
+    /// <param name="type">The java primitive type</param>
+    internal static string BoxClassPath(JavaType type) => type switch
+    {
+        JavaType.Int => "java/lang/Integer",
+        JavaType.Bool => "java/lang/Boolean",
+        JavaType.Byte => "java/lang/Byte",
+        JavaType.Char => "java/lang/Character",
+        JavaType.Short => "java/lang/Short",
+        JavaType.Long => "java/lang/Long",
+        JavaType.Float => "java/lang/Float",
+        _ => "java/lang/Double"
+    };
+
+    /// <summary>
+    /// Whether the type is a nullable java primitive, e.g. int?, which maps to its java boxing class
+    /// </summary>
+    /// <param name="type">.NET type</param>
+    /// <param name="javaType">The boxed java primitive type</param>
+    internal static bool TryGetBoxedPrimitive(Type type, out JavaType javaType)
+    {
+        javaType = JavaType.Object;
+        return Nullable.GetUnderlyingType(type) is { } underlying && TryGetBlittablePrimitive(underlying, out javaType);
+    }
+
+    /// <summary>
+    /// Whether the java type is one of the boxing classes, e.g. java.lang.Integer
+    /// </summary>
+    /// <param name="type">The java type</param>
+    /// <param name="javaType">The boxed java primitive type</param>
+    internal static bool TryGetBoxedPrimitive(CustomType type, out JavaType javaType)
+    {
+        javaType = type.ClassPath switch
+        {
+            "java/lang/Integer" => JavaType.Int,
+            "java/lang/Boolean" => JavaType.Bool,
+            "java/lang/Byte" => JavaType.Byte,
+            "java/lang/Character" => JavaType.Char,
+            "java/lang/Short" => JavaType.Short,
+            "java/lang/Long" => JavaType.Long,
+            "java/lang/Float" => JavaType.Float,
+            "java/lang/Double" => JavaType.Double,
+            _ => JavaType.Object
+        };
+        return javaType != JavaType.Object;
+    }
+
+    /// <summary>
+    /// Whether the type is a list of java primitives, e.g. List&lt;double&gt;, which maps to a java.util.List of boxes
+    /// </summary>
+    /// <param name="type">.NET type, List, IList or IReadOnlyList</param>
+    /// <param name="elemType">Element type of the list</param>
+    /// <param name="javaType">The java primitive type of the elements</param>
+    internal static bool TryGetPrimitiveList(Type type, out Type elemType, out JavaType javaType)
+    {
+        elemType = typeof(void);
+        javaType = JavaType.Object;
+        if (!type.IsGenericType)
+        {
+            return false;
+        }
+        var generic = type.GetGenericTypeDefinition();
+        if (generic != typeof(List<>) && generic != typeof(IList<>) && generic != typeof(IReadOnlyList<>))
+        {
+            return false;
+        }
+        elemType = type.GetGenericArguments()[0];
+        return TryGetBlittablePrimitive(elemType, out javaType);
+    }
+
+    /// <summary>
+    /// Whether the type implements a list of java primitives, e.g. a double[] or a ReadOnlyCollection&lt;double&gt;
+    /// through IList&lt;double&gt;, so a value of it can be passed for a java.util.List
+    /// </summary>
+    /// <param name="type">Runtime type of the value</param>
+    /// <param name="elemType">Element type of the list</param>
+    /// <param name="javaType">The java primitive type of the elements</param>
+    internal static bool TryGetImplementedPrimitiveList(Type type, out Type elemType, out JavaType javaType)
+    {
+        if (TryGetPrimitiveList(type, out elemType, out javaType))
+        {
+            return true;
+        }
+        foreach (var iface in type.GetInterfaces())
+        {
+            if (iface.IsGenericType && TryGetPrimitiveList(iface, out elemType, out javaType))
+            {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    /// <summary>
+    /// Gets the java primitive whose array elements share the memory layout of the provided .NET type,
+    /// allowing arrays of it to be copied to/from the JVM in bulk
+    /// </summary>
+    /// <param name="type">.NET element type</param>
+    /// <param name="javaType">The matching java primitive type</param>
+    /// <returns>Whether the type can be bulk copied</returns>
+    internal static bool TryGetBlittablePrimitive(Type type, out JavaType javaType)
+    {
+        javaType = Type.GetTypeCode(type) switch
+        {
+            TypeCode.Int32 => JavaType.Int,
+            TypeCode.Boolean => JavaType.Bool,
+            TypeCode.Byte => JavaType.Byte,
+            TypeCode.Char => JavaType.Char,
+            TypeCode.Int16 => JavaType.Short,
+            TypeCode.Int64 => JavaType.Long,
+            TypeCode.Single => JavaType.Float,
+            TypeCode.Double => JavaType.Double,
+            _ => JavaType.Object
+        };
+        return javaType is not JavaType.Object && !type.IsEnum;
+    }
+
+    /// <summary>
+    /// Gets the java primitive whose array elements share the memory layout of the provided .NET type
+    /// </summary>
+    /// <param name="type">.NET element type</param>
+    /// <returns>The matching java primitive type</returns>
+    /// <exception cref="ConstraintException">Throws if the type does not match the layout of a java primitive</exception>
+    internal static JavaType GetBlittablePrimitive(Type type)
+    {
+        if (!TryGetBlittablePrimitive(type, out var javaType))
+        {
+            throw new ConstraintException($"Type {type.FullName ?? type.Name} does not match the memory layout of a java primitive");
+        }
+        return javaType;
+    }
+
     /// <summary>
     /// Maps the JavaVal union to it's respective .NET counterpart
     /// </summary>
@@ -190,33 +359,94 @@ internal static class TypeMap
                 return Jvm.ExtractStr(javaVal.Object);
             }
 
-            var objCls = Jvm.GetObjClass(javaVal.Object);
+            if (NestedArrays.IsJagged(valType, out var rowElemType, out var rowType))
+            {
+                var jagged = NestedArrays.ReadJagged(javaVal.Object, rowElemType, rowType);
+                MudInterface.release_obj(Jvm.Env, javaVal.Object);
+                return jagged;
+            }
+
+            if (valType.IsArray && valType.GetArrayRank() > 1)
+            {
+                if (!NestedArrays.IsShaped(valType, out var shapedType))
+                {
+                    throw new ConstraintException($"Only multi-dimensional arrays of java primitives can be mapped, not {valType.FullName}");
+                }
+                var shaped = NestedArrays.ReadShaped(javaVal.Object, valType, shapedType);
+                MudInterface.release_obj(Jvm.Env, javaVal.Object);
+                return shaped;
+            }
+
+            if (TryGetBoxedPrimitive(valType, out var boxedType))
+            {
+                try
+                {
+                    return BoxedPrimitives.Unbox(javaVal.Object, boxedType);
+                }
+                finally
+                {
+                    MudInterface.release_obj(Jvm.Env, javaVal.Object);
+                }
+            }
+
+            if (TryGetPrimitiveList(valType, out var listElemType, out var listType))
+            {
+                try
+                {
+                    return BoxedPrimitives.ReadList(javaVal.Object, listElemType, listType);
+                }
+                finally
+                {
+                    MudInterface.release_obj(Jvm.Env, javaVal.Object);
+                }
+            }
 
             if (valType.IsArray)
             {
-                var length = MudInterface.array_length(Jvm.Instance.Env, javaVal.Object);
-                var arr = Array.CreateInstance(valType.GetElementType()!, length);
-                var arrElemType = MapToType(valType.GetElementType()!, null);
+                var elemType = valType.GetElementType()!;
+                if (TryGetBlittablePrimitive(elemType, out var primType))
+                {
+                    // primitive arrays are copied straight into the .NET array's backing memory, arrays and
+                    // collections of boxes are unboxed into it
+                    try
+                    {
+                        return BoxedPrimitives.ReadArray(javaVal.Object, elemType, primType);
+                    }
+                    finally
+                    {
+                        MudInterface.release_obj(Jvm.Env, javaVal.Object);
+                    }
+                }
+                var length = MudInterface.array_length(Jvm.Env, javaVal.Object);
+                var arr = Array.CreateInstance(elemType, length);
+                
+                var arrElemType = MapToType(elemType, null);
                 for (var i = 0; i < length; i++)
                 {
                     arr.SetValue(
-                        MapJValue(valType.GetElementType()!,
-                            MudInterface.array_get_at(Jvm.Instance.Env, javaVal.Object, i, arrElemType.Type)), i);
+                        MapJValue(elemType,
+                            MudInterface.array_get_at(Jvm.Env, javaVal.Object, i, arrElemType.Type)), i);
                 }
 
+                MudInterface.release_obj(Jvm.Env, javaVal.Object);
                 return arr;
             }
 
+            var hash = 0;
+            var preserveIdentity = Jvm.PreserveIdentity;
+            if (preserveIdentity && IdentityMap.TryGet(javaVal.Object, valType, out var mapped, out hash))
+            {
+                MudInterface.release_obj(Jvm.Env, javaVal.Object);
+                return mapped;
+            }
+
+            var objCls = Jvm.GetObjClass(javaVal.Object);
+
             var origValType = valType;
             // if it's an interface then we either need to 
             if (valType.IsInterface)
             {
-                var types = AppDomain.CurrentDomain.GetAssemblies()
-                    .SelectMany(s => s.GetTypes()).Select(t => (t, t.GetCustomAttributes<ClassPathAttribute>().FirstOrDefault())).Where(t => t.Item2 != null)!.ToList<(Type type, ClassPathAttribute Attr)>();
-                (valType, _) = types.Find(t =>
-                {
-                    return objCls.ClassPath == t.Attr.ClassPath;
-                });
+                valType = ClassPathRegistry.Find(objCls.ClassPath, valType)!;
             }
 
             // if there is not a class provided with the return class path then we will just return BoundObject if it's possible
@@ -232,9 +462,14 @@ internal static class TypeMap
 
             var jObjVal = Jvm.NewUnboundObj(valType);
             jObjVal.Info = objCls;
-            jObjVal.Env = Jvm.Instance.Env;
+            jObjVal.Env = Jvm.Env;
             jObjVal.Jobj = javaVal.Object;
-            Jvm.ObjPointers.Add(javaVal.Object);
+            Jvm.Hold(jObjVal);
+            // objects left as locals of a JvmScope end with it, so only promoted ones are mapped
+            if (preserveIdentity && jObjVal.Handle != 0)
+            {
+                IdentityMap.Add(jObjVal, hash);
+            }
             return jObjVal;
         }
 
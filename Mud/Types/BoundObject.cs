@@ -1,9 +1,11 @@
 using System.Dynamic;
 using System.Reflection;
 using System.Runtime.CompilerServices;
+using System.Runtime.InteropServices;
 using Mud.Exceptions;
 
 [assembly: InternalsVisibleTo("Mud")]
+[assembly: InternalsVisibleTo("Mud.Test")]
 namespace Mud.Types;
 
 [AttributeUsage(AttributeTargets.Interface, AllowMultiple = true)]
@@ -29,7 +31,7 @@ public class TypeSignatureAttribute : Attribute
 }
 
 
-[AttributeUsage(AttributeTargets.Method | AttributeTargets.Property)]
+[AttributeUsage(AttributeTargets.Method | AttributeTargets.Property | AttributeTargets.Field)]
 public class JavaNameAttribute : Attribute
 {
     public string Name { get; }
@@ -66,9 +68,10 @@ public class JavaStaticAttribute : JavaNameAttribute
 /// <summary>
 /// The base class used that is used to bind the .NET class to the Java class 
 /// </summary>
-internal class BoundObject : IBoundObject
+public class BoundObject : IBoundObject
 {
     private IntPtr _jobj = IntPtr.Zero;
+    private ulong _handle;
     private IntPtr _env;
     private ClassInfo _info;
     private bool _isStatic;
@@ -89,6 +92,12 @@ internal class BoundObject : IBoundObject
         set => _jobj = value;
     }
 
+    ulong IBoundObject.Handle
+    {
+        get => _handle;
+        set => _handle = value;
+    }
+
     bool IBoundObject.IsStatic
     {
         get => _isStatic;
@@ -134,7 +143,7 @@ internal class BoundObject : IBoundObject
     /// <returns></returns>
     public bool InstanceOf(string classPath)
     {
-        return MudInterface.instance_of(_env, _jobj, Jvm.GetClassInfo(classPath).Cls);
+        return MudInterface.instance_of(Jvm.Env, _jobj, Jvm.GetClassInfo(classPath).Cls);
     }
     
     /// <summary>
@@ -144,7 +153,7 @@ internal class BoundObject : IBoundObject
     /// <returns></returns>
     public bool InstanceOf(ClassInfo cls)
     {
-        return MudInterface.instance_of(_env, _jobj, cls.Cls);
+        return MudInterface.instance_of(Jvm.Env, _jobj, cls.Cls);
     }
     
     /// <summary>
@@ -154,7 +163,7 @@ internal class BoundObject : IBoundObject
     /// <returns></returns>
     internal bool InstanceOf(IntPtr cls)
     {
-        return MudInterface.instance_of(_env, _jobj, cls);
+        return MudInterface.instance_of(Jvm.Env, _jobj, cls);
     }
     
     /// <summary>
@@ -185,7 +194,7 @@ internal class BoundObject : IBoundObject
 #pragma warning restore CS8073
         Jvm.UsingArgs(args, jArgs =>
         {
-            _jobj = MudInterface.new_obj(Jvm.Instance.Env, _info.Cls, signature, jArgs);
+            _jobj = MudInterface.new_obj(Jvm.Env, _info.Cls, signature, jArgs);
         });
         // Console.WriteLine($"Bound: {_jobj.HexAddress()}");
     }
@@ -263,6 +272,69 @@ internal class BoundObject : IBoundObject
         }
         return _info.Call<T>(_jobj, method, returnType, args, false);
     }
+
+    /// <summary>
+    /// Calls the provided method on the backing java object without allocating,
+    /// arguments are limited to primitives and strings
+    /// </summary>
+    /// <param name="method">Method to be called</param>
+    /// <typeparam name="TRet">Return type of the method</typeparam>
+    public TRet Call<TRet>(string method) => FastCall.Call<TRet>(_info, InstanceFor(method), false, method);
+    public TRet Call<TRet, T1>(string method, T1 arg1) =>
+        FastCall.Call<TRet, T1>(_info, InstanceFor(method), false, method, arg1);
+    public TRet Call<TRet, T1, T2>(string method, T1 arg1, T2 arg2) =>
+        FastCall.Call<TRet, T1, T2>(_info, InstanceFor(method), false, method, arg1, arg2);
+    public TRet Call<TRet, T1, T2, T3>(string method, T1 arg1, T2 arg2, T3 arg3) =>
+        FastCall.Call<TRet, T1, T2, T3>(_info, InstanceFor(method), false, method, arg1, arg2, arg3);
+    public TRet Call<TRet, T1, T2, T3, T4>(string method, T1 arg1, T2 arg2, T3 arg3, T4 arg4) =>
+        FastCall.Call<TRet, T1, T2, T3, T4>(_info, InstanceFor(method), false, method, arg1, arg2, arg3, arg4);
+
+    /// <summary>
+    /// Calls the provided void method on the backing java object without allocating,
+    /// arguments are limited to primitives and strings
+    /// </summary>
+    /// <param name="method">Method to be called</param>
+    public void CallVoid(string method) => FastCall.Call<FastCall.Void>(_info, InstanceFor(method), false, method);
+    public void CallVoid<T1>(string method, T1 arg1) =>
+        FastCall.Call<FastCall.Void, T1>(_info, InstanceFor(method), false, method, arg1);
+    public void CallVoid<T1, T2>(string method, T1 arg1, T2 arg2) =>
+        FastCall.Call<FastCall.Void, T1, T2>(_info, InstanceFor(method), false, method, arg1, arg2);
+    public void CallVoid<T1, T2, T3>(string method, T1 arg1, T2 arg2, T3 arg3) =>
+        FastCall.Call<FastCall.Void, T1, T2, T3>(_info, InstanceFor(method), false, method, arg1, arg2, arg3);
+    public void CallVoid<T1, T2, T3, T4>(string method, T1 arg1, T2 arg2, T3 arg3, T4 arg4) =>
+        FastCall.Call<FastCall.Void, T1, T2, T3, T4>(_info, InstanceFor(method), false, method, arg1, arg2, arg3, arg4);
+
+    /// <summary>
+    /// Calls the provided method with args on the backing java object from one of the JVM worker threads.
+    /// The object and any bound objects in args must not be local to a JvmScope, promote them first as local refs are
+    /// only valid on the thread that created them
+    /// </summary>
+    /// <param name="method">Method to be called</param>
+    /// <param name="args">Arguments to be passed into the method</param>
+    public ValueTask CallAsync(string method, params object[] args) => CallAsync(method, args, CancellationToken.None);
+    public ValueTask CallAsync(string method, object[] args, CancellationToken cancellationToken) =>
+        Jvm.WorkerPool.Run(() => Call(method, args), cancellationToken);
+
+    /// <summary>
+    /// Calls the provided method with args on the backing java object from one of the JVM worker threads.
+    /// The object and any bound objects in args must not be local to a JvmScope, promote them first as local refs are
+    /// only valid on the thread that created them
+    /// </summary>
+    /// <param name="method">Method to be called</param>
+    /// <param name="args">Arguments to be passed into the method</param>
+    /// <typeparam name="T"></typeparam>
+    public ValueTask<T> CallAsync<T>(string method, params object[] args) => CallAsync<T>(method, args, CancellationToken.None);
+    public ValueTask<T> CallAsync<T>(string method, object[] args, CancellationToken cancellationToken) =>
+        Jvm.WorkerPool.Run(() => Call<T>(method, args), cancellationToken);
+
+    private IntPtr InstanceFor(string method)
+    {
+        if (_isStatic)
+        {
+            throw new InstanceMemberOnStaticException(method, _info);
+        }
+        return _jobj;
+    }
     
     
     /// <summary>
@@ -339,6 +411,83 @@ internal class BoundObject : IBoundObject
         _info.SetField(_jobj, field, new TypedArg(value!), false);
     }
 
+    /// <summary>
+    /// Reads all of the struct's fields from the backing java object in a single native call
+    /// </summary>
+    /// <typeparam name="T">Struct mirroring the java class' fields</typeparam>
+    public T GetFields<T>() where T : unmanaged => _info.GetFieldLayout<T>().Read(this);
+
+    /// <summary>
+    /// Writes all of the struct's fields into the backing java object in a single native call
+    /// </summary>
+    /// <param name="record">Values to be written</param>
+    /// <typeparam name="T">Struct mirroring the java class' fields</typeparam>
+    public void SetFields<T>(in T record) where T : unmanaged => _info.GetFieldLayout<T>().Write(this, record);
+
+    /// <summary>
+    /// Enumerates the backing java Iterable, Iterator or Stream, elements are pulled from java in chunks
+    /// </summary>
+    /// <param name="chunkSize">Number of elements pulled per native call</param>
+    /// <typeparam name="T">Element type, a primitive unboxes each element, otherwise string or a bound type</typeparam>
+    public IEnumerable<T> AsEnumerable<T>(int chunkSize = JavaEnumerable.DefaultChunkSize) =>
+        JavaEnumerable.Enumerate<T>(this, chunkSize);
+
+    /// <summary>
+    /// Enumerates the backing java Iterable, Iterator or Stream, chunks are pulled on the worker pool
+    /// with the next chunk being pulled while the current one is consumed. The object must not be local to a JvmScope,
+    /// promote it first as the worker can't use another thread's local refs
+    /// </summary>
+    /// <param name="chunkSize">Number of elements pulled per native call</param>
+    /// <typeparam name="T">Element type, a primitive unboxes each element, otherwise string or a bound type</typeparam>
+    public IAsyncEnumerable<T> AsAsyncEnumerable<T>(int chunkSize = JavaEnumerable.DefaultChunkSize) =>
+        JavaEnumerable.EnumerateAsync<T>(this, chunkSize, default);
+
+    /// <summary>
+    /// Gets the length of the backing java array
+    /// </summary>
+    public int ArrayLength => MudInterface.array_length(Jvm.Env, _jobj);
+
+    /// <summary>
+    /// Copies elements of the backing java primitive array into the provided buffer in a single native call
+    /// </summary>
+    /// <param name="dest">Buffer to copy into, its length is the amount of elements copied</param>
+    /// <param name="start">Index of the first java array element to copy</param>
+    /// <typeparam name="T">Element type, must share the memory layout of the java primitive</typeparam>
+    public void ReadArray<T>(Span<T> dest, int start = 0) where T : unmanaged
+    {
+        Jvm.ReadPrimitiveArray(_jobj, TypeMap.GetBlittablePrimitive(typeof(T)), start, dest.Length,
+            ref MemoryMarshal.GetReference(MemoryMarshal.AsBytes(dest)));
+    }
+
+    /// <summary>
+    /// Copies the provided values into the backing java primitive array in a single native call
+    /// </summary>
+    /// <param name="values">Values to copy</param>
+    /// <param name="start">Index of the first java array element to overwrite</param>
+    /// <typeparam name="T">Element type, must share the memory layout of the java primitive</typeparam>
+    public void WriteArray<T>(ReadOnlySpan<T> values, int start = 0) where T : unmanaged
+    {
+        Jvm.WritePrimitiveArray(_jobj, TypeMap.GetBlittablePrimitive(typeof(T)), start, values.Length,
+            ref MemoryMarshal.GetReference(MemoryMarshal.AsBytes(values)));
+    }
+
+    /// <summary>
+    /// Pins the elements of the backing java primitive array so they can be read and written in place
+    /// </summary>
+    /// <param name="critical">Pin via GetPrimitiveArrayCritical, avoids a copy but blocks any other JVM call on the thread until released</param>
+    /// <typeparam name="T">Element type, must share the memory layout of the java primitive</typeparam>
+    /// <returns>The pinned view, must be disposed to hand the elements back</returns>
+    /// <exception cref="ArrayPinException">Throws if the backing object is not an array of the matching primitive</exception>
+    public PinnedArray<T> Pin<T>(bool critical = false) where T : unmanaged
+    {
+        var type = TypeMap.GetBlittablePrimitive(typeof(T));
+        var arrCls = Jvm.GetClassInfo(new CustomType(new CustomType(type)).TypeSignature);
+        if (_jobj == IntPtr.Zero || !InstanceOf(arrCls))
+        {
+            throw new ArrayPinException($"Attempt to pin {ClassPath} as a {arrCls.ClassPath} array");
+        }
+        return new PinnedArray<T>(_jobj, ArrayLength, type, critical);
+    }
 
     public void Release()
     {
@@ -348,7 +497,16 @@ internal class BoundObject : IBoundObject
             return;
         }
 
-        Jvm.ReleaseObj(_jobj);
+        if (_handle != 0)
+        {
+            // stale handles are rejected by the table, so a double release can't free another object's ref
+            Jvm.ReleaseHandle(_handle);
+            _handle = 0;
+        }
+        else
+        {
+            Jvm.ReleaseObj(_jobj);
+        }
         _jobj = IntPtr.Zero;
     }
 
@@ -359,10 +517,4 @@ internal class BoundObject : IBoundObject
     {
         Release();
     }
-
-    
-    ~BoundObject()
-    {
-        Release();
-    }
 }
@@ -6,6 +6,10 @@ public interface IBoundObject : IDisposable
 {
 
     internal IntPtr Jobj { get; set; }
+    /// <summary>
+    /// Id of the native handle table entry holding Jobj as a global ref
+    /// </summary>
+    internal ulong Handle { get; set; }
     internal ClassInfo Info { get; set; }
     internal IntPtr Env { get; set; }
     internal bool IsStatic { get; set; }
@@ -94,6 +98,50 @@ public interface IBoundObject : IDisposable
     /// <param name="args">Arguments to be passed into the method</param>
     public T Call<T>(string method, CustomType returnType, TypedArg[] args);
 
+    /// <summary>
+    /// Calls the provided method with args on the backing java object from one of the JVM worker threads.
+    /// The object and any bound objects in args must not be local to a JvmScope, promote them first as local refs are
+    /// only valid on the thread that created them
+    /// </summary>
+    /// <param name="method">Method to be called</param>
+    /// <param name="args">Arguments to be passed into the method</param>
+    public ValueTask CallAsync(string method, params object[] args);
+    public ValueTask CallAsync(string method, object[] args, CancellationToken cancellationToken);
+
+    /// <summary>
+    /// Calls the provided method with args on the backing java object from one of the JVM worker threads.
+    /// The object and any bound objects in args must not be local to a JvmScope, promote them first as local refs are
+    /// only valid on the thread that created them
+    /// </summary>
+    /// <param name="method">Method to be called</param>
+    /// <param name="args">Arguments to be passed into the method</param>
+    /// <typeparam name="T"></typeparam>
+    public ValueTask<T> CallAsync<T>(string method, params object[] args);
+    public ValueTask<T> CallAsync<T>(string method, object[] args, CancellationToken cancellationToken);
+
+    /// <summary>
+    /// Calls the provided method on the backing java object without allocating,
+    /// arguments are limited to primitives and strings
+    /// </summary>
+    /// <param name="method">Method to be called</param>
+    /// <typeparam name="TRet">Return type of the method</typeparam>
+    public TRet Call<TRet>(string method);
+    public TRet Call<TRet, T1>(string method, T1 arg1);
+    public TRet Call<TRet, T1, T2>(string method, T1 arg1, T2 arg2);
+    public TRet Call<TRet, T1, T2, T3>(string method, T1 arg1, T2 arg2, T3 arg3);
+    public TRet Call<TRet, T1, T2, T3, T4>(string method, T1 arg1, T2 arg2, T3 arg3, T4 arg4);
+
+    /// <summary>
+    /// Calls the provided void method on the backing java object without allocating,
+    /// arguments are limited to primitives and strings
+    /// </summary>
+    /// <param name="method">Method to be called</param>
+    public void CallVoid(string method);
+    public void CallVoid<T1>(string method, T1 arg1);
+    public void CallVoid<T1, T2>(string method, T1 arg1, T2 arg2);
+    public void CallVoid<T1, T2, T3>(string method, T1 arg1, T2 arg2, T3 arg3);
+    public void CallVoid<T1, T2, T3, T4>(string method, T1 arg1, T2 arg2, T3 arg3, T4 arg4);
+
     /// <summary>
     /// Gets the provided field on the backing java object
     /// </summary>
@@ -134,6 +182,63 @@ public interface IBoundObject : IDisposable
     /// <typeparam name="T"></typeparam>
     public void SetField<T>(string field, T value);
 
+    /// <summary>
+    /// Reads all of the struct's fields from the backing java object in a single native call
+    /// </summary>
+    /// <typeparam name="T">Struct mirroring the java class' fields</typeparam>
+    public T GetFields<T>() where T : unmanaged;
+
+    /// <summary>
+    /// Writes all of the struct's fields into the backing java object in a single native call
+    /// </summary>
+    /// <param name="record">Values to be written</param>
+    /// <typeparam name="T">Struct mirroring the java class' fields</typeparam>
+    public void SetFields<T>(in T record) where T : unmanaged;
+
+    /// <summary>
+    /// Enumerates the backing java Iterable, Iterator or Stream, elements are pulled from java in chunks
+    /// </summary>
+    /// <param name="chunkSize">Number of elements pulled per native call</param>
+    /// <typeparam name="T">Element type, a primitive unboxes each element, otherwise string or a bound type</typeparam>
+    public IEnumerable<T> AsEnumerable<T>(int chunkSize = JavaEnumerable.DefaultChunkSize);
+
+    /// <summary>
+    /// Enumerates the backing java Iterable, Iterator or Stream, chunks are pulled on the worker pool
+    /// with the next chunk being pulled while the current one is consumed. The object must not be local to a JvmScope,
+    /// promote it first as the worker can't use another thread's local refs
+    /// </summary>
+    /// <param name="chunkSize">Number of elements pulled per native call</param>
+    /// <typeparam name="T">Element type, a primitive unboxes each element, otherwise string or a bound type</typeparam>
+    public IAsyncEnumerable<T> AsAsyncEnumerable<T>(int chunkSize = JavaEnumerable.DefaultChunkSize);
+
+    /// <summary>
+    /// Gets the length of the backing java array
+    /// </summary>
+    public int ArrayLength { get; }
+
+    /// <summary>
+    /// Copies elements of the backing java primitive array into the provided buffer in a single native call
+    /// </summary>
+    /// <param name="dest">Buffer to copy into, its length is the amount of elements copied</param>
+    /// <param name="start">Index of the first java array element to copy</param>
+    /// <typeparam name="T">Element type, must share the memory layout of the java primitive</typeparam>
+    public void ReadArray<T>(Span<T> dest, int start = 0) where T : unmanaged;
+
+    /// <summary>
+    /// Copies the provided values into the backing java primitive array in a single native call
+    /// </summary>
+    /// <param name="values">Values to copy</param>
+    /// <param name="start">Index of the first java array element to overwrite</param>
+    /// <typeparam name="T">Element type, must share the memory layout of the java primitive</typeparam>
+    public void WriteArray<T>(ReadOnlySpan<T> values, int start = 0) where T : unmanaged;
+
+    /// <summary>
+    /// Pins the elements of the backing java primitive array so they can be read and written in place
+    /// </summary>
+    /// <param name="critical">Pin via GetPrimitiveArrayCritical, avoids a copy but blocks any other JVM call on the thread until released</param>
+    /// <typeparam name="T">Element type, must share the memory layout of the java primitive</typeparam>
+    /// <returns>The pinned view, must be disposed to hand the elements back</returns>
+    public PinnedArray<T> Pin<T>(bool critical = false) where T : unmanaged;
 
     public void Release();
 
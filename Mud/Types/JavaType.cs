@@ -16,6 +16,25 @@ public enum JavaType : int
     Void
 }
 
+/// <summary>
+/// How pinned array elements are handed back to the JVM, matches the JNI release modes
+/// </summary>
+public enum JavaReleaseMode : int
+{
+    /// <summary>
+    /// Copy back the changes and release the elements
+    /// </summary>
+    CopyBack = 0,
+    /// <summary>
+    /// Copy back the changes but keep the elements pinned
+    /// </summary>
+    Commit,
+    /// <summary>
+    /// Release the elements discarding any changes made to a copy
+    /// </summary>
+    Abort
+}
+
 
 public record TypedArg(object? Val, CustomType Type)
 {
@@ -44,27 +63,31 @@ public class CustomType
     /// </summary>
     internal JavaType Type { get; } = JavaType.Object;
 
+    private string? _typeSignature;
 
-    public string TypeSignature
+    /// <summary>
+    /// The java type signature, computed once as the type is immutable
+    /// </summary>
+    public string TypeSignature => _typeSignature ??= GenTypeSignature();
+
+    private string GenTypeSignature()
     {
-        get
+        if (ArrayOf != null) return $"[{ArrayOf.TypeSignature}";
+        // array class paths (e.g. "[D") are already in signature form
+        if (ClassPath != null) return ClassPath.StartsWith('[') ? ClassPath : $"L{ClassPath};";
+        return Type switch
         {
-            if (ArrayOf != null) return $"[{ArrayOf.TypeSignature}";
-            if (ClassPath != null) return $"L{ClassPath};";
-            return Type switch
-            {
-                JavaType.Int => "I",
-                JavaType.Bool => "Z",
-                JavaType.Byte => "B",
-                JavaType.Char => "C",
-                JavaType.Short => "S",
-                JavaType.Long => "J",
-                JavaType.Float => "F",
-                JavaType.Double => "D",
-                JavaType.Void => "V",
-                _ => ""
-            };
-        }
+            JavaType.Int => "I",
+            JavaType.Bool => "Z",
+            JavaType.Byte => "B",
+            JavaType.Char => "C",
+            JavaType.Short => "S",
+            JavaType.Long => "J",
+            JavaType.Float => "F",
+            JavaType.Double => "D",
+            JavaType.Void => "V",
+            _ => ""
+        };
     }
 
     public CustomType(CustomType arrayOf)
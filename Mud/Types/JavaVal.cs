@@ -16,6 +16,49 @@ public struct JavaCallResp
 }
 
 
+/// <summary>
+/// Matches the mud clib handle table entry, a global ref along with the id used to release it
+/// </summary>
+internal struct JavaHandle
+{
+    public ulong Id;
+    public IntPtr Obj;
+}
+
+
+/// <summary>
+/// Matches the mud clib batch call entry, args start at ArgOffset within the batch's shared JavaVal buffer
+/// </summary>
+internal struct JavaBatchCall
+{
+    public IntPtr ObjOrCls;
+    public IntPtr Method;
+    public JavaType Type;
+    public byte IsStatic;
+    public uint ArgOffset;
+}
+
+/// <summary>
+/// Matches the mud clib iterator chunk result
+/// </summary>
+internal struct JavaChunk
+{
+    public nuint Count;
+    public byte Done;
+    public IntPtr Exception;
+}
+
+/// <summary>
+/// Matches the mud clib field layout entry, the field's value lives Offset bytes into each record
+/// </summary>
+internal struct JavaFieldLayout
+{
+    public IntPtr Field;
+    public JavaType Type;
+    public uint Offset;
+}
+
+
 /// <summary>
 /// Mathes the layout and size of the JNI's jvalue union
 /// </summary>
@@ -0,0 +1,123 @@
+using Mud.Exceptions;
+
+namespace Mud.Types;
+
+/// <summary>
+/// In place view over the elements of a java primitive array.
+/// Must be disposed on the thread that pinned it, which copies back any changes and hands the elements back to the JVM
+/// </summary>
+/// <typeparam name="T">Element type, must share the memory layout of the java primitive</typeparam>
+public sealed unsafe class PinnedArray<T> : IDisposable where T : unmanaged
+{
+    private readonly IntPtr _arr;
+    private readonly JavaType _type;
+    private readonly int _threadId;
+    private IntPtr _elems;
+
+    /// <summary>
+    /// Amount of elements in the array
+    /// </summary>
+    public int Length { get; }
+    
+    /// <summary>
+    /// Whether the elements were pinned via GetPrimitiveArrayCritical, no other JVM calls can be made on the thread until released
+    /// </summary>
+    public bool IsCritical { get; }
+    
+    /// <summary>
+    /// Whether the JVM handed out a copy of the elements rather than the backing memory
+    /// </summary>
+    public bool IsCopy { get; }
+
+    /// <summary>
+    /// Whether the elements have been handed back to the JVM
+    /// </summary>
+    public bool IsReleased => _elems == IntPtr.Zero;
+
+    /// <summary>
+    /// The pinned elements
+    /// </summary>
+    /// <exception cref="ObjectDisposedException">Throws if the elements have already been released</exception>
+    public Span<T> Span
+    {
+        get
+        {
+            if (IsReleased)
+            {
+                throw new ObjectDisposedException(nameof(PinnedArray<T>), "The pinned array elements have already been released");
+            }
+            return new Span<T>((void*)_elems, Length);
+        }
+    }
+
+    internal PinnedArray(IntPtr arr, int length, JavaType type, bool critical)
+    {
+        _arr = arr;
+        _type = type;
+        _threadId = Environment.CurrentManagedThreadId;
+        Length = length;
+        IsCritical = critical;
+
+        _elems = MudInterface.array_pin(Jvm.Env, arr, type, critical, out var isCopy);
+        if (_elems == IntPtr.Zero)
+        {
+            throw new ArrayPinException("The JVM was unable to pin the array elements");
+        }
+        IsCopy = isCopy;
+        if (critical)
+        {
+            Jvm.CriticalPins++;
+        }
+    }
+
+    /// <summary>
+    /// Copies back any changes while keeping the elements pinned
+    /// </summary>
+    public void Commit() => Release(JavaReleaseMode.Commit);
+
+    /// <summary>
+    /// Releases the elements discarding any changes made to a copy
+    /// </summary>
+    public void Abort() => Release(JavaReleaseMode.Abort);
+
+    /// <summary>
+    /// Hands the elements back to the JVM
+    /// </summary>
+    /// <param name="mode">How the elements are handed back</param>
+    /// <exception cref="ObjectDisposedException">Throws if the elements have already been released</exception>
+    /// <exception cref="ArrayPinException">Throws if released from a thread other than the one that pinned the elements</exception>
+    public void Release(JavaReleaseMode mode)
+    {
+        if (IsReleased)
+        {
+            throw new ObjectDisposedException(nameof(PinnedArray<T>), "The pinned array elements have already been released");
+        }
+        if (_threadId != Environment.CurrentManagedThreadId)
+        {
+            throw new ArrayPinException("Pinned array elements must be released on the thread that pinned them");
+        }
+        
+        MudInterface.array_unpin(Jvm.Env, _arr, _elems, _type, IsCritical, mode);
+        if (mode is JavaReleaseMode.Commit)
+        {
+            return;
+        }
+        
+        _elems = IntPtr.Zero;
+        if (IsCritical)
+        {
+            Jvm.CriticalPins--;
+        }
+    }
+
+    /// <summary>
+    /// Copies back any changes and hands the elements back to the JVM
+    /// </summary>
+    public void Dispose()
+    {
+        if (!IsReleased)
+        {
+            Release(JavaReleaseMode.CopyBack);
+        }
+    }
+}